@@ -0,0 +1,75 @@
+#include "bench/allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  std::atomic<bool> counting{false};
+  std::atomic<std::size_t> allocations{0};
+
+  void *allocate(std::size_t size)
+  {
+    if (counting.load(std::memory_order_relaxed))
+      allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+      return memory;
+    throw std::bad_alloc();
+  }
+} // namespace
+
+void *operator new(std::size_t size)
+{
+  return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+  return allocate(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+namespace bench
+{
+  AllocationCounter::AllocationCounter()
+  {
+    allocations = 0;
+    counting = true;
+  }
+
+  AllocationCounter::~AllocationCounter()
+  {
+    counting = false;
+  }
+
+  std::size_t AllocationCounter::Count() const
+  {
+    return allocations.load(std::memory_order_relaxed);
+  }
+
+  void AllocationCounter::Report(benchmark::State &state, std::size_t items) const
+  {
+    state.counters["allocs/event"] = items > 0 ? static_cast<double>(Count()) / static_cast<double>(items) : 0.0;
+  }
+
+} // namespace bench
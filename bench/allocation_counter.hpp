@@ -0,0 +1,28 @@
+#ifndef BENCH_ALLOCATIONCOUNTER_HPP
+#define BENCH_ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+namespace bench
+{
+	// Counts the operator new calls of the whole binary while it is alive,
+	// from every thread. Only one may be alive at a time.
+	class AllocationCounter
+	{
+	public:
+		AllocationCounter();
+		~AllocationCounter();
+
+		AllocationCounter(const AllocationCounter &) = delete;
+		AllocationCounter &operator=(const AllocationCounter &) = delete;
+
+		std::size_t Count() const;
+		// reports the allocations per processed item as the "allocs/event" counter
+		void Report(benchmark::State &state, std::size_t items) const;
+	};
+
+} // namespace bench
+
+#endif // BENCH_ALLOCATIONCOUNTER_HPP
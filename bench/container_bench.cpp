@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench/allocation_counter.hpp"
+#include "src/application/db/events_container.hpp"
+#include "src/application/mvc/view.hpp"
+
+namespace
+{
+  // a view that only looks at what it is told, like the list following the tail
+  class TailView : public mvc::View
+  {
+  public:
+    explicit TailView(db::EventsContainer &events) : m_events(events) {}
+
+    void OnDataUpdated() override {}
+    void OnCurrentIndexUpdated(const int) override {}
+    void OnDataAppended(const std::size_t, const std::size_t last) override
+    {
+      benchmark::DoNotOptimize(m_events.GetEvent(static_cast<int>(last - 1)).getId());
+    }
+
+  private:
+    db::EventsContainer &m_events;
+  };
+
+  // AddEvent notifies every registered view of each single event
+  void BM_ContainerAddEvent(benchmark::State &state)
+  {
+    const int batch = 1000;
+    // the container is cleared this often to keep the memory bounded
+    const int batchesPerClear = 1000;
+    db::EventsContainer events;
+    std::vector<std::unique_ptr<TailView>> views;
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+      views.push_back(std::make_unique<TailView>(events));
+      events.RegisterOndDataUpdated(views.back().get());
+    }
+
+    std::vector<db::Event> pending;
+    pending.reserve(batch);
+    std::size_t added = 0;
+    std::size_t allocationCount = 0;
+    int batches = 0;
+    for (auto _ : state)
+    {
+      state.PauseTiming();
+      if (++batches % batchesPerClear == 0)
+        events.Clear();
+      pending.clear();
+      for (int i = 0; i < batch; ++i)
+        pending.push_back(db::Event(i, {{"timestamp", "2024-01-01 10:00:00"}, {"type", "INFO"}, {"info", "event " + std::to_string(i)}}));
+      state.ResumeTiming();
+
+      const bench::AllocationCounter allocations;
+      for (auto &event : pending)
+        events.AddEvent(std::move(event));
+      allocationCount += allocations.Count();
+      added += batch;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(added));
+    state.counters["allocs/event"] = static_cast<double>(allocationCount) / static_cast<double>(added);
+  }
+  BENCHMARK(BM_ContainerAddEvent)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+} // namespace
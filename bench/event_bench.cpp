@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "bench/allocation_counter.hpp"
+#include "src/application/db/event_store.hpp"
+#include "src/application/search/column_order.hpp"
+#include "src/application/search/event_histogram.hpp"
+#include "src/application/search/matcher.hpp"
+
+namespace
+{
+  db::Event::EventItems makeItems(int i)
+  {
+    return {{"timestamp", "2024-01-01 10:00:00." + std::to_string(i % 1000)},
+            {"type", i % 10 ? "INFO" : "ERROR"},
+            {"info", "request " + std::to_string(i) + " served in " + std::to_string(i % 97) + " ms"},
+            {"dummy", "dummy"}};
+  }
+
+  void fill(db::EventStore &store, int count)
+  {
+    for (int i = 0; i < count; ++i)
+      store.push_back(db::Event(i, makeItems(i)));
+  }
+
+  void BM_EventConstruction(benchmark::State &state)
+  {
+    // the values are made up front, what is measured is packing them into the event
+    std::vector<db::Event::EventItems> items;
+    for (int i = 0; i < 1000; ++i)
+      items.push_back(makeItems(i));
+
+    int i = 0;
+    const bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+      db::Event event(i, items[i % items.size()]);
+      benchmark::DoNotOptimize(event);
+      ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+    allocations.Report(state, state.iterations());
+  }
+  BENCHMARK(BM_EventConstruction);
+
+  void BM_EventFindByKey(benchmark::State &state)
+  {
+    db::Event event(1, makeItems(1));
+    const std::string key = "info";
+    for (auto _ : state)
+      benchmark::DoNotOptimize(event.findByKey(key));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_EventFindByKey);
+
+  // the store the views read from, by name and by a field id resolved up front
+  void BM_StoreFindByKey(benchmark::State &state)
+  {
+    const int count = 100000;
+    db::EventStore store;
+    fill(store, count);
+    const auto field = *store.GetFields().Find("info");
+    const bool byName = state.range(0) == 0;
+    std::size_t row = 0;
+    const bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+      const auto event = store.at(row);
+      benchmark::DoNotOptimize(byName ? event.findByKey("info") : event.findByKey(field));
+      row = row + 1 == count ? 0 : row + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    allocations.Report(state, state.iterations());
+    state.SetLabel(byName ? "by name" : "by field id");
+  }
+  BENCHMARK(BM_StoreFindByKey)->Arg(0)->Arg(1);
+
+  void BM_EventFindInEvent(benchmark::State &state)
+  {
+    db::Event event(1, makeItems(1));
+    const search::Matcher matcher("served in 1 ms");
+    for (auto _ : state)
+      benchmark::DoNotOptimize(event.findInEvent(matcher));
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_EventFindInEvent);
+
+  // a full scan of the store as ContainerSearch does it, mostly misses
+  void BM_StoreFindInEvent(benchmark::State &state)
+  {
+    const int count = 100000;
+    db::EventStore store;
+    fill(store, count);
+    const search::Matcher matcher("served in 1 ms");
+    const bench::AllocationCounter allocations;
+    for (auto _ : state)
+    {
+      std::size_t hits = 0;
+      for (std::size_t row = 0; row < store.size(); ++row)
+        hits += store.at(row).findInEvent(matcher).has_value();
+      benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    allocations.Report(state, state.iterations() * count);
+  }
+  BENCHMARK(BM_StoreFindInEvent)->Unit(benchmark::kMillisecond);
+
+  // a click on a column header, by a shared short value and by a distinct long one
+  void BM_ColumnOrder(benchmark::State &state)
+  {
+    const int count = 1000000;
+    db::EventStore store;
+    fill(store, count);
+    const bool byType = state.range(0) == 0;
+    search::ColumnOrder order(store, *store.GetFields().Find(byType ? "type" : "info"));
+    for (auto _ : state)
+    {
+      order.Assign();
+      benchmark::DoNotOptimize(order.GetRows().data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetLabel(byType ? "type" : "info");
+  }
+  BENCHMARK(BM_ColumnOrder)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+  // what the overview panel does with the events of a load
+  void BM_EventHistogram(benchmark::State &state)
+  {
+    const int count = 1000000;
+    db::EventStore store;
+    fill(store, count);
+    search::EventHistogram histogram(store);
+    for (auto _ : state)
+    {
+      histogram.Rebuild();
+      benchmark::DoNotOptimize(histogram.GetMaxBucketCount());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+  }
+  BENCHMARK(BM_EventHistogram)->Unit(benchmark::kMillisecond);
+} // namespace
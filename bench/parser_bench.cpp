@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "bench/allocation_counter.hpp"
+#include "src/application/db/events_container.hpp"
+#include "src/application/parser/parallel_xml_parser.hpp"
+
+namespace
+{
+  // Writes a log of about `megabytes` MB to the temp directory the first
+  // time it is asked for, later runs reuse it.
+  std::filesystem::path fixture(int64_t megabytes)
+  {
+    const auto path = std::filesystem::temp_directory_path() / ("LogViewer_bench_" + std::to_string(megabytes) + "MB.xml");
+    const auto size = static_cast<std::uintmax_t>(megabytes) << 20;
+    std::error_code error;
+    const auto existing = std::filesystem::file_size(path, error);
+    if (!error && existing >= size)
+      return path;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "<?xml version=\"1.0\"?>\n<events>\n";
+    std::string event;
+    std::uintmax_t written = 0;
+    for (int i = 0; written < size; ++i)
+    {
+      event = "<event id=\"" + std::to_string(i) + "\"><timestamp>2024-01-01 10:" + std::to_string(10 + i / 60000 % 50) + ":" +
+              std::to_string(10 + i / 1000 % 50) + "." + std::to_string(100 + i % 900) + "</timestamp><type>" +
+              (i % 10 ? "INFO" : "ERROR") + "</type><info>request " + std::to_string(i) + " served in " +
+              std::to_string(i % 97) + " ms</info>" + (i % 10 ? "" : "<dummy>dummy</dummy>") + "</event>\n";
+      out << event;
+      written += event.size();
+    }
+    out << "</events>\n";
+    return path;
+  }
+
+  class CountingObserver : public parser::DataParserObserver
+  {
+  public:
+    void ProgressUpdated() const override {}
+    void NewEventFound(db::Event &&event) override
+    {
+      events.AddEvent(std::move(event));
+    }
+
+    db::EventsContainer events;
+  };
+
+  // parsing into the store as the viewer does it, without the GUI
+  void BM_ParseXmlLog(benchmark::State &state)
+  {
+    const auto path = fixture(state.range(0));
+    const auto bytes = std::filesystem::file_size(path);
+    std::size_t parsed = 0;
+    std::size_t allocationCount = 0;
+    for (auto _ : state)
+    {
+      CountingObserver observer;
+      parser::ParallelXmlParser xmlParser;
+      xmlParser.RegisterObserver(&observer);
+      {
+        const bench::AllocationCounter allocations;
+        xmlParser.ParseData(path);
+        allocationCount += allocations.Count();
+      }
+      parsed += observer.events.Size();
+      state.PauseTiming();
+      observer.events.Clear();
+      state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(parsed));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+    state.counters["allocs/event"] = parsed > 0 ? static_cast<double>(allocationCount) / static_cast<double>(parsed) : 0.0;
+  }
+  // the 1 GB run takes a while and as much disk, filter it out with
+  // --benchmark_filter='BM_ParseXmlLog/100' when that is too much
+  BENCHMARK(BM_ParseXmlLog)->Arg(100)->Arg(1024)->Unit(benchmark::kMillisecond)->Iterations(1);
+} // namespace
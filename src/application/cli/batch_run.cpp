@@ -0,0 +1,145 @@
+#include "cli/batch_run.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "parser/compressed_log_parser.hpp"
+#include "parser/merge_worker.hpp"
+#include "parser/parallel_xml_parser.hpp"
+#include "parser/parser_worker.hpp"
+#include "search/filter_view.hpp"
+
+namespace cli
+{
+  BatchRun::BatchRun(Options options, EventWriter &writer, util::ThreadPool &pool)
+      : m_options(std::move(options)), m_writer(writer), m_pool(pool)
+  {
+  }
+
+  BatchRun::Stats BatchRun::Run(const std::vector<std::filesystem::path> &files)
+  {
+    auto makeParser = [this]
+    {
+      return std::make_unique<parser::CompressedLogParser>(
+          std::make_unique<parser::ParallelXmlParser>(m_options.eventElement, 16 << 20, m_pool), m_pool);
+    };
+
+    std::unique_ptr<parser::BatchProducer> worker;
+    if (files.size() == 1)
+    {
+      auto single = std::make_unique<parser::ParserWorker>(makeParser(), m_stopRequested);
+      single->Start(files.front());
+      worker = std::move(single);
+    }
+    else
+    {
+      std::vector<std::unique_ptr<parser::DataParser>> parsers;
+      for (std::size_t i = 0; i < files.size(); ++i)
+        parsers.push_back(makeParser());
+      auto merge = std::make_unique<parser::MergeWorker>(std::move(parsers), m_stopRequested);
+      merge->Start(files);
+      worker = std::move(merge);
+    }
+
+    Stats stats;
+    const auto writtenBefore = m_writer.GetWritten();
+    db::EventStore block;
+    search::FilterView filter(block, m_pool);
+    filter.Apply(m_options.filter);
+
+    auto flush = [&]
+    {
+      if (block.size() == 0)
+        return;
+      filter.Reapply();
+      std::vector<uint32_t> rows;
+      if (filter.IsActive())
+        rows = filter.GetRows();
+      else
+      {
+        rows.resize(block.size());
+        std::iota(rows.begin(), rows.end(), 0);
+      }
+      writeBlock(block, std::move(rows));
+      block.clear();
+    };
+
+    parser::BatchProducer::Batch batch;
+    try
+    {
+      while (true)
+      {
+        if (worker->TryPopBatch(batch))
+        {
+          for (const auto &event : batch)
+            block.push_back(event);
+          stats.parsed += batch.size();
+          if (block.size() >= m_options.blockRows)
+            flush();
+          continue;
+        }
+        if (worker->IsFinished())
+          break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      flush();
+    }
+    catch (...)
+    {
+      // the parser waits for room in its queue otherwise
+      m_stopRequested = true;
+      throw;
+    }
+    worker->Join();
+
+    stats.written = m_writer.GetWritten() - writtenBefore;
+    if (!worker->GetError().empty())
+      throw std::runtime_error(worker->GetError());
+    return stats;
+  }
+
+  void BatchRun::Stop()
+  {
+    m_stopRequested = true;
+  }
+
+  void BatchRun::writeBlock(const db::EventStore &block, std::vector<uint32_t> rows)
+  {
+    if (m_options.query)
+    {
+      const auto &query = *m_options.query;
+      std::vector<std::future<std::vector<uint32_t>>> parts;
+      for (std::size_t first = 0; first < rows.size(); first += kPartitionRows)
+      {
+        auto part = std::span<const uint32_t>(rows).subspan(first, std::min(kPartitionRows, rows.size() - first));
+        parts.push_back(m_pool.Submit([&block, &query, part]
+                                      {
+                                        std::vector<uint32_t> matched;
+                                        for (auto row : part)
+                                        {
+                                          if (block.at(row).findInEvent(query))
+                                            matched.push_back(row);
+                                        }
+                                        return matched; }));
+      }
+      for (auto &part : parts)
+        part.wait();
+
+      std::vector<uint32_t> matched;
+      for (auto &part : parts)
+      {
+        auto rowsOfPart = part.get();
+        matched.insert(matched.end(), rowsOfPart.begin(), rowsOfPart.end());
+      }
+      rows = std::move(matched);
+    }
+    m_writer.Write(block, rows);
+  }
+
+} // namespace cli
@@ -0,0 +1,65 @@
+#ifndef CLI_BATCHRUN_HPP
+#define CLI_BATCHRUN_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cli/event_writer.hpp"
+#include "search/event_filter.hpp"
+#include "search/matcher.hpp"
+#include "util/thread_pool.hpp"
+
+namespace cli
+{
+	// Streams logs through the parser, a filter and a query into an
+	// EventWriter without a GUI. Events are taken over from the parser in
+	// blocks of a fixed number of rows; a block is filtered and matched on
+	// the thread pool and written before the next one is filled, so the
+	// memory held does not grow with the logs, while the parser goes on with
+	// the following batches. Several logs are merged by time.
+	class BatchRun
+	{
+	public:
+		struct Options
+		{
+			search::EventFilter filter;
+			// matched against every value of an event, null passes every event
+			std::shared_ptr<const search::Matcher> query;
+			std::string eventElement{"event"};
+			std::size_t blockRows{65536};
+		};
+
+		struct Stats
+		{
+			std::size_t parsed{0};
+			std::size_t written{0};
+		};
+
+		BatchRun(Options options, EventWriter &writer, util::ThreadPool &pool = util::ThreadPool::Shared());
+
+		// Parses the files to the end or until Stop and returns what was
+		// parsed and written. Throws std::runtime_error with the errors of
+		// the logs that failed, after writing the events of the others.
+		Stats Run(const std::vector<std::filesystem::path> &files);
+		// ends a run early, from any thread
+		void Stop();
+
+	private:
+		void writeBlock(const db::EventStore &block, std::vector<uint32_t> rows);
+
+	private:
+		static constexpr std::size_t kPartitionRows = 16384;
+
+		const Options m_options;
+		EventWriter &m_writer;
+		util::ThreadPool &m_pool;
+		std::atomic<bool> m_stopRequested{false};
+	};
+
+} // namespace cli
+
+#endif // CLI_BATCHRUN_HPP
@@ -0,0 +1,215 @@
+#include "cli/event_writer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "db/event_cache.hpp"
+
+namespace cli
+{
+  namespace
+  {
+    void appendCsv(std::string &text, std::string_view value)
+    {
+      if (value.find_first_of(",\"\r\n") == std::string_view::npos)
+      {
+        text += value;
+        return;
+      }
+      text += '"';
+      for (char c : value)
+      {
+        if (c == '"')
+          text += '"';
+        text += c;
+      }
+      text += '"';
+    }
+
+    void appendJson(std::string &text, std::string_view value)
+    {
+      text += '"';
+      for (char c : value)
+      {
+        switch (c)
+        {
+        case '"':
+          text += "\\\"";
+          break;
+        case '\\':
+          text += "\\\\";
+          break;
+        case '\n':
+          text += "\\n";
+          break;
+        case '\r':
+          text += "\\r";
+          break;
+        case '\t':
+          text += "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20)
+          {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            text += escaped;
+          }
+          else
+            text += c;
+        }
+      }
+      text += '"';
+    }
+  } // namespace
+
+  EventWriter::Format EventWriter::ParseFormat(std::string_view name)
+  {
+    if (name == "csv")
+      return Format::Csv;
+    if (name == "jsonl")
+      return Format::JsonLines;
+    if (name == "cache")
+      return Format::Cache;
+    throw std::invalid_argument("unknown output format: " + std::string(name));
+  }
+
+  EventWriter::EventWriter(std::ostream &out, Format format, std::vector<std::string> columns, util::ThreadPool &pool)
+      : m_out(out), m_format(format), m_columns(std::move(columns)), m_pool(pool)
+  {
+  }
+
+  void EventWriter::SetCacheLog(std::filesystem::path log)
+  {
+    m_cacheLog = std::move(log);
+  }
+
+  void EventWriter::Write(const db::EventStore &store, std::span<const uint32_t> rows)
+  {
+    if (m_format == Format::Cache)
+    {
+      for (auto row : rows)
+      {
+        db::Event event(store.at(row).getId());
+        for (const auto &[key, value] : store.at(row).getEventItems())
+          event.addItem(key, value);
+        event.setSource(store.GetSource(row));
+        m_collected.push_back(event);
+      }
+      m_written += rows.size();
+      return;
+    }
+
+    if (!m_started)
+    {
+      if (m_format == Format::Csv && m_columns.empty())
+      {
+        for (std::size_t field = 0; field < store.GetFields().Size(); ++field)
+          m_columns.emplace_back(store.GetFields().Name(static_cast<db::FieldId>(field)));
+      }
+      writeHeader();
+      m_started = true;
+    }
+
+    std::vector<std::future<std::string>> parts;
+    for (std::size_t first = 0; first < rows.size(); first += kPartitionRows)
+    {
+      auto part = rows.subspan(first, std::min(kPartitionRows, rows.size() - first));
+      parts.push_back(m_pool.Submit([this, &store, part]
+                                    { return format(store, part); }));
+    }
+    // every part is waited for, the tasks read the store
+    for (auto &part : parts)
+      part.wait();
+    for (auto &part : parts)
+    {
+      const auto text = part.get();
+      m_out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+    m_written += rows.size();
+  }
+
+  void EventWriter::Finish()
+  {
+    if (m_format == Format::Cache)
+    {
+      if (m_cacheLog.empty())
+        throw std::logic_error("the cache format needs the log it is keyed to");
+      db::EventCache::Write(m_collected, m_cacheLog, m_out);
+    }
+    else if (!m_started)
+      writeHeader();
+    m_started = true;
+    m_out.flush();
+    if (!m_out)
+      throw std::runtime_error("writing the output failed");
+  }
+
+  std::size_t EventWriter::GetWritten() const
+  {
+    return m_written;
+  }
+
+  const std::vector<std::string> &EventWriter::GetColumns() const
+  {
+    return m_columns;
+  }
+
+  void EventWriter::writeHeader()
+  {
+    if (m_format != Format::Csv)
+      return;
+    std::string header = "id";
+    for (const auto &column : m_columns)
+    {
+      header += ',';
+      appendCsv(header, column);
+    }
+    header += '\n';
+    m_out << header;
+  }
+
+  std::string EventWriter::format(const db::EventStore &store, std::span<const uint32_t> rows) const
+  {
+    std::string text;
+    if (m_format == Format::Csv)
+    {
+      std::vector<std::optional<db::FieldId>> fields;
+      for (const auto &column : m_columns)
+        fields.push_back(store.GetFields().Find(column));
+
+      for (auto row : rows)
+      {
+        text += std::to_string(store.at(row).getId());
+        for (const auto &field : fields)
+        {
+          text += ',';
+          if (field)
+            appendCsv(text, store.GetValue(row, *field));
+        }
+        text += '\n';
+      }
+      return text;
+    }
+
+    for (auto row : rows)
+    {
+      const auto event = store.at(row);
+      text += "{\"id\":" + std::to_string(event.getId());
+      for (const auto &[key, value] : event.getEventItems())
+      {
+        text += ',';
+        appendJson(text, key);
+        text += ':';
+        appendJson(text, value);
+      }
+      text += "}\n";
+    }
+    return text;
+  }
+
+} // namespace cli
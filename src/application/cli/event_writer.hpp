@@ -0,0 +1,80 @@
+#ifndef CLI_EVENTWRITER_HPP
+#define CLI_EVENTWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "db/event_store.hpp"
+#include "util/thread_pool.hpp"
+
+namespace cli
+{
+	// Writes rows of event stores to a stream in one of the export formats.
+	// CSV has an id column and a column per field: the fields given or, if
+	// none are, those the first store written from knows. JSON lines hold an
+	// object per event with its id and its fields in order, a repeated field
+	// repeats its key. The rows are formatted in partitions on the thread pool and
+	// written in order. The cache format is the sidecar db::EventCache opens
+	// a log from, keyed to that log and holding every event of it. The image
+	// needs all the rows at once: they are collected in memory and the
+	// sidecar is written by Finish.
+	class EventWriter
+	{
+	public:
+		enum class Format
+		{
+			Csv,
+			JsonLines,
+			Cache
+		};
+
+		// "csv", "jsonl" or "cache", throws std::invalid_argument for others
+		static Format ParseFormat(std::string_view name);
+
+		EventWriter(std::ostream &out, Format format, std::vector<std::string> columns = {},
+					util::ThreadPool &pool = util::ThreadPool::Shared());
+
+		EventWriter(const EventWriter &) = delete;
+		EventWriter &operator=(const EventWriter &) = delete;
+
+		// the log the cache format is keyed to, read again by Finish
+		void SetCacheLog(std::filesystem::path log);
+
+		// writes the rows of the store in the order given
+		void Write(const db::EventStore &store, std::span<const uint32_t> rows);
+		// writes what is still held back and flushes the stream, throws
+		// std::runtime_error if the stream failed; std::logic_error for the
+		// cache format without a log
+		void Finish();
+
+		// rows written so far
+		std::size_t GetWritten() const;
+		const std::vector<std::string> &GetColumns() const;
+
+	private:
+		void writeHeader();
+		std::string format(const db::EventStore &store, std::span<const uint32_t> rows) const;
+
+	private:
+		static constexpr std::size_t kPartitionRows = 16384;
+
+		std::ostream &m_out;
+		const Format m_format;
+		std::vector<std::string> m_columns;
+		util::ThreadPool &m_pool;
+		bool m_started{false};
+		std::size_t m_written{0};
+		// the rows of the cache format until Finish
+		db::EventStore m_collected;
+		std::filesystem::path m_cacheLog;
+	};
+
+} // namespace cli
+
+#endif // CLI_EVENTWRITER_HPP
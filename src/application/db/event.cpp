@@ -1,12 +1,106 @@
 #include "db/event.hpp"
-#include <regex>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "search/matcher.hpp"
 
 namespace db
 {
+  Event::Item Event::Items::Iterator::operator*() const
+  {
+    ItemHeader header;
+    std::memcpy(&header, m_position, sizeof(header));
+    const char *key = m_position + sizeof(header);
+    return {std::string_view(key, header.keySize), std::string_view(key + header.keySize, header.valueSize)};
+  }
+
+  Event::Items::Iterator &Event::Items::Iterator::operator++()
+  {
+    ItemHeader header;
+    std::memcpy(&header, m_position, sizeof(header));
+    m_position += sizeof(header) + header.keySize + header.valueSize;
+    return *this;
+  }
+
+  Event::Item Event::Items::operator[](std::size_t position) const
+  {
+    return *std::next(begin(), static_cast<std::ptrdiff_t>(position));
+  }
+
+  Event::Item Event::Items::at(std::size_t position) const
+  {
+    if (position >= m_count)
+      throw std::out_of_range("Event::Items::at");
+    return (*this)[position];
+  }
+
+  Event::Event(int id) : m_id(id)
+  {
+  }
+
+  Event::Event(int id, std::initializer_list<Item> items) : m_id(id)
+  {
+    for (const auto &[key, value] : items)
+      addItem(key, value);
+  }
+
+  Event::Event(int id, const EventItems &items) : m_id(id)
+  {
+    std::size_t bytes = 0;
+    for (const auto &[key, value] : items)
+      bytes += sizeof(ItemHeader) + key.size() + value.size();
+    reserve(bytes);
+    for (const auto &[key, value] : items)
+      addItem(key, value);
+  }
+
+  Event::Event(const Event &other) : m_id(other.m_id), m_source(other.m_source), m_count(other.m_count)
+  {
+    reserve(other.m_size);
+    append(other.data(), other.m_size);
+  }
+
+  Event::Event(Event &&other) noexcept
+      : m_id(other.m_id), m_source(other.m_source), m_count(other.m_count), m_size(other.m_size),
+        m_capacity(other.m_capacity), m_heap(std::move(other.m_heap))
+  {
+    if (!m_heap)
+      std::memcpy(m_inline, other.m_inline, m_size);
+    other.m_count = 0;
+    other.m_size = 0;
+    other.m_capacity = kInlineSize;
+  }
+
+  Event &Event::operator=(const Event &other)
+  {
+    if (this != &other)
+    {
+      m_id = other.m_id;
+      m_source = other.m_source;
+      m_count = other.m_count;
+      m_size = 0;
+      reserve(other.m_size);
+      append(other.data(), other.m_size);
+    }
+    return *this;
+  }
 
-  Event::Event(const int id, EventItems &&eventItems)
-      : m_id(id), m_events(eventItems)
+  Event &Event::operator=(Event &&other) noexcept
   {
+    if (this != &other)
+    {
+      m_id = other.m_id;
+      m_source = other.m_source;
+      m_count = std::exchange(other.m_count, 0);
+      m_size = std::exchange(other.m_size, 0);
+      m_capacity = std::exchange(other.m_capacity, static_cast<uint32_t>(kInlineSize));
+      m_heap = std::move(other.m_heap);
+      if (!m_heap)
+        std::memcpy(m_inline, other.m_inline, m_size);
+    }
+    return *this;
   }
 
   int Event::getId() const
@@ -14,24 +108,82 @@ namespace db
     return m_id;
   }
 
-  const Event::EventItems &Event::getEventItems() const
+  void Event::setId(int id)
+  {
+    m_id = id;
+  }
+
+  SourceId Event::getSource() const
+  {
+    return m_source;
+  }
+
+  void Event::setSource(SourceId source)
+  {
+    m_source = source;
+  }
+
+  void Event::addItem(std::string_view key, std::string_view value)
+  {
+    const ItemHeader header{static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value.size())};
+    const std::size_t size = m_size + sizeof(header) + key.size() + value.size();
+    if (size > m_capacity)
+      grow(std::max<std::size_t>(size, 2 * static_cast<std::size_t>(m_capacity)));
+    append(&header, sizeof(header));
+    append(key.data(), key.size());
+    append(value.data(), value.size());
+    ++m_count;
+  }
+
+  void Event::reserve(std::size_t bytes)
   {
-    return m_events;
+    if (bytes > m_capacity)
+      grow(bytes);
   }
 
-  const std::string Event::findByKey(const std::string &key) const
+  Event::Items Event::getEventItems() const
   {
+    return Items(std::string_view(data(), m_size), m_count);
+  }
+
+  const char *Event::data() const
+  {
+    return m_heap ? m_heap.get() : m_inline;
+  }
+
+  void Event::grow(std::size_t bytes)
+  {
+    auto heap = std::make_unique<char[]>(bytes);
+    std::memcpy(heap.get(), data(), m_size);
+    m_heap = std::move(heap);
+    m_capacity = static_cast<uint32_t>(bytes);
+  }
 
-    return std::ranges::find_if(m_events, [&key](const auto &item)
-                                { return item.first == key; })
-        ->second;
+  void Event::append(const void *bytes, std::size_t size)
+  {
+    // callers make the room first
+    if (size > 0)
+      std::memcpy((m_heap ? m_heap.get() : m_inline) + m_size, bytes, size);
+    m_size += static_cast<uint32_t>(size);
+  }
+
+  std::string_view Event::findByKey(std::string_view key) const
+  {
+    const auto items = getEventItems();
+    auto found = std::ranges::find(items, key, &Item::first);
+    return found == items.end() ? std::string_view() : (*found).second;
+  }
+
+  Event::Items::Iterator Event::findInEvent(const std::string &search) const
+  {
+    return findInEvent(search::Matcher::Cached(search));
   }
 
-  Event::EventItemsIterator Event::findInEvent(const std::string &search)
+  Event::Items::Iterator Event::findInEvent(const search::Matcher &matcher) const
   {
-    std::regex searchRegex(search);
-    return std::ranges::find_if(m_events, [&searchRegex](const auto &item)
-                                { return std::regex_search(item.second, searchRegex); });
+    const auto items = getEventItems();
+    return std::ranges::find_if(items, [&matcher](const Item &item)
+                                { return matcher.Matches(item.second); });
   }
 
 } // namespace db
@@ -1,25 +1,125 @@
 #ifndef DB_EVENT_HPP
 #define DB_EVENT_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+namespace search
+{
+	class Matcher;
+}
+
 namespace db
 {
+	// log file an event was read from when several are shown as one
+	using SourceId = uint16_t;
 
+	// An event on its way from a parser to the store. Its keys and values
+	// are packed back to back into one buffer, each item behind the sizes
+	// of its key and value. Up to kInlineSize bytes the buffer is part of
+	// the event, so a short event costs no allocation; past it the buffer
+	// moves to the heap, one allocation whatever the number of fields.
+	// Items are read as string views into the buffer, valid until the event
+	// changes, moves or goes.
 	class Event
 	{
 	public:
 		//(eventFieldName,data)
+		using Item = std::pair<std::string_view, std::string_view>;
+		// items built by hand, they are copied into the buffer
 		using EventItems = std::vector<std::pair<std::string, std::string>>;
-		using EventItemsIterator = std::vector<std::pair<std::string, std::string>>::iterator;
-		using EventItemsConstIterator = std::vector<std::pair<std::string, std::string>>::const_iterator;
 
-		Event(const int id, EventItems &&eventItems);
+		class Items
+		{
+		public:
+			class Iterator
+			{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = Item;
+				using difference_type = std::ptrdiff_t;
+				using pointer = void;
+				using reference = Item;
+
+				struct Arrow
+				{
+					Item item;
+					const Item *operator->() const { return &item; }
+				};
+
+				Iterator() = default;
+				explicit Iterator(const char *position) : m_position(position) {}
+
+				Item operator*() const;
+				Arrow operator->() const { return {**this}; }
+				Iterator &operator++();
+				Iterator operator++(int)
+				{
+					auto copy = *this;
+					++*this;
+					return copy;
+				}
+				bool operator==(const Iterator &other) const { return m_position == other.m_position; }
+
+			private:
+				const char *m_position{nullptr};
+			};
+
+			Items(std::string_view text, std::size_t count) : m_text(text), m_count(count) {}
+
+			std::size_t size() const { return m_count; }
+			bool empty() const { return m_count == 0; }
+			// walks the items before it
+			Item operator[](std::size_t position) const;
+			Item at(std::size_t position) const;
+			Iterator begin() const { return Iterator(m_text.data()); }
+			Iterator end() const { return Iterator(m_text.data() + m_text.size()); }
+
+			bool operator==(const Items &other) const
+			{
+				return m_count == other.m_count && m_text == other.m_text;
+			}
+
+		private:
+			std::string_view m_text;
+			std::size_t m_count;
+		};
+
+		// bytes of items, with 8 bytes per item for the sizes, kept in the event itself
+		static constexpr std::size_t kInlineSize = 128;
+
+		explicit Event(int id);
+		Event(int id, std::initializer_list<Item> items);
+		Event(int id, const EventItems &items);
+		Event(const Event &other);
+		Event(Event &&other) noexcept;
+		Event &operator=(const Event &other);
+		Event &operator=(Event &&other) noexcept;
+
 		int getId() const;
-		const EventItems &getEventItems() const;
-		const std::string findByKey(const std::string &key) const;
-		EventItemsIterator findInEvent(const std::string &search);
+		void setId(int id);
+		// 0 unless the event was merged from several logs
+		SourceId getSource() const;
+		void setSource(SourceId source);
+
+		// the parsers build events item by item
+		void addItem(std::string_view key, std::string_view value);
+		// makes room for this many bytes of keys and values
+		void reserve(std::size_t bytes);
+
+		Items getEventItems() const;
+		// value of the first item of the key, empty if there is none
+		std::string_view findByKey(std::string_view key) const;
+		// the pattern is compiled once per thread and reused, see search::Matcher
+		Items::Iterator findInEvent(const std::string &search) const;
+		Items::Iterator findInEvent(const search::Matcher &matcher) const;
 
 		bool operator==(const Event &other) const
 		{
@@ -27,8 +127,26 @@ namespace db
 		}
 
 	private:
+		// in front of every item
+		struct ItemHeader
+		{
+			uint32_t keySize;
+			uint32_t valueSize;
+		};
+
+		const char *data() const;
+		// room for `bytes` in all, on the heap once they do not fit inline
+		void grow(std::size_t bytes);
+		void append(const void *bytes, std::size_t size);
+
 		int m_id;
-		EventItems m_events;
+		SourceId m_source{0};
+		uint32_t m_count{0};
+		uint32_t m_size{0};
+		uint32_t m_capacity{kInlineSize};
+		// null while the items fit m_inline
+		std::unique_ptr<char[]> m_heap;
+		char m_inline[kInlineSize];
 	};
 
 } // namespace db
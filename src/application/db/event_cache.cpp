@@ -0,0 +1,148 @@
+#include "db/event_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "util/mapped_file.hpp"
+
+namespace db
+{
+  namespace
+  {
+    constexpr char kCacheMagic[8] = {'L', 'V', 'C', 'A', 'C', 'H', 'E', '\0'};
+    constexpr uint32_t kCacheVersion = 1;
+    // bytes hashed at either end of the log
+    constexpr std::size_t kHashedBytes = 1 << 20;
+
+    // the store image follows at storeOffset
+    struct CacheHeader
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t reserved;
+      uint64_t size;
+      int64_t modified;
+      uint64_t hash;
+      uint64_t storeOffset;
+      char padding[16];
+    };
+    static_assert(sizeof(CacheHeader) == 64);
+
+    uint64_t fnv1a(const char *data, std::size_t size, uint64_t hash)
+    {
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+      }
+      return hash;
+    }
+  } // namespace
+
+  std::filesystem::path EventCache::SidecarPath(const std::filesystem::path &log)
+  {
+    auto path = log;
+    path += ".lvcache";
+    return path;
+  }
+
+  EventCache::Key EventCache::keyOf(const std::filesystem::path &log)
+  {
+    Key key{};
+    key.size = std::filesystem::file_size(log);
+    key.modified = std::filesystem::last_write_time(log).time_since_epoch().count();
+
+    std::ifstream in(log, std::ios::binary);
+    if (!in)
+      throw std::runtime_error("Cannot open " + log.string());
+    std::vector<char> buffer(std::min<uint64_t>(key.size, kHashedBytes));
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    hash = fnv1a(buffer.data(), static_cast<std::size_t>(in.gcount()), hash);
+    if (key.size > kHashedBytes)
+    {
+      // the tail does not overlap the head
+      const uint64_t tail = std::max<uint64_t>(kHashedBytes, key.size - kHashedBytes);
+      in.seekg(static_cast<std::streamoff>(tail));
+      in.read(buffer.data(), static_cast<std::streamsize>(key.size - tail));
+      hash = fnv1a(buffer.data(), static_cast<std::size_t>(in.gcount()), hash);
+    }
+    key.hash = hash;
+    return key;
+  }
+
+  void EventCache::Write(const EventStore &store, const std::filesystem::path &log, std::ostream &out)
+  {
+    write(store, keyOf(log), out);
+  }
+
+  void EventCache::write(const EventStore &store, const Key &key, std::ostream &out)
+  {
+    CacheHeader header{};
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kCacheVersion;
+    header.size = key.size;
+    header.modified = key.modified;
+    header.hash = key.hash;
+    header.storeOffset = sizeof(CacheHeader);
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    store.Save(out);
+  }
+
+  void EventCache::Save(const EventStore &store, const std::filesystem::path &log)
+  {
+    const auto key = keyOf(log);
+    const auto path = SidecarPath(log);
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+      std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+      if (!out)
+        throw std::runtime_error("Cannot write " + temporary.string());
+      write(store, key, out);
+      out.close();
+      if (!out)
+      {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        throw std::runtime_error("Cannot write " + temporary.string());
+      }
+    }
+    std::filesystem::rename(temporary, path);
+  }
+
+  bool EventCache::Open(EventStore &store, const std::filesystem::path &log)
+  {
+    const auto path = SidecarPath(log);
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error))
+      return false;
+
+    try
+    {
+      auto file = std::make_shared<const util::MappedFile>(path);
+      if (file->Size() < sizeof(CacheHeader))
+        return false;
+      CacheHeader header;
+      std::memcpy(&header, file->Data(), sizeof(header));
+      if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion)
+        return false;
+      if (Key{header.size, header.modified, header.hash} != keyOf(log))
+        return false;
+
+      store.Map(std::move(file), header.storeOffset);
+      return true;
+    }
+    catch (const std::exception &)
+    {
+      // an unreadable or damaged cache is only a miss, the log gets parsed
+      return false;
+    }
+  }
+
+} // namespace db
@@ -0,0 +1,49 @@
+#ifndef DB_EVENTCACHE_HPP
+#define DB_EVENTCACHE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+#include "db/event_store.hpp"
+
+namespace db
+{
+	// Binary sidecar of a parsed log, written next to it as <log>.lvcache.
+	// It holds the image of the EventStore and the key of the log it was
+	// parsed from: size, modification time and a hash of the first and the
+	// last MiB. Opening maps the image and serves the store from it as is,
+	// reopening a large log costs a page fault per page actually read.
+	class EventCache
+	{
+	public:
+		static std::filesystem::path SidecarPath(const std::filesystem::path &log);
+
+		// Writes the sidecar of the log the store was parsed from. The file
+		// is written next to it and renamed into place, so a reader never
+		// sees half of it. Throws std::runtime_error on failure.
+		static void Save(const EventStore &store, const std::filesystem::path &log);
+		// Writes the sidecar content to a stream, for sidecars produced
+		// elsewhere. Throws std::runtime_error if the log cannot be read.
+		static void Write(const EventStore &store, const std::filesystem::path &log, std::ostream &out);
+		// Maps the sidecar into the store, false if there is none or it was
+		// written for another version of the log.
+		static bool Open(EventStore &store, const std::filesystem::path &log);
+
+	private:
+		struct Key
+		{
+			uint64_t size;
+			int64_t modified;
+			uint64_t hash;
+
+			bool operator==(const Key &other) const = default;
+		};
+
+		static Key keyOf(const std::filesystem::path &log);
+		static void write(const EventStore &store, const Key &key, std::ostream &out);
+	};
+
+} // namespace db
+
+#endif // DB_EVENTCACHE_HPP
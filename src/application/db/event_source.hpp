@@ -0,0 +1,24 @@
+#ifndef DB_EVENTSOURCE_HPP
+#define DB_EVENTSOURCE_HPP
+
+#include <cstddef>
+
+#include "db/event.hpp"
+
+namespace db
+{
+	// Events that are known by position but only built when asked for,
+	// e.g. the elements of a log that was scanned but not parsed.
+	class EventSource
+	{
+	public:
+		virtual ~EventSource() = default;
+
+		virtual std::size_t Size() const = 0;
+		// builds the event at `index`, ids are the positions
+		virtual Event Load(std::size_t index) const = 0;
+	};
+
+} // namespace db
+
+#endif // DB_EVENTSOURCE_HPP
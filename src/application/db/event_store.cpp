@@ -0,0 +1,801 @@
+#include "db/event_store.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace db
+{
+  namespace
+  {
+    constexpr char kImageMagic[8] = {'L', 'V', 'S', 'T', 'O', 'R', 'E', '\0'};
+    constexpr uint32_t kImageVersion = 4;
+    // reads back swapped on a machine of the other byte order
+    constexpr uint32_t kByteOrder = 0x01020304;
+
+    // Sections follow the header in this order, each starts 8 byte aligned:
+    // ids, times, sources, rowSchemas, schemaBegin, schemaFields, layoutRows,
+    // layoutBegin, layoutFields, columnBegin, columnRefs, repeatedRows,
+    // repeatedBegin, repeatedRefs, nameBegin, names, chunkBegin, strings.
+    struct ImageHeader
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t byteOrder;
+      uint64_t rows;
+      // 1 if IsTimeSorted
+      uint64_t timeSorted;
+      // rows or 0
+      uint64_t sources;
+      uint64_t fields;
+      uint64_t schemas;
+      uint64_t schemaFields;
+      uint64_t layoutRows;
+      uint64_t layoutFields;
+      uint64_t columnRefs;
+      uint64_t repeatedRows;
+      uint64_t repeatedRefs;
+      uint64_t chunks;
+      uint64_t nameBytes;
+      uint64_t stringBytes;
+      // header included
+      uint64_t imageSize;
+    };
+
+    constexpr std::size_t aligned(std::size_t size)
+    {
+      return (size + 7) & ~std::size_t(7);
+    }
+
+    class ImageWriter
+    {
+    public:
+      explicit ImageWriter(std::ostream &out) : m_out(out) {}
+
+      template <typename T>
+      void Section(std::span<const T> values)
+      {
+        Write(values);
+        Pad();
+      }
+
+      template <typename T>
+      void Section(const util::SegmentedVector<T> &values)
+      {
+        Write(values);
+        Pad();
+      }
+
+      template <typename T>
+      void Write(const util::SegmentedVector<T> &values)
+      {
+        values.ForEachRun(0, values.size(), [this](std::span<const T> run, std::size_t)
+                          { Write(run); });
+      }
+
+      // sections of several parts are written piece by piece and padded once
+      template <typename T>
+      void Write(std::span<const T> values)
+      {
+        m_out.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+        m_written += values.size_bytes();
+      }
+
+      void Pad()
+      {
+        static constexpr char padding[8] = {};
+        m_out.write(padding, static_cast<std::streamsize>(aligned(m_written) - m_written));
+        m_written = aligned(m_written);
+      }
+
+    private:
+      std::ostream &m_out;
+      std::size_t m_written{0};
+    };
+
+    class ImageReader
+    {
+    public:
+      ImageReader(const char *data, std::size_t size) : m_data(data), m_size(size) {}
+
+      template <typename T>
+      std::span<const T> Section(uint64_t count)
+      {
+        if (count > (m_size - m_position) / sizeof(T))
+          throw std::runtime_error("EventStore::Map: truncated image");
+        std::span<const T> section(reinterpret_cast<const T *>(m_data + m_position), count);
+        m_position += std::min<std::size_t>(aligned(count * sizeof(T)), m_size - m_position);
+        return section;
+      }
+
+    private:
+      const char *m_data;
+      std::size_t m_size;
+      std::size_t m_position{sizeof(ImageHeader)};
+    };
+
+    // first position whose value is not below `value`
+    std::size_t lowerBound(util::SegmentedSpan<const uint64_t> values, uint64_t value)
+    {
+      std::size_t low = 0, high = values.size();
+      while (low < high)
+      {
+        const std::size_t middle = low + (high - low) / 2;
+        if (values[middle] < value)
+          low = middle + 1;
+        else
+          high = middle;
+      }
+      return low;
+    }
+
+    void expect(bool condition, const char *what)
+    {
+      if (!condition)
+        throw std::runtime_error(std::string("EventStore::Map: ") + what);
+    }
+
+    // offsets into a section of `size` elements: from 0, never going back, ending at the size
+    bool isOffsets(std::span<const uint64_t> begin, std::size_t size)
+    {
+      if (begin.empty() || begin.front() != 0 || begin.back() != size)
+        return false;
+      return std::is_sorted(begin.begin(), begin.end());
+    }
+
+    // rows of a sparse table: ascending, each once and below `rows`
+    bool isRows(std::span<const uint64_t> values, std::size_t rows)
+    {
+      for (std::size_t i = 0; i < values.size(); ++i)
+      {
+        if (values[i] >= rows || (i > 0 && values[i] <= values[i - 1]))
+          return false;
+      }
+      return true;
+    }
+  } // namespace
+
+  EventStore::EventStore() : m_fields(std::make_shared<FieldDictionary>())
+  {
+  }
+
+  EventStore::EventStore(std::shared_ptr<FieldDictionary> fields) : m_fields(std::move(fields))
+  {
+  }
+
+  void EventStore::push_back(const Event &event)
+  {
+    if (m_image)
+      throw std::logic_error("EventStore::push_back: the store is mapped read only");
+
+    // everything of the row is in place before m_ids publishes it
+    const std::size_t row = m_ids.size();
+    if (m_memoryBudget != 0 && row % kBudgetCheckRows == 0)
+      checkBudget();
+    if (event.getSource() != 0 || !m_sources.empty())
+    {
+      m_sources.resize(row);
+      m_sources.push_back(event.getSource());
+    }
+
+    const std::size_t repeatedRefs = m_repeatedRefs.size();
+    m_rowLayout.clear();
+    for (const auto &[key, value] : event.getEventItems())
+    {
+      auto field = intern(key, m_rowLayout.size());
+      if (field >= m_columns.size())
+      {
+        m_columns.resize(field + 1);
+        m_valueDictionaries.resize(field + 1);
+      }
+
+      auto ref = storeValue(field, value);
+      auto &column = m_columns[field];
+      if (column.size() > row)
+      {
+        m_repeatedRefs.push_back(ref);
+        m_rowLayout.push_back(field | kRepeatedField);
+        continue;
+      }
+
+      column.resize(row);
+      column.push_back(ref);
+      m_rowLayout.push_back(field);
+    }
+
+    const auto schema = schemaOf(m_rowLayout);
+    if (schema == kNoSchema)
+    {
+      for (auto field : m_rowLayout)
+        m_layoutFields.push_back(field);
+      m_layoutBegin.push_back(m_layoutFields.size());
+      m_layoutRows.push_back(row);
+    }
+    m_rowSchemas.push_back(schema);
+    std::swap(m_rowLayout, m_previousLayout);
+    if (m_repeatedRefs.size() > repeatedRefs)
+    {
+      m_repeatedBegin.push_back(m_repeatedRefs.size());
+      m_repeatedRows.push_back(row);
+    }
+
+    if (!m_timeField)
+      m_timeField = m_fields->Find(kTimeField);
+    Timestamp time = kNoTime;
+    if (m_timeField && *m_timeField < m_columns.size() && m_columns[*m_timeField].size() > row)
+      time = ParseTimestamp(m_strings.Get(m_columns[*m_timeField][row])).value_or(kNoTime);
+    if (time == kNoTime || (!m_times.empty() && m_times.back() > time))
+      m_timeSorted.store(false, std::memory_order_relaxed);
+    m_times.push_back(time);
+    m_ids.push_back(event.getId());
+  }
+
+  EventView EventStore::at(std::size_t index) const
+  {
+    if (index >= size())
+      throw std::out_of_range("EventStore::at: index " + std::to_string(index) + " out of range");
+    return EventView(*this, index);
+  }
+
+  std::size_t EventStore::size() const
+  {
+    return m_image ? m_image->ids.size() : m_ids.size();
+  }
+
+  void EventStore::clear()
+  {
+    m_image.reset();
+    // a store sharing its dictionary gets one of its own again
+    m_fields = std::make_shared<FieldDictionary>();
+    m_strings.Clear();
+    m_ids.clear();
+    m_times.clear();
+    m_sources.clear();
+    m_timeSorted = true;
+    m_timeField.reset();
+    m_columns.clear();
+    m_valueDictionaries.clear();
+    m_rowSchemas.clear();
+    m_schemaBegin.clear();
+    m_schemaBegin.push_back(0);
+    m_schemaFields.clear();
+    m_schemas.clear();
+    m_rowLayout.clear();
+    m_previousLayout.clear();
+    m_layoutRows.clear();
+    m_layoutBegin.clear();
+    m_layoutBegin.push_back(0);
+    m_layoutFields.clear();
+    m_repeatedRows.clear();
+    m_repeatedBegin.clear();
+    m_repeatedBegin.push_back(0);
+    m_repeatedRefs.clear();
+    m_spillError.clear();
+  }
+
+  void EventStore::reserve(std::size_t events)
+  {
+    const std::size_t rows = m_ids.size();
+    if (m_image || events <= rows)
+      return;
+
+    m_ids.reserve(events);
+    m_times.reserve(events);
+    if (!m_sources.empty())
+      m_sources.reserve(events);
+    m_rowSchemas.reserve(events);
+    // columns most events have are grown up front, sparse ones as they fill
+    for (std::size_t field = 0; field < m_columns.size(); ++field)
+    {
+      if (m_columns[field].size() * 2 > rows)
+        m_columns[field].reserve(events);
+    }
+  }
+
+  const FieldDictionary &EventStore::GetFields() const
+  {
+    return *m_fields;
+  }
+
+  std::shared_ptr<FieldDictionary> EventStore::SharedFields() const
+  {
+    return m_fields;
+  }
+
+  int EventStore::GetId(std::size_t row) const
+  {
+    return m_image ? m_image->ids[row] : m_ids[row];
+  }
+
+  SourceId EventStore::GetSource(std::size_t row) const
+  {
+    const auto sources = m_image ? m_image->sources : m_sources.View();
+    return row < sources.size() ? sources[row] : 0;
+  }
+
+  std::string_view EventStore::GetValue(std::size_t row, FieldId field) const
+  {
+    auto refs = column(field);
+    return row < refs.size() ? string(refs[row]) : std::string_view();
+  }
+
+  bool EventStore::HasValue(std::size_t row, FieldId field) const
+  {
+    auto refs = column(field);
+    return row < refs.size() && !refs[row].IsNull();
+  }
+
+  util::SegmentedSpan<const StringRef> EventStore::GetColumn(FieldId field) const
+  {
+    return column(field);
+  }
+
+  std::string_view EventStore::GetString(StringRef ref) const
+  {
+    return string(ref);
+  }
+
+  util::SegmentedSpan<const Timestamp> EventStore::GetTimes() const
+  {
+    return m_image ? m_image->times : m_times.View();
+  }
+
+  Timestamp EventStore::GetTime(std::size_t row) const
+  {
+    return GetTimes()[row];
+  }
+
+  bool EventStore::IsTimeSorted() const
+  {
+    return m_image ? m_image->timeSorted : m_timeSorted.load(std::memory_order_relaxed);
+  }
+
+  std::size_t EventStore::GetFieldCount(std::size_t row) const
+  {
+    return layout(row).count;
+  }
+
+  EventView::Item EventStore::GetField(std::size_t row, std::size_t position) const
+  {
+    const auto fields = layout(row);
+    const FieldId field = fields.fields[fields.begin + position];
+    if ((field & kRepeatedField) == 0)
+      return {m_fields->Name(field), string(column(field)[row])};
+
+    std::size_t repeated = 0;
+    for (std::size_t i = fields.begin; i < fields.begin + position; ++i)
+      repeated += (fields.fields[i] & kRepeatedField) != 0;
+    return {m_fields->Name(field & ~kRepeatedField), string(repeatedRefs()[repeatedValues(row).first + repeated])};
+  }
+
+  std::size_t EventStore::GetSchemaCount() const
+  {
+    return (m_image ? m_image->schemaBegin.size() : m_schemaBegin.size()) - 1;
+  }
+
+  void EventStore::SetMemoryBudget(std::size_t bytes, std::filesystem::path spillDirectory)
+  {
+    m_memoryBudget = bytes;
+    m_spillDirectory = std::move(spillDirectory);
+  }
+
+  std::size_t EventStore::GetMemoryBudget() const
+  {
+    return m_memoryBudget;
+  }
+
+  std::size_t EventStore::GetSpilledSize() const
+  {
+    return m_strings.SpilledSize();
+  }
+
+  const std::string &EventStore::GetSpillError() const
+  {
+    return m_spillError;
+  }
+
+  std::size_t EventStore::MemoryUsage() const
+  {
+    std::size_t total = m_fields->MemoryUsage() + m_strings.MemoryUsage();
+    total += m_ids.capacity() * sizeof(int);
+    total += m_times.capacity() * sizeof(Timestamp);
+    total += m_sources.capacity() * sizeof(SourceId);
+    total += m_columns.capacity() * sizeof(util::SegmentedVector<StringRef>);
+    for (std::size_t field = 0; field < m_columns.size(); ++field)
+      total += m_columns[field].capacity() * sizeof(StringRef);
+    total += m_rowSchemas.capacity() * sizeof(SchemaId);
+    total += (m_schemaBegin.capacity() + m_layoutRows.capacity() + m_layoutBegin.capacity()) * sizeof(uint64_t);
+    total += (m_schemaFields.capacity() + m_layoutFields.capacity()) * sizeof(FieldId);
+    // the writer's schema lookup holds a copy of every schema
+    total += m_schemas.size() * (sizeof(std::vector<FieldId>) + sizeof(SchemaId) + 2 * sizeof(void *)) +
+             m_schemaFields.size() * sizeof(FieldId);
+    for (const auto &dictionary : m_valueDictionaries)
+      total += sizeof(dictionary) + dictionary.values.size() * (sizeof(std::string_view) + sizeof(StringRef) + 2 * sizeof(void *));
+    total += (m_repeatedRows.capacity() + m_repeatedBegin.capacity()) * sizeof(uint64_t);
+    total += m_repeatedRefs.capacity() * sizeof(StringRef);
+    return total;
+  }
+
+  void EventStore::Save(std::ostream &out) const
+  {
+    if (m_image)
+      throw std::logic_error("EventStore::Save: a mapped store is an image already");
+    static_assert(sizeof(int) == sizeof(int32_t));
+
+    std::vector<uint64_t> columnBegin{0};
+    for (std::size_t field = 0; field < m_columns.size(); ++field)
+      columnBegin.push_back(columnBegin.back() + m_columns[field].size());
+    // a shared dictionary may know fields this store has no column for
+    columnBegin.resize(m_fields->Size() + 1, columnBegin.back());
+
+    std::vector<uint64_t> nameBegin{0};
+    for (FieldId field = 0; field < m_fields->Size(); ++field)
+      nameBegin.push_back(nameBegin.back() + m_fields->Name(field).size());
+
+    std::vector<uint64_t> chunkBegin{0};
+    for (std::size_t chunk = 0; chunk < m_strings.ChunkCount(); ++chunk)
+      chunkBegin.push_back(chunkBegin.back() + m_strings.ChunkData(chunk).size());
+
+    ImageHeader header{};
+    std::memcpy(header.magic, kImageMagic, sizeof(kImageMagic));
+    header.version = kImageVersion;
+    header.byteOrder = kByteOrder;
+    header.rows = m_ids.size();
+    header.timeSorted = m_timeSorted ? 1 : 0;
+    header.sources = m_sources.size();
+    header.fields = m_fields->Size();
+    header.schemas = m_schemaBegin.size() - 1;
+    header.schemaFields = m_schemaFields.size();
+    header.layoutRows = m_layoutRows.size();
+    header.layoutFields = m_layoutFields.size();
+    header.columnRefs = columnBegin.back();
+    header.repeatedRows = m_repeatedRows.size();
+    header.repeatedRefs = m_repeatedRefs.size();
+    header.chunks = m_strings.ChunkCount();
+    header.nameBytes = nameBegin.back();
+    header.stringBytes = chunkBegin.back();
+    header.imageSize = aligned(sizeof(header)) + aligned(header.rows * sizeof(int32_t)) +
+                       header.rows * sizeof(Timestamp) + aligned(header.sources * sizeof(SourceId)) +
+                       aligned(header.rows * sizeof(SchemaId)) + aligned(header.schemaFields * sizeof(FieldId)) +
+                       aligned(header.layoutFields * sizeof(FieldId)) + aligned(header.columnRefs * sizeof(StringRef)) +
+                       aligned(header.repeatedRefs * sizeof(StringRef)) + aligned(header.nameBytes) +
+                       aligned(header.stringBytes) +
+                       sizeof(uint64_t) * (header.schemas + 1 + 2 * header.layoutRows + 1 + header.fields + 1 +
+                                           2 * header.repeatedRows + 1 + header.fields + 1 + header.chunks + 1);
+
+    ImageWriter writer(out);
+    writer.Section(std::span<const ImageHeader>(&header, 1));
+    writer.Section(m_ids);
+    writer.Section(m_times);
+    writer.Section(m_sources);
+    writer.Section(m_rowSchemas);
+    writer.Section(m_schemaBegin);
+    writer.Section(m_schemaFields);
+    writer.Section(m_layoutRows);
+    writer.Section(m_layoutBegin);
+    writer.Section(m_layoutFields);
+    writer.Section(std::span<const uint64_t>(columnBegin));
+    for (std::size_t field = 0; field < m_columns.size(); ++field)
+      writer.Write(m_columns[field]);
+    writer.Pad();
+    writer.Section(m_repeatedRows);
+    writer.Section(m_repeatedBegin);
+    writer.Section(m_repeatedRefs);
+    writer.Section(std::span<const uint64_t>(nameBegin));
+    for (FieldId field = 0; field < m_fields->Size(); ++field)
+      writer.Write(std::span<const char>(m_fields->Name(field)));
+    writer.Pad();
+    writer.Section(std::span<const uint64_t>(chunkBegin));
+    for (std::size_t chunk = 0; chunk < m_strings.ChunkCount(); ++chunk)
+      writer.Write(std::span<const char>(m_strings.ChunkData(chunk)));
+    writer.Pad();
+
+    if (!out)
+      throw std::runtime_error("EventStore::Save: write failed");
+  }
+
+  void EventStore::Map(std::shared_ptr<const util::MappedFile> file, std::size_t offset)
+  {
+    expect(file != nullptr && offset <= file->Size() && offset % 8 == 0, "bad offset");
+    const char *data = file->Data() + offset;
+    const std::size_t available = file->Size() - offset;
+    expect(available >= sizeof(ImageHeader), "truncated image");
+
+    ImageHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    expect(std::memcmp(header.magic, kImageMagic, sizeof(kImageMagic)) == 0, "not an event store image");
+    expect(header.version == kImageVersion, "unsupported image version");
+    expect(header.byteOrder == kByteOrder, "image of another byte order");
+    expect(header.imageSize >= sizeof(ImageHeader) && header.imageSize <= available, "truncated image");
+
+    auto image = std::make_unique<Image>();
+    ImageReader reader(data, header.imageSize);
+    image->ids = reader.Section<int32_t>(header.rows);
+    image->times = reader.Section<Timestamp>(header.rows);
+    image->timeSorted = header.timeSorted != 0;
+    expect(header.sources == 0 || header.sources == header.rows, "corrupt sources");
+    image->sources = reader.Section<SourceId>(header.sources);
+    image->rowSchemas = reader.Section<SchemaId>(header.rows);
+    image->schemaBegin = reader.Section<uint64_t>(header.schemas + 1);
+    image->schemaFields = reader.Section<FieldId>(header.schemaFields);
+    image->layoutRows = reader.Section<uint64_t>(header.layoutRows);
+    image->layoutBegin = reader.Section<uint64_t>(header.layoutRows + 1);
+    image->layoutFields = reader.Section<FieldId>(header.layoutFields);
+    image->columnBegin = reader.Section<uint64_t>(header.fields + 1);
+    image->columnRefs = reader.Section<StringRef>(header.columnRefs);
+    image->repeatedRows = reader.Section<uint64_t>(header.repeatedRows);
+    image->repeatedBegin = reader.Section<uint64_t>(header.repeatedRows + 1);
+    image->repeatedRefs = reader.Section<StringRef>(header.repeatedRefs);
+    auto nameBegin = reader.Section<uint64_t>(header.fields + 1);
+    auto names = reader.Section<char>(header.nameBytes);
+    image->chunkBegin = reader.Section<uint64_t>(header.chunks + 1);
+    image->strings = reader.Section<char>(header.stringBytes).data();
+
+    // the readers trust the image, a damaged one must not get past here
+    expect(header.schemas <= kNoSchema, "corrupt schemas");
+    expect(isOffsets(nameBegin, header.nameBytes), "corrupt field names");
+    expect(isOffsets(image->chunkBegin, header.stringBytes), "corrupt strings");
+    checkImage(*image, header.fields);
+    // the ids of the image are the order of its names, which must be distinct
+    auto dictionary = std::make_shared<FieldDictionary>();
+    for (FieldId field = 0; field < header.fields; ++field)
+      expect(dictionary->Intern(std::string_view(names.data() + nameBegin[field], nameBegin[field + 1] - nameBegin[field])) == field,
+             "corrupt field names");
+
+    clear();
+    m_fields = std::move(dictionary);
+    image->file = std::move(file);
+    m_image = std::move(image);
+  }
+
+  void EventStore::checkImage(const Image &image, std::size_t fields)
+  {
+    expect(isOffsets(image.schemaBegin, image.schemaFields.size()), "corrupt schemas");
+    expect(isOffsets(image.layoutBegin, image.layoutFields.size()), "corrupt row fields");
+    expect(isOffsets(image.columnBegin, image.columnRefs.size()), "corrupt columns");
+    expect(isOffsets(image.repeatedBegin, image.repeatedRefs.size()), "corrupt repeated fields");
+    const std::size_t rows = image.ids.size();
+    expect(isRows(image.layoutRows, rows), "corrupt row fields");
+    expect(isRows(image.repeatedRows, rows), "corrupt repeated fields");
+
+    std::vector<std::size_t> columnSize(fields);
+    for (std::size_t field = 0; field < fields; ++field)
+    {
+      columnSize[field] = image.columnBegin[field + 1] - image.columnBegin[field];
+      expect(columnSize[field] <= rows, "corrupt columns");
+    }
+
+    // every field of a layout has a value: non repeated ones in their
+    // column, below the row, the repeated ones in those of the row
+    struct Needs
+    {
+      std::size_t rows{SIZE_MAX};
+      std::size_t repeated{0};
+    };
+    auto needs = [&](std::span<const FieldId> layout)
+    {
+      Needs needed;
+      for (auto field : layout)
+      {
+        const FieldId id = field & ~kRepeatedField;
+        expect(id < fields, "corrupt layout");
+        if (field & kRepeatedField)
+          ++needed.repeated;
+        else
+          needed.rows = std::min(needed.rows, columnSize[id]);
+      }
+      return needed;
+    };
+    std::vector<Needs> schemaNeeds;
+    for (std::size_t schema = 0; schema + 1 < image.schemaBegin.size(); ++schema)
+      schemaNeeds.push_back(needs(image.schemaFields.subspan(image.schemaBegin[schema], image.schemaBegin[schema + 1] - image.schemaBegin[schema])));
+
+    std::size_t layoutRow = 0, repeatedRow = 0;
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+      const SchemaId schema = image.rowSchemas[row];
+      Needs needed;
+      if (schema == kNoSchema)
+      {
+        expect(layoutRow < image.layoutRows.size() && image.layoutRows[layoutRow] == row, "corrupt row fields");
+        const auto begin = image.layoutBegin[layoutRow], end = image.layoutBegin[layoutRow + 1];
+        needed = needs(image.layoutFields.subspan(begin, end - begin));
+        ++layoutRow;
+      }
+      else
+      {
+        expect(schema < schemaNeeds.size(), "corrupt schema id");
+        needed = schemaNeeds[schema];
+      }
+      expect(needed.rows > row, "corrupt columns");
+
+      std::size_t repeated = 0;
+      if (repeatedRow < image.repeatedRows.size() && image.repeatedRows[repeatedRow] == row)
+      {
+        repeated = image.repeatedBegin[repeatedRow + 1] - image.repeatedBegin[repeatedRow];
+        ++repeatedRow;
+      }
+      expect(repeated == needed.repeated, "corrupt repeated fields");
+    }
+    expect(layoutRow == image.layoutRows.size(), "corrupt row fields");
+
+    if (image.timeSorted)
+    {
+      for (std::size_t row = 0; row < rows; ++row)
+        expect(image.times[row] != kNoTime && (row == 0 || image.times[row - 1] <= image.times[row]), "corrupt times");
+    }
+
+    // a reference starts a length prefix and a string inside its chunk
+    auto checkRefs = [&](std::span<const StringRef> refs)
+    {
+      for (auto ref : refs)
+      {
+        if (ref.IsNull())
+          continue;
+        expect(static_cast<std::size_t>(ref.chunk) + 1 < image.chunkBegin.size(), "corrupt string reference");
+        const auto begin = image.chunkBegin[ref.chunk];
+        const auto size = image.chunkBegin[ref.chunk + 1] - begin;
+        expect(ref.offset < size, "corrupt string reference");
+
+        const char *in = image.strings + begin + ref.offset;
+        std::size_t left = size - ref.offset;
+        std::size_t length = 0;
+        for (int shift = 0;; shift += 7)
+        {
+          expect(left > 0 && shift < 64, "corrupt string reference");
+          const auto byte = static_cast<unsigned char>(*in++);
+          --left;
+          length |= static_cast<std::size_t>(byte & 0x7F) << shift;
+          if ((byte & 0x80) == 0)
+            break;
+        }
+        expect(length <= left, "corrupt string reference");
+      }
+    };
+    checkRefs(image.columnRefs);
+    checkRefs(image.repeatedRefs);
+  }
+
+  bool EventStore::IsMapped() const
+  {
+    return m_image != nullptr;
+  }
+
+  EventStore::Layout EventStore::layout(std::size_t row) const
+  {
+    const SchemaId schema = m_image ? m_image->rowSchemas[row] : m_rowSchemas[row];
+    if (schema != kNoSchema)
+    {
+      const auto begin = m_image ? util::SegmentedSpan<const uint64_t>(m_image->schemaBegin) : m_schemaBegin.View();
+      return {m_image ? util::SegmentedSpan<const FieldId>(m_image->schemaFields) : m_schemaFields.View(),
+              begin[schema], begin[schema + 1] - begin[schema]};
+    }
+
+    const auto rows = m_image ? util::SegmentedSpan<const uint64_t>(m_image->layoutRows) : m_layoutRows.View();
+    const auto begin = m_image ? util::SegmentedSpan<const uint64_t>(m_image->layoutBegin) : m_layoutBegin.View();
+    const auto index = lowerBound(rows, row);
+    if (index == rows.size() || rows[index] != row)
+      throw std::out_of_range("EventStore: row " + std::to_string(row) + " has no layout");
+    return {m_image ? util::SegmentedSpan<const FieldId>(m_image->layoutFields) : m_layoutFields.View(),
+            begin[index], begin[index + 1] - begin[index]};
+  }
+
+  util::SegmentedSpan<const StringRef> EventStore::column(FieldId field) const
+  {
+    if (!m_image)
+      return field < m_columns.size() ? m_columns[field].View() : util::SegmentedSpan<const StringRef>();
+
+    const auto &begin = m_image->columnBegin;
+    if (field + 1 >= begin.size())
+      return {};
+    return m_image->columnRefs.subspan(begin[field], begin[field + 1] - begin[field]);
+  }
+
+  std::pair<std::size_t, std::size_t> EventStore::repeatedValues(std::size_t row) const
+  {
+    const auto rows = m_image ? util::SegmentedSpan<const uint64_t>(m_image->repeatedRows) : m_repeatedRows.View();
+    const auto begin = m_image ? util::SegmentedSpan<const uint64_t>(m_image->repeatedBegin) : m_repeatedBegin.View();
+
+    const auto low = lowerBound(rows, row);
+    if (low == rows.size() || rows[low] != row)
+      throw std::out_of_range("EventStore: row " + std::to_string(row) + " has no repeated fields");
+    return {begin[low], begin[low + 1] - begin[low]};
+  }
+
+  util::SegmentedSpan<const StringRef> EventStore::repeatedRefs() const
+  {
+    return m_image ? util::SegmentedSpan<const StringRef>(m_image->repeatedRefs) : m_repeatedRefs.View();
+  }
+
+  std::string_view EventStore::string(StringRef ref) const
+  {
+    if (!m_image)
+      return m_strings.Get(ref);
+    if (ref.IsNull())
+      return {};
+    return StringArena::Read(m_image->strings + m_image->chunkBegin[ref.chunk] + ref.offset);
+  }
+
+  FieldId EventStore::intern(std::string_view name, std::size_t position)
+  {
+    // consecutive events mostly share their layout, try the field the
+    // previous event had at the same position before hashing
+    if (position < m_previousLayout.size())
+    {
+      FieldId candidate = m_previousLayout[position] & ~kRepeatedField;
+      if (m_fields->Name(candidate) == name)
+        return candidate;
+    }
+    return m_fields->Intern(name);
+  }
+
+  EventStore::SchemaId EventStore::schemaOf(const std::vector<FieldId> &fields)
+  {
+    // the previous event most likely has the same schema
+    if (!m_rowSchemas.empty() && m_rowSchemas.back() != kNoSchema && fields == m_previousLayout)
+      return m_rowSchemas.back();
+    if (auto found = m_schemas.find(fields); found != m_schemas.end())
+      return found->second;
+    if (m_schemas.size() >= kNoSchema)
+      return kNoSchema;
+
+    const auto schema = static_cast<SchemaId>(m_schemas.size());
+    for (auto field : fields)
+      m_schemaFields.push_back(field);
+    m_schemaBegin.push_back(m_schemaFields.size());
+    m_schemas.emplace(fields, schema);
+    return schema;
+  }
+
+  std::size_t EventStore::LayoutHash::operator()(const std::vector<FieldId> &fields) const
+  {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (auto field : fields)
+    {
+      hash ^= field;
+      hash *= 0x100000001b3ULL;
+    }
+    return static_cast<std::size_t>(hash);
+  }
+
+  StringRef EventStore::storeValue(FieldId field, std::string_view value)
+  {
+    auto &dictionary = m_valueDictionaries[field];
+    if (!dictionary.enabled || value.size() > kMaxSharedValueLength)
+      return m_strings.Store(value);
+
+    if (auto found = dictionary.values.find(value); found != dictionary.values.end())
+      return found->second;
+
+    if (dictionary.values.size() >= kMaxSharedValues)
+    {
+      // high cardinality column, stop paying for the lookups
+      dictionary.enabled = false;
+      decltype(dictionary.values)().swap(dictionary.values);
+      return m_strings.Store(value);
+    }
+
+    // the dictionary keys point into the arena, they are looked up for
+    // every event and must not be spilled
+    auto ref = m_strings.StoreResident(value);
+    dictionary.values.emplace(m_strings.Get(ref), ref);
+    return ref;
+  }
+
+  void EventStore::checkBudget()
+  {
+    if (m_strings.IsSpilling() || !m_spillError.empty() || MemoryUsage() <= m_memoryBudget)
+      return;
+    try
+    {
+      m_strings.SetSpillFile(std::make_unique<util::SpillFile>(m_spillDirectory));
+    }
+    catch (const std::runtime_error &e)
+    {
+      // without a file to spill to the store keeps its values in memory
+      m_spillError = e.what();
+    }
+  }
+
+} // namespace db
@@ -0,0 +1,257 @@
+#ifndef DB_EVENTSTORE_HPP
+#define DB_EVENTSTORE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <climits>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "db/event.hpp"
+#include "db/event_view.hpp"
+#include "db/field_dictionary.hpp"
+#include "db/string_arena.hpp"
+#include "db/timestamp.hpp"
+#include "util/mapped_file.hpp"
+#include "util/segmented_vector.hpp"
+
+namespace db
+{
+	// Columnar event storage. Field names are interned once in a dictionary,
+	// values live in a shared string arena and every field id has a column of
+	// 8 byte references into it, one slot per event. A column only grows up to
+	// the last event that has the field, missing slots read as absent.
+	// The order of the fields of an event, its layout, is mostly one of a few
+	// that recur: every distinct layout is stored once as a schema and an
+	// event keeps a 2 byte schema id. Once the schema ids run out, events of
+	// new layouts keep a list of their field ids of their own.
+	// Short values of low cardinality columns (levels, types, flags) are
+	// stored once per column and shared by all events that have them.
+	//
+	// The container interface (push_back, at, size, clear, reserve) is what
+	// mvc::Model expects from its storage.
+	//
+	// Values are not owned by the events: they sit in 1 MiB arena chunks, so
+	// clearing a store of millions of events frees a few thousand blocks.
+	//
+	// The "timestamp" field is parsed once when an event is stored, into a
+	// dense column of microseconds beside the string columns. The source
+	// ids of merged logs get a column once an event is not of source 0.
+	//
+	// Save writes the store as one flat image that Map serves in place from
+	// a file mapping, nothing is deserialized. A mapped store is read only
+	// until it is cleared.
+	//
+	// With a memory budget, the values stored once MemoryUsage has passed it
+	// go to a spill file: arena chunks are written out as they fill and read
+	// back by the kernel when they are touched. The columns, times, schemas
+	// and shared values stay in memory, so a spilling store still grows by
+	// its per event arrays.
+	//
+	// One thread may push_back while others read: every per event array is
+	// a util::SegmentedVector whose elements never move, and the row count
+	// is published last, so the rows below size() are complete and can be
+	// read without a lock. clear and Map are not safe against concurrent
+	// readers.
+	//
+	// What is derived from the rows, like the filters, orders and counts of
+	// search::, is kept on the writer's thread: it is updated between
+	// appends with the rows appended since, and rebuilt after clear or Map,
+	// so the store never changes while it is read for them.
+	class EventStore
+	{
+	public:
+		using value_type = Event;
+
+		// field whose values fill the time column
+		static constexpr std::string_view kTimeField = "timestamp";
+		// time of events without a parsable timestamp
+		static constexpr Timestamp kNoTime = INT64_MIN;
+
+		EventStore();
+		// Interns field names into a dictionary shared with other stores, so
+		// a FieldId means the same field in all of them.
+		explicit EventStore(std::shared_ptr<FieldDictionary> fields);
+
+		// throws std::logic_error on a mapped store
+		void push_back(const Event &event);
+		EventView at(std::size_t index) const;
+		std::size_t size() const;
+		void clear();
+		// makes room for this many events in total, the field layout of the
+		// events stored so far is taken as representative
+		void reserve(std::size_t events);
+
+		const FieldDictionary &GetFields() const;
+		// for stores that are to share the dictionary of this one
+		std::shared_ptr<FieldDictionary> SharedFields() const;
+		int GetId(std::size_t row) const;
+		SourceId GetSource(std::size_t row) const;
+		// value of the first occurrence of the field, empty if the event has none
+		std::string_view GetValue(std::size_t row, FieldId field) const;
+		bool HasValue(std::size_t row, FieldId field) const;
+		// column of a field for column scans, it may be shorter than size()
+		util::SegmentedSpan<const StringRef> GetColumn(FieldId field) const;
+		std::string_view GetString(StringRef ref) const;
+
+		// one slot per event, kNoTime where there is no timestamp
+		util::SegmentedSpan<const Timestamp> GetTimes() const;
+		Timestamp GetTime(std::size_t row) const;
+		// every event has a time and they never go back, so the rows can
+		// be binary searched by time
+		bool IsTimeSorted() const;
+
+		std::size_t GetFieldCount(std::size_t row) const;
+		EventView::Item GetField(std::size_t row, std::size_t position) const;
+		// distinct layouts stored as schemas
+		std::size_t GetSchemaCount() const;
+
+		// mapped pages are file backed and not counted
+		std::size_t MemoryUsage() const;
+		// Bytes of memory past which values are spilled to a file in the
+		// directory, the temp directory if empty. 0 keeps everything in
+		// memory, a store spilling already goes on spilling until cleared.
+		void SetMemoryBudget(std::size_t bytes, std::filesystem::path spillDirectory = {});
+		std::size_t GetMemoryBudget() const;
+		// bytes of values in the spill file, not counted by MemoryUsage
+		std::size_t GetSpilledSize() const;
+		// why the store went past its budget without spilling, empty unless
+		// the spill file could not be created; read once the writer is done
+		const std::string &GetSpillError() const;
+
+		void Save(std::ostream &out) const;
+		// Serves the image Save wrote at `offset` of the file. Throws
+		// std::runtime_error if it is not a valid image.
+		void Map(std::shared_ptr<const util::MappedFile> file, std::size_t offset = 0);
+		bool IsMapped() const;
+
+	private:
+		using SchemaId = uint16_t;
+
+		struct LayoutHash
+		{
+			std::size_t operator()(const std::vector<FieldId> &fields) const;
+		};
+
+		// the event has a layout of its own
+		static constexpr SchemaId kNoSchema = UINT16_MAX;
+
+		struct ValueDictionary
+		{
+			std::unordered_map<std::string_view, StringRef> values;
+			bool enabled{true};
+		};
+
+		// sections of a mapped image
+		struct Image
+		{
+			std::shared_ptr<const util::MappedFile> file;
+			std::span<const int32_t> ids;
+			std::span<const Timestamp> times;
+			// empty if every event is of source 0
+			std::span<const SourceId> sources;
+			bool timeSorted{false};
+			std::span<const SchemaId> rowSchemas;
+			// fields of schema s are schemaFields[schemaBegin[s] .. schemaBegin[s + 1])
+			std::span<const uint64_t> schemaBegin;
+			std::span<const FieldId> schemaFields;
+			// rows of kNoSchema and where their fields start, with an end marker
+			std::span<const uint64_t> layoutRows;
+			std::span<const uint64_t> layoutBegin;
+			std::span<const FieldId> layoutFields;
+			// column f is columnRefs[columnBegin[f] .. columnBegin[f + 1])
+			std::span<const uint64_t> columnBegin;
+			std::span<const StringRef> columnRefs;
+			// rows with repeated fields and where their values start, with an end marker
+			std::span<const uint64_t> repeatedRows;
+			std::span<const uint64_t> repeatedBegin;
+			std::span<const StringRef> repeatedRefs;
+			std::span<const uint64_t> chunkBegin;
+			const char *strings{nullptr};
+		};
+
+		// fields of the layout are fields[begin .. begin + count)
+		struct Layout
+		{
+			util::SegmentedSpan<const FieldId> fields;
+			std::size_t begin{0};
+			std::size_t count{0};
+		};
+
+		// throws std::runtime_error unless every id, offset and reference of
+		// the image stays in bounds, so the readers need not check them
+		static void checkImage(const Image &image, std::size_t fields);
+		FieldId intern(std::string_view name, std::size_t position);
+		StringRef storeValue(FieldId field, std::string_view value);
+		// starts spilling once the store is over its budget
+		void checkBudget();
+		// the schema of the layout, a new one while there is room, else kNoSchema
+		SchemaId schemaOf(const std::vector<FieldId> &fields);
+
+		// read access to either the owned or the mapped storage
+		Layout layout(std::size_t row) const;
+		util::SegmentedSpan<const StringRef> column(FieldId field) const;
+		// values of the repeated fields of a row, as the index of the first and the count
+		std::pair<std::size_t, std::size_t> repeatedValues(std::size_t row) const;
+		util::SegmentedSpan<const StringRef> repeatedRefs() const;
+		std::string_view string(StringRef ref) const;
+
+	private:
+		// marks a further occurrence of a field already seen in the same event
+		static constexpr FieldId kRepeatedField = FieldId(1) << 31;
+		// columns with more distinct values than this are not deduplicated
+		static constexpr std::size_t kMaxSharedValues = 4096;
+		static constexpr std::size_t kMaxSharedValueLength = 64;
+		// MemoryUsage walks every column, it is not checked for every event
+		static constexpr std::size_t kBudgetCheckRows = 1024;
+
+		std::shared_ptr<FieldDictionary> m_fields;
+		StringArena m_strings;
+		std::size_t m_memoryBudget{0};
+		std::filesystem::path m_spillDirectory;
+		// no spill file is tried again until the store is cleared
+		std::string m_spillError;
+		// stored last, its size is the published row count
+		util::SegmentedVector<int> m_ids;
+		util::SegmentedVector<Timestamp> m_times;
+		std::atomic<bool> m_timeSorted{true};
+		// only filled once an event of another source than 0 is stored
+		util::SegmentedVector<SourceId> m_sources;
+		// none until an event has the time field
+		std::optional<FieldId> m_timeField;
+		util::SegmentedVector<util::SegmentedVector<StringRef>> m_columns;
+		// only used by the writer
+		std::vector<ValueDictionary> m_valueDictionaries;
+		util::SegmentedVector<SchemaId> m_rowSchemas;
+		// fields of schema s are m_schemaFields[m_schemaBegin[s] .. m_schemaBegin[s + 1])
+		util::SegmentedVector<uint64_t> m_schemaBegin{1, 0};
+		util::SegmentedVector<FieldId> m_schemaFields;
+		// only used by the writer, the layouts of the event being stored and the one before
+		std::unordered_map<std::vector<FieldId>, SchemaId, LayoutHash> m_schemas;
+		std::vector<FieldId> m_rowLayout;
+		std::vector<FieldId> m_previousLayout;
+		// rows without a schema in ascending order and where their fields
+		// start in m_layoutFields, laid out like the image
+		util::SegmentedVector<uint64_t> m_layoutRows;
+		util::SegmentedVector<uint64_t> m_layoutBegin{1, 0};
+		util::SegmentedVector<FieldId> m_layoutFields;
+		// rows with repeated fields in ascending order and where their values
+		// start in m_repeatedRefs, laid out like the image
+		util::SegmentedVector<uint64_t> m_repeatedRows;
+		util::SegmentedVector<uint64_t> m_repeatedBegin{1, 0};
+		util::SegmentedVector<StringRef> m_repeatedRefs;
+		std::unique_ptr<Image> m_image;
+	};
+
+} // namespace db
+
+#endif // DB_EVENTSTORE_HPP
@@ -0,0 +1,82 @@
+#include "db/event_view.hpp"
+
+#include <stdexcept>
+
+#include "db/event_store.hpp"
+#include "search/matcher.hpp"
+
+namespace db
+{
+  EventView::Items::Items(const EventStore &store, std::size_t row)
+      : m_store(&store), m_row(row), m_size(store.GetFieldCount(row))
+  {
+  }
+
+  std::size_t EventView::Items::size() const
+  {
+    return m_size;
+  }
+
+  bool EventView::Items::empty() const
+  {
+    return m_size == 0;
+  }
+
+  EventView::Item EventView::Items::operator[](std::size_t position) const
+  {
+    return m_store->GetField(m_row, position);
+  }
+
+  EventView::Item EventView::Items::at(std::size_t position) const
+  {
+    if (position >= m_size)
+      throw std::out_of_range("EventView::Items::at");
+    return m_store->GetField(m_row, position);
+  }
+
+  EventView::EventView(const EventStore &store, std::size_t row)
+      : m_store(&store), m_row(row)
+  {
+  }
+
+  EventView::EventView(std::shared_ptr<const EventStore> store, std::size_t row)
+      : m_store(store.get()), m_row(row), m_owner(std::move(store))
+  {
+  }
+
+  int EventView::getId() const
+  {
+    return m_store->GetId(m_row);
+  }
+
+  SourceId EventView::getSource() const
+  {
+    return m_store->GetSource(m_row);
+  }
+
+  EventView::Items EventView::getEventItems() const
+  {
+    return Items(*m_store, m_row);
+  }
+
+  std::string_view EventView::findByKey(std::string_view key) const
+  {
+    auto field = m_store->GetFields().Find(key);
+    return field ? m_store->GetValue(m_row, *field) : std::string_view();
+  }
+
+  std::string_view EventView::findByKey(FieldId field) const
+  {
+    return m_store->GetValue(m_row, field);
+  }
+
+  std::optional<std::size_t> EventView::findInEvent(const search::Matcher &matcher) const
+  {
+    const std::size_t count = m_store->GetFieldCount(m_row);
+    for (std::size_t position = 0; position < count; ++position)
+      if (matcher.Matches(m_store->GetField(m_row, position).second))
+        return position;
+    return std::nullopt;
+  }
+
+} // namespace db
@@ -0,0 +1,112 @@
+#ifndef DB_EVENTVIEW_HPP
+#define DB_EVENTVIEW_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "db/event.hpp"
+#include "db/field_dictionary.hpp"
+
+namespace search
+{
+	class Matcher;
+}
+
+namespace db
+{
+	class EventStore;
+
+	// Non-owning view of one event held by an EventStore. It stays valid as
+	// long as the store is not cleared. A view of an event loaded on demand
+	// keeps the small store it was loaded into alive itself.
+	class EventView
+	{
+	public:
+		//(eventFieldName,data)
+		using Item = std::pair<std::string_view, std::string_view>;
+
+		class Items
+		{
+		public:
+			class Iterator
+			{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = Item;
+				using difference_type = std::ptrdiff_t;
+				using pointer = void;
+				using reference = Item;
+
+				Iterator() = default;
+				Iterator(const Items *items, std::size_t position) : m_items(items), m_position(position) {}
+
+				Item operator*() const { return (*m_items)[m_position]; }
+				Iterator &operator++()
+				{
+					++m_position;
+					return *this;
+				}
+				Iterator operator++(int)
+				{
+					auto copy = *this;
+					++m_position;
+					return copy;
+				}
+				bool operator==(const Iterator &other) const { return m_position == other.m_position; }
+
+			private:
+				const Items *m_items{nullptr};
+				std::size_t m_position{0};
+			};
+
+			Items(const EventStore &store, std::size_t row);
+
+			std::size_t size() const;
+			bool empty() const;
+			Item operator[](std::size_t position) const;
+			Item at(std::size_t position) const;
+			Iterator begin() const { return {this, 0}; }
+			Iterator end() const { return {this, m_size}; }
+
+		private:
+			const EventStore *m_store;
+			std::size_t m_row;
+			std::size_t m_size;
+		};
+
+		EventView(const EventStore &store, std::size_t row);
+		EventView(std::shared_ptr<const EventStore> store, std::size_t row);
+
+		int getId() const;
+		SourceId getSource() const;
+		Items getEventItems() const;
+		// empty if the event has no such field
+		std::string_view findByKey(std::string_view key) const;
+		// constant time lookup for names resolved up front with FieldDictionary::Find
+		std::string_view findByKey(FieldId field) const;
+		// position in getEventItems() of the first value the matcher matches
+		std::optional<std::size_t> findInEvent(const search::Matcher &matcher) const;
+
+		bool operator==(const EventView &other) const
+		{
+			return getId() == other.getId();
+		}
+
+		bool operator==(const Event &other) const
+		{
+			return getId() == other.getId();
+		}
+
+	private:
+		const EventStore *m_store;
+		std::size_t m_row;
+		std::shared_ptr<const EventStore> m_owner;
+	};
+
+} // namespace db
+
+#endif // DB_EVENTVIEW_HPP
@@ -0,0 +1,58 @@
+#include "db/events_container.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace db
+{
+  EventView EventsContainer::GetEvent(const int index)
+  {
+    if (!m_source)
+      return this->GetItem(index);
+
+    if (index < 0 || static_cast<std::size_t>(index) >= m_source->Size())
+      throw std::out_of_range("EventsContainer::GetEvent: index " + std::to_string(index) + " out of range");
+    const auto row = static_cast<std::size_t>(index);
+    return EventView(page(row / kLazyPageSize), row % kLazyPageSize);
+  }
+
+  void EventsContainer::OpenLazy(std::unique_ptr<EventSource> source)
+  {
+    m_pages.Clear();
+    m_sources.clear();
+    m_source = std::move(source);
+    // the store stays empty, it only lends its dictionary to the pages
+    m_data.clear();
+    m_currentItem = -1;
+    // the first page brings the fields most events have before the views
+    // resolve their columns
+    if (m_source->Size() > 0)
+      page(0);
+    this->NotifyDataChanged();
+  }
+
+  void EventsContainer::Prefetch(std::size_t first, std::size_t last)
+  {
+    if (!m_source)
+      return;
+    last = std::min(last, m_source->Size());
+    for (std::size_t row = first; row < last; row += kLazyPageSize - row % kLazyPageSize)
+      page(row / kLazyPageSize);
+  }
+
+  const std::shared_ptr<const EventStore> &EventsContainer::page(std::size_t page)
+  {
+    if (auto *found = m_pages.Find(page))
+      return *found;
+
+    auto store = std::make_shared<EventStore>(m_data.SharedFields());
+    const std::size_t first = page * kLazyPageSize;
+    const std::size_t last = std::min(first + kLazyPageSize, m_source->Size());
+    store->reserve(last - first);
+    for (std::size_t row = first; row < last; ++row)
+      store->push_back(m_source->Load(row));
+    return m_pages.Put(page, std::move(store));
+  }
+
+} // namespace db
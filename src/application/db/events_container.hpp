@@ -1,30 +1,123 @@
 #ifndef DB_EVENTSCONTAINER_HPP
 #define DB_EVENTSCONTAINER_HPP
 
+#include <filesystem>
+#include <memory>
 #include <vector>
 #include <ranges>
+#include <utility>
 
 #include "db/event.hpp"
+#include "db/event_cache.hpp"
+#include "db/event_source.hpp"
+#include "db/event_store.hpp"
+#include "db/event_view.hpp"
 #include "mvc/model.hpp"
+#include "util/lru_cache.hpp"
 
 namespace db
 {
 
-	class EventsContainer : public mvc::Model<std::vector<Event>>
+	// Events of the loaded log. They are either stored, as parsed or mapped
+	// from a cache, or loaded on demand from an EventSource: then the full
+	// Size() is known up front and events are parsed in pages of
+	// kLazyPageSize when a view asks for them, the most recent pages are
+	// kept. The pages share one field dictionary with the store, field ids
+	// resolved with GetStore().GetFields() hold for all events.
+	class EventsContainer : public mvc::Model<EventStore>
 	{
 
 	public:
+		static constexpr std::size_t kLazyPageSize = 256;
+		static constexpr std::size_t kLazyPages = 64;
+
 		EventsContainer() {}
 
 		void AddEvent(Event &&event)
 		{
-			this->AddItem(event);
+			this->AddItem(std::move(event));
+		}
+
+		// appends the whole batch and notifies the views once
+		void AddEvents(std::vector<Event> &&events)
+		{
+			this->AddItems(std::move(events));
+		}
+
+		EventView GetEvent(const int index);
+
+		// events of the source, none of them loaded yet
+		void OpenLazy(std::unique_ptr<EventSource> source);
+		bool IsLazy() const
+		{
+			return m_source != nullptr;
 		}
+		// loads the pages of [first, last) ahead of reading them
+		void Prefetch(std::size_t first, std::size_t last);
 
-		const Event &GetEvent(const int index)
+		std::size_t Size()
 		{
-			return this->GetItem(index);
+			return m_source ? m_source->Size() : m_data.size();
 		}
+
+		// Names the logs the SourceId of the events refer to, for events
+		// merged from several of them. Cleared with the events.
+		void SetSources(std::vector<std::filesystem::path> sources)
+		{
+			m_sources = std::move(sources);
+		}
+
+		const std::vector<std::filesystem::path> &GetSources() const
+		{
+			return m_sources;
+		}
+
+		void Clear()
+		{
+			m_sources.clear();
+			m_source.reset();
+			m_pages.Clear();
+			mvc::Model<EventStore>::Clear();
+		}
+
+		const EventStore &GetStore() const
+		{
+			return m_data;
+		}
+
+		// Values of stored events past this many bytes of memory go to a
+		// spill file in the directory, see EventStore::SetMemoryBudget. It
+		// holds for the events loaded from now on, 0 is no budget.
+		void SetMemoryBudget(std::size_t bytes, std::filesystem::path spillDirectory = {})
+		{
+			m_data.SetMemoryBudget(bytes, std::move(spillDirectory));
+		}
+
+		// replaces the events by the cached ones of the log, false on a miss
+		bool OpenCache(const std::filesystem::path &log)
+		{
+			if (!EventCache::Open(m_data, log))
+				return false;
+			m_sources.clear();
+			m_source.reset();
+			m_pages.Clear();
+			m_currentItem = -1;
+			this->NotifyDataChanged();
+			return true;
+		}
+
+		void SaveCache(const std::filesystem::path &log) const
+		{
+			EventCache::Save(m_data, log);
+		}
+
+	private:
+		const std::shared_ptr<const EventStore> &page(std::size_t page);
+
+	private:
+		std::unique_ptr<EventSource> m_source;
+		std::vector<std::filesystem::path> m_sources;
+		util::LruCache<std::size_t, std::shared_ptr<const EventStore>> m_pages{kLazyPages};
 	};
 
 } // namespace db
@@ -0,0 +1,57 @@
+#include "db/field_dictionary.hpp"
+
+#include <mutex>
+#include <stdexcept>
+
+namespace db
+{
+  FieldId FieldDictionary::Intern(std::string_view name)
+  {
+    if (auto found = Find(name))
+      return *found;
+
+    std::unique_lock lock(m_mutex);
+    if (auto found = m_ids.find(name); found != m_ids.end())
+      return found->second;
+    auto id = static_cast<FieldId>(m_names.size());
+    m_names.push_back(std::string(name));
+    m_ids.emplace(m_names[id], id);
+    return id;
+  }
+
+  std::optional<FieldId> FieldDictionary::Find(std::string_view name) const
+  {
+    std::shared_lock lock(m_mutex);
+    if (auto found = m_ids.find(name); found != m_ids.end())
+      return found->second;
+    return std::nullopt;
+  }
+
+  std::string_view FieldDictionary::Name(FieldId id) const
+  {
+    if (id >= m_names.size())
+      throw std::out_of_range("FieldDictionary::Name: no field " + std::to_string(id));
+    return m_names[id];
+  }
+
+  std::size_t FieldDictionary::Size() const
+  {
+    return m_names.size();
+  }
+
+  void FieldDictionary::Clear()
+  {
+    std::unique_lock lock(m_mutex);
+    m_ids.clear();
+    m_names.clear();
+  }
+
+  std::size_t FieldDictionary::MemoryUsage() const
+  {
+    std::size_t total = m_names.size() * sizeof(std::string) + m_ids.size() * (sizeof(std::string_view) + sizeof(FieldId) + 2 * sizeof(void *));
+    for (std::size_t id = 0; id < m_names.size(); ++id)
+      total += m_names[id].capacity();
+    return total;
+  }
+
+} // namespace db
@@ -0,0 +1,44 @@
+#ifndef DB_FIELDDICTIONARY_HPP
+#define DB_FIELDDICTIONARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "util/segmented_vector.hpp"
+
+namespace db
+{
+	using FieldId = uint32_t;
+
+	// Interns field names, every distinct name is stored once and known by
+	// a dense id from then on.
+	//
+	// One thread interns while others look names up: Name and Size never
+	// block, Find takes a shared lock that Intern only holds exclusively
+	// for a name it has not seen.
+	class FieldDictionary
+	{
+	public:
+		FieldId Intern(std::string_view name);
+		std::optional<FieldId> Find(std::string_view name) const;
+		std::string_view Name(FieldId id) const;
+		std::size_t Size() const;
+
+		void Clear();
+		std::size_t MemoryUsage() const;
+
+	private:
+		// names stay in place, the map keys point into them
+		util::SegmentedVector<std::string> m_names;
+		std::unordered_map<std::string_view, FieldId> m_ids;
+		mutable std::shared_mutex m_mutex;
+	};
+
+} // namespace db
+
+#endif // DB_FIELDDICTIONARY_HPP
@@ -0,0 +1,169 @@
+#include "db/string_arena.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace db
+{
+  namespace
+  {
+    std::size_t varintSize(std::size_t value)
+    {
+      std::size_t size = 1;
+      while (value >= 0x80)
+      {
+        value >>= 7;
+        ++size;
+      }
+      return size;
+    }
+  } // namespace
+
+  StringRef StringArena::Store(std::string_view value)
+  {
+    return store(value, m_current, true);
+  }
+
+  StringRef StringArena::StoreResident(std::string_view value)
+  {
+    if (!m_spill)
+      return store(value, m_current, false);
+    return store(value, m_currentResident, false);
+  }
+
+  StringRef StringArena::store(std::string_view value, std::size_t &current, bool spill)
+  {
+    const std::size_t needed = varintSize(value.size()) + value.size();
+    const bool own = needed > kChunkSize / 4;
+
+    std::size_t index = current;
+    if (own)
+    {
+      index = newChunk(needed, spill);
+    }
+    else if (index == SIZE_MAX || m_chunks[index].capacity - m_chunks[index].used < needed)
+    {
+      if (index != SIZE_MAX)
+        seal(index);
+      index = current = newChunk(std::max(m_nextChunkSize, needed), spill);
+      m_nextChunkSize = std::min(2 * m_nextChunkSize, kChunkSize);
+    }
+
+    auto &chunk = m_chunks[index];
+    StringRef ref{static_cast<uint32_t>(index), static_cast<uint32_t>(chunk.used)};
+
+    char *out = chunk.data + chunk.used;
+    std::size_t length = value.size();
+    while (length >= 0x80)
+    {
+      *out++ = static_cast<char>(length | 0x80);
+      length >>= 7;
+    }
+    *out++ = static_cast<char>(length);
+    if (!value.empty())
+      std::memcpy(out, value.data(), value.size());
+
+    chunk.used += needed;
+    if (own)
+      seal(index);
+    return ref;
+  }
+
+  std::size_t StringArena::newChunk(std::size_t capacity, bool spill)
+  {
+    Chunk chunk;
+    chunk.capacity = capacity;
+    if (spill && m_spill)
+      chunk.data = m_spill->Allocate(capacity);
+    if (chunk.data == nullptr)
+    {
+      chunk.owned = std::make_unique<char[]>(capacity);
+      chunk.data = chunk.owned.get();
+    }
+    m_chunks.push_back(std::move(chunk));
+    return m_chunks.size() - 1;
+  }
+
+  void StringArena::seal(std::size_t chunk)
+  {
+    const auto &sealed = m_chunks[chunk];
+    if (!sealed.owned)
+      m_spill->Release(sealed.data, sealed.used);
+  }
+
+  std::string_view StringArena::Get(StringRef ref) const
+  {
+    if (ref.IsNull())
+      return {};
+    return Read(m_chunks[ref.chunk].data + ref.offset);
+  }
+
+  std::string_view StringArena::Read(const char *in)
+  {
+    std::size_t length = 0;
+    int shift = 0;
+    while (true)
+    {
+      auto byte = static_cast<unsigned char>(*in++);
+      length |= static_cast<std::size_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        break;
+      shift += 7;
+    }
+    return {in, length};
+  }
+
+  std::size_t StringArena::ChunkCount() const
+  {
+    return m_chunks.size();
+  }
+
+  std::string_view StringArena::ChunkData(std::size_t chunk) const
+  {
+    if (chunk >= m_chunks.size())
+      throw std::out_of_range("StringArena::ChunkData: no chunk " + std::to_string(chunk));
+    const auto &stored = m_chunks[chunk];
+    return {stored.data, stored.used};
+  }
+
+  void StringArena::SetSpillFile(std::unique_ptr<util::SpillFile> file)
+  {
+    // the chunks of the old file are still read
+    if (m_spill)
+      throw std::logic_error("StringArena::SetSpillFile: the arena spills already");
+    m_spill = std::move(file);
+  }
+
+  bool StringArena::IsSpilling() const
+  {
+    return m_spill != nullptr;
+  }
+
+  std::size_t StringArena::SpilledSize() const
+  {
+    return m_spill ? m_spill->Size() : 0;
+  }
+
+  void StringArena::Clear()
+  {
+    m_chunks.clear();
+    m_current = SIZE_MAX;
+    m_currentResident = SIZE_MAX;
+    m_nextChunkSize = kFirstChunkSize;
+    m_spill.reset();
+  }
+
+  std::size_t StringArena::MemoryUsage() const
+  {
+    std::size_t total = m_chunks.capacity() * sizeof(Chunk);
+    for (std::size_t chunk = 0; chunk < m_chunks.size(); ++chunk)
+    {
+      if (m_chunks[chunk].owned)
+        total += m_chunks[chunk].capacity;
+    }
+    return total;
+  }
+
+} // namespace db
@@ -0,0 +1,96 @@
+#ifndef DB_STRINGARENA_HPP
+#define DB_STRINGARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "util/segmented_vector.hpp"
+#include "util/spill_file.hpp"
+
+namespace db
+{
+	// Position of a string stored in a StringArena.
+	struct StringRef
+	{
+		uint32_t chunk{UINT32_MAX};
+		uint32_t offset{0};
+
+		bool IsNull() const
+		{
+			return chunk == UINT32_MAX;
+		}
+
+		bool operator==(const StringRef &other) const = default;
+	};
+
+	// Append-only string storage. Strings are packed into large chunks with a
+	// varint length prefix, so storing one costs no allocation of its own and
+	// a reference to it is 8 bytes. Chunks never move. They start small and
+	// double up to kChunkSize, a store of a few hundred events stays small.
+	// Get may be called from other threads while one thread stores strings.
+	//
+	// Once the arena has a spill file, new chunks are cut from the file and
+	// written out and dropped from memory as soon as they are full; their
+	// strings are paged back in when they are read. Chunks still never move,
+	// so readers are not affected. Chunks the file has no room for are kept
+	// in memory.
+	class StringArena
+	{
+	public:
+		static constexpr std::size_t kChunkSize = 1 << 20;
+		static constexpr std::size_t kFirstChunkSize = 64 << 10;
+
+		StringRef Store(std::string_view value);
+		// stores in a chunk that stays in memory while the arena spills, for
+		// strings that are looked up all the time
+		StringRef StoreResident(std::string_view value);
+		std::string_view Get(StringRef ref) const;
+		// string stored at `at`, in the layout Store writes
+		static std::string_view Read(const char *at);
+
+		std::size_t ChunkCount() const;
+		// the used bytes of a chunk
+		std::string_view ChunkData(std::size_t chunk) const;
+
+		// Chunks started from now on go to the file, which the arena keeps
+		// until Clear. Throws std::logic_error if it has one already.
+		void SetSpillFile(std::unique_ptr<util::SpillFile> file);
+		bool IsSpilling() const;
+		// bytes of the chunks in the spill file
+		std::size_t SpilledSize() const;
+
+		// drops the spill file too
+		void Clear();
+		// chunks in memory, spilled ones are not counted
+		std::size_t MemoryUsage() const;
+
+	private:
+		struct Chunk
+		{
+			// null for a chunk of the spill file
+			std::unique_ptr<char[]> owned;
+			char *data{nullptr};
+			std::size_t capacity{0};
+			std::size_t used{0};
+		};
+
+		StringRef store(std::string_view value, std::size_t &current, bool spill);
+		std::size_t newChunk(std::size_t capacity, bool spill);
+		// writes a full chunk of the spill file out
+		void seal(std::size_t chunk);
+
+	private:
+		util::SegmentedVector<Chunk> m_chunks;
+		// chunks small strings are appended to, large strings get chunks of
+		// their own; the resident one is only used while spilling
+		std::size_t m_current{SIZE_MAX};
+		std::size_t m_currentResident{SIZE_MAX};
+		std::size_t m_nextChunkSize{kFirstChunkSize};
+		std::unique_ptr<util::SpillFile> m_spill;
+	};
+
+} // namespace db
+
+#endif // DB_STRINGARENA_HPP
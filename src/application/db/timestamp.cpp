@@ -0,0 +1,177 @@
+#include "db/timestamp.hpp"
+
+#include <cstdio>
+
+namespace db
+{
+  namespace
+  {
+    constexpr int64_t kMicrosPerSecond = 1000000;
+    constexpr int64_t kSecondsPerDay = 86400;
+
+    // days since 1970-01-01 of a date of the proleptic Gregorian calendar
+    int64_t daysFromCivil(int64_t year, unsigned month, unsigned day)
+    {
+      year -= month <= 2;
+      const int64_t era = (year >= 0 ? year : year - 399) / 400;
+      const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+      const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+      const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+      return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+    }
+
+    void civilFromDays(int64_t days, int64_t &year, unsigned &month, unsigned &day)
+    {
+      days += 719468;
+      const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+      const auto dayOfEra = static_cast<unsigned>(days - era * 146097);
+      const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+      const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+      const unsigned shifted = (5 * dayOfYear + 2) / 153;
+      day = dayOfYear - (153 * shifted + 2) / 5 + 1;
+      month = shifted < 10 ? shifted + 3 : shifted - 9;
+      year = static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2);
+    }
+
+    class Reader
+    {
+    public:
+      explicit Reader(std::string_view text) : m_text(text) {}
+
+      // exactly `count` digits
+      bool Digits(std::size_t count, unsigned &value)
+      {
+        if (m_position + count > m_text.size())
+          return false;
+        value = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          const char c = m_text[m_position + i];
+          if (c < '0' || c > '9')
+            return false;
+          value = value * 10 + static_cast<unsigned>(c - '0');
+        }
+        m_position += count;
+        return true;
+      }
+
+      bool Take(char c)
+      {
+        if (m_position < m_text.size() && m_text[m_position] == c)
+        {
+          ++m_position;
+          return true;
+        }
+        return false;
+      }
+
+      bool TakeAny(char a, char b)
+      {
+        return Take(a) || Take(b);
+      }
+
+      char Peek() const
+      {
+        return m_position < m_text.size() ? m_text[m_position] : '\0';
+      }
+
+      bool AtEnd() const
+      {
+        return m_position == m_text.size();
+      }
+
+    private:
+      std::string_view m_text;
+      std::size_t m_position{0};
+    };
+  } // namespace
+
+  std::optional<Timestamp> ParseTimestamp(std::string_view text)
+  {
+    Reader in(text);
+    unsigned year, month, day;
+    if (!in.Digits(4, year) || !in.Take('-') || !in.Digits(2, month) || !in.Take('-') || !in.Digits(2, day))
+      return std::nullopt;
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+      return std::nullopt;
+
+    int64_t seconds = 0;
+    int64_t micros = 0;
+    if (in.TakeAny(' ', 'T'))
+    {
+      unsigned hour, minute, second = 0;
+      if (!in.Digits(2, hour) || !in.Take(':') || !in.Digits(2, minute))
+        return std::nullopt;
+      if (in.Take(':') && !in.Digits(2, second))
+        return std::nullopt;
+      if (hour > 23 || minute > 59 || second > 60)
+        return std::nullopt;
+      seconds = hour * 3600 + minute * 60 + second;
+
+      if (in.TakeAny('.', ','))
+      {
+        int64_t scale = kMicrosPerSecond;
+        unsigned digit;
+        bool any = false;
+        while (in.Digits(1, digit))
+        {
+          any = true;
+          if (scale > 1)
+          {
+            scale /= 10;
+            micros += digit * scale;
+          }
+        }
+        if (!any)
+          return std::nullopt;
+      }
+
+      if (!in.Take('Z') && (in.Peek() == '+' || in.Peek() == '-'))
+      {
+        const int64_t sign = in.Take('-') ? -1 : 1;
+        in.Take('+');
+        unsigned offsetHour, offsetMinute = 0;
+        if (!in.Digits(2, offsetHour))
+          return std::nullopt;
+        // "+HH", "+HHMM" or "+HH:MM"
+        if (in.Take(':') && !in.Digits(2, offsetMinute))
+          return std::nullopt;
+        if (!in.AtEnd() && !in.Digits(2, offsetMinute))
+          return std::nullopt;
+        seconds -= sign * (offsetHour * 3600 + offsetMinute * 60);
+      }
+    }
+    if (!in.AtEnd())
+      return std::nullopt;
+
+    return (daysFromCivil(year, month, day) * kSecondsPerDay + seconds) * kMicrosPerSecond + micros;
+  }
+
+  std::string FormatTimestamp(Timestamp timestamp)
+  {
+    int64_t seconds = timestamp / kMicrosPerSecond;
+    int64_t micros = timestamp % kMicrosPerSecond;
+    if (micros < 0)
+    {
+      micros += kMicrosPerSecond;
+      --seconds;
+    }
+    int64_t days = seconds / kSecondsPerDay;
+    int64_t rest = seconds % kSecondsPerDay;
+    if (rest < 0)
+    {
+      rest += kSecondsPerDay;
+      --days;
+    }
+
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    char text[40];
+    std::snprintf(text, sizeof(text), "%04lld-%02u-%02u %02lld:%02lld:%02lld.%06lld", static_cast<long long>(year), month, day,
+                  static_cast<long long>(rest / 3600), static_cast<long long>(rest / 60 % 60), static_cast<long long>(rest % 60),
+                  static_cast<long long>(micros));
+    return text;
+  }
+
+} // namespace db
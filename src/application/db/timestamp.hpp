@@ -0,0 +1,25 @@
+#ifndef DB_TIMESTAMP_HPP
+#define DB_TIMESTAMP_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace db
+{
+	// Point in time as microseconds since the Unix epoch, UTC.
+	using Timestamp = int64_t;
+
+	// Parses "YYYY-MM-DD", optionally followed by ' ' or 'T' and
+	// "HH:MM[:SS[.fraction]]" and a 'Z' or "+HH:MM" / "-HH:MM" zone offset.
+	// Times without a zone are taken as UTC. Digits past microseconds are
+	// dropped. None if the text is not such a timestamp.
+	std::optional<Timestamp> ParseTimestamp(std::string_view text);
+
+	// "YYYY-MM-DD HH:MM:SS.ffffff" in UTC
+	std::string FormatTimestamp(Timestamp timestamp);
+
+} // namespace db
+
+#endif // DB_TIMESTAMP_HPP
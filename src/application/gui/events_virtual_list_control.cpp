@@ -1,64 +1,428 @@
 #include "gui/events_virtual_list_control.hpp"
 
+#include <algorithm>
+#include <ranges>
 #include <string>
 
 namespace gui
 {
+  namespace
+  {
+    uint64_t cellKey(long index, long column)
+    {
+      return (static_cast<uint64_t>(index) << 8) | static_cast<uint64_t>(column & 0xFF);
+    }
+  } // namespace
+
   EventsVirtualListControl::EventsVirtualListControl(db::EventsContainer &events, wxWindow *parent,
                                                      const wxWindowID id, const wxPoint &pos, const wxSize &size)
-      : m_events(events), wxListCtrl(parent, id, pos, size, wxLC_REPORT | wxLC_VIRTUAL)
+      : m_events(events), wxListCtrl(parent, id, pos, size, wxLC_REPORT | wxLC_VIRTUAL), m_filter(events.GetStore()),
+        m_timeOrder(events.GetStore())
   {
 
     this->AppendColumn("id");
-    this->AppendColumn("timestamp");
-    this->AppendColumn("type");
-    this->AppendColumn("info");
-    this->AppendColumn("dummy");
+    this->appendFieldColumn("timestamp");
+    this->appendFieldColumn("type");
+    this->appendFieldColumn("info");
+    this->appendFieldColumn("dummy");
 
     m_events.RegisterOndDataUpdated(this);
 
     this->Bind(wxEVT_LIST_ITEM_SELECTED, [this](wxListEvent &evt)
-               { this->m_events.SetCurrentItem(evt.GetIndex()); });
+               { this->m_events.SetCurrentItem(this->eventIndex(evt.GetIndex())); });
+    this->Bind(wxEVT_LIST_CACHE_HINT, &EventsVirtualListControl::OnCacheHint, this);
+    this->Bind(wxEVT_LIST_COL_CLICK, &EventsVirtualListControl::OnColumnClick, this);
   }
 
   void EventsVirtualListControl::OnDataUpdated()
   {
 
-    auto s = m_events.Size();
+    // the field dictionary may have been rebuilt from scratch
+    m_cellCache.Clear();
+    this->updateSourceColumn();
+    this->resolveColumns(true);
+    m_filter.Reapply();
+    // the cached orders are of other rows and maybe other field ids
+    m_columnOrders.Clear();
+    m_columnOrder = nullptr;
+    if ((m_timeOrdered || m_orderColumn) && m_events.IsLazy())
+    {
+      // a log opened on demand is shown as read
+      m_timeOrdered = false;
+      m_timeOrder.Clear();
+      m_orderColumn.reset();
+    }
+    if (m_timeOrdered)
+      this->orderByTime();
+    if (m_orderColumn)
+      this->orderByColumn();
+    auto s = this->GetShownCount();
 
     this->SetItemCount(s);
-    this->RefreshItem(s - 1);
-    this->Update();
+    if (s > 0)
+      this->RefreshItem(s - 1);
+  }
+
+  void EventsVirtualListControl::OnDataAppended(std::size_t first, std::size_t last)
+  {
+    this->resolveColumns(false);
+    const long before = this->GetItemCount();
+    long top = this->GetTopItem();
+    const bool atBottom = m_followTail && (before == 0 || top + this->GetCountPerPage() >= before);
+
+    // only the new events are filtered and ordered, the rows they add start
+    // at the old count unless they are older than the events shown
+    const std::size_t filtered = m_filter.Size();
+    m_filter.Append(last);
+    bool shifted = false;
+    if (m_timeOrdered)
+    {
+      shifted = m_filter.IsActive() ? !m_timeOrder.Add(std::span<const uint32_t>(m_filter.GetRows()).subspan(filtered))
+                                    : !m_timeOrder.Add(first);
+    }
+    else if (m_orderColumn)
+    {
+      // the column may just have got its field, all rows are ordered then
+      const bool unordered = m_columnOrder == nullptr;
+      shifted = !this->orderByColumn() || (unordered && m_columnOrder != nullptr);
+    }
+    const long shown = static_cast<long>(this->GetShownCount());
+    if (m_filter.IsActive() || m_timeOrdered || m_columnOrder)
+    {
+      first = static_cast<std::size_t>(before);
+      last = static_cast<std::size_t>(shown);
+      if (first == last)
+        return;
+    }
+    if (shifted)
+    {
+      // rows already shown moved down
+      m_cellCache.Clear();
+      first = 0;
+    }
+    this->SetItemCount(shown);
+
+    if (atBottom)
+    {
+      this->EnsureVisible(shown - 1);
+      top = this->GetTopItem();
+    }
+
+    // only repaint when the appended rows are on screen
+    long bottom = top + this->GetCountPerPage();
+    if (static_cast<long>(first) <= bottom && static_cast<long>(last) > top)
+    {
+      this->RefreshItems(std::max<long>(first, top), std::min<long>(last - 1, bottom));
+    }
+  }
+
+  void EventsVirtualListControl::appendFieldColumn(const std::string &name)
+  {
+    m_cellCache.Clear();
+    this->AppendColumn(wxString::FromUTF8(name.data(), name.size()));
+    m_columnNames.resize(this->GetColumnCount());
+    m_columnFields.resize(this->GetColumnCount());
+    m_columnNames.back() = name;
   }
 
-  const wxString EventsVirtualListControl::getColumnName(const int column) const
+  void EventsVirtualListControl::updateSourceColumn()
   {
-    wxListItem item;
-    item.SetMask(wxLIST_MASK_TEXT);
-    this->GetColumn(column, item);
-    return item.GetText();
+    const bool merged = m_events.GetSources().size() > 1;
+    if (merged == (m_sourceColumn >= 0))
+      return;
+
+    m_cellCache.Clear();
+    if (merged)
+    {
+      this->AppendColumn("source");
+      m_sourceColumn = this->GetColumnCount() - 1;
+      m_columnNames.resize(this->GetColumnCount());
+      m_columnFields.resize(this->GetColumnCount());
+      return;
+    }
+    this->DeleteColumn(m_sourceColumn);
+    m_columnNames.erase(m_columnNames.begin() + m_sourceColumn);
+    m_columnFields.erase(m_columnFields.begin() + m_sourceColumn);
+    m_sourceColumn = -1;
+  }
+
+  bool EventsVirtualListControl::resolveColumns(const bool reset)
+  {
+    const auto &fields = m_events.GetStore().GetFields();
+    if (!reset && fields.Size() == m_resolvedFieldCount)
+      return false;
+
+    bool resolved = false;
+    for (std::size_t column = 0; column < m_columnNames.size(); ++column)
+    {
+      if (reset || !m_columnFields[column])
+      {
+        m_columnFields[column] = m_columnNames[column].empty() ? std::nullopt : fields.Find(m_columnNames[column]);
+        resolved = resolved || m_columnFields[column].has_value();
+      }
+    }
+    m_resolvedFieldCount = fields.Size();
+    return resolved;
+  }
+
+  void EventsVirtualListControl::OnCacheHint(wxListEvent &event)
+  {
+    // one page above and below, so scrolling a row or a page finds them ready
+    const long count = static_cast<long>(this->GetShownCount());
+    const long margin = std::max(this->GetCountPerPage(), 1);
+    const long from = std::max<long>(event.GetCacheFrom() - margin, 0);
+    const long to = std::min<long>(event.GetCacheTo() + margin, count - 1);
+    if (from > to)
+      return;
+
+    // events loaded on demand may bring fields no column has seen yet, the
+    // cells cached without them are stale
+    m_events.Prefetch(this->eventIndex(from), this->eventIndex(to) + 1);
+    if (this->resolveColumns(false))
+      m_cellCache.Clear();
+    for (long index = from; index <= to; ++index)
+      for (long column = 0; column < static_cast<long>(m_columnNames.size()); ++column)
+        if (!m_cellCache.Contains(cellKey(index, column)))
+          m_cellCache.Put(cellKey(index, column), formatCell(index, column));
   }
 
   wxString EventsVirtualListControl::OnGetItemText(long index, long column) const
   {
+    LOGVIEWER_PROFILE_SCOPE("EventsList::OnGetItemText");
+    const auto key = cellKey(index, column);
+    if (const auto *cached = m_cellCache.Find(key))
+      return *cached;
+    return m_cellCache.Put(key, formatCell(index, column));
+  }
+
+  wxString EventsVirtualListControl::formatCell(long row, long column) const
+  {
+    const long index = this->eventIndex(row);
+    if (column == m_sourceColumn)
+    {
+      const auto &sources = m_events.GetSources();
+      const auto source = m_events.GetEvent(index).getSource();
+      return source < sources.size() ? wxString(sources[source].filename().wstring()) : wxString();
+    }
     switch (column)
     {
     case 0:
       return std::to_string(m_events.GetEvent(index).getId());
     default:
-      return m_events.GetEvent(index).findByKey(getColumnName(column).ToStdString());
+    {
+      auto field = m_columnFields[column];
+      if (!field)
+        return wxEmptyString;
+      auto value = m_events.GetEvent(index).findByKey(*field);
+      return wxString::FromUTF8(value.data(), value.size());
+    }
     }
   }
 
   void EventsVirtualListControl::RefreshAfterUpdate()
   {
-    this->SetItemCount(m_events.Size());
+    this->SetItemCount(this->GetShownCount());
     this->Refresh();
-    this->Update();
+  }
+
+  void EventsVirtualListControl::SetFilter(search::EventFilter filter)
+  {
+    if (filter.Empty())
+      m_filter.Clear();
+    else
+      m_filter.Apply(std::move(filter));
+    m_columnOrders.Clear();
+    m_columnOrder = nullptr;
+    if (m_timeOrdered)
+      this->orderByTime();
+    if (m_orderColumn)
+      this->orderByColumn();
+    // cells are cached by row, the rows show other events now
+    m_cellCache.Clear();
+    this->RefreshAfterUpdate();
+    this->OnCurrentIndexUpdated(m_events.GetCurrentItemIndex());
+  }
+
+  std::size_t EventsVirtualListControl::GetShownCount() const
+  {
+    return m_filter.IsActive() ? m_filter.Size() : m_events.Size();
+  }
+
+  void EventsVirtualListControl::SetTimeOrder(bool ordered)
+  {
+    // events loaded on demand are not in the store and cannot be ordered
+    if (ordered == m_timeOrdered || (ordered && m_events.IsLazy()))
+      return;
+    m_timeOrdered = ordered;
+    if (ordered)
+    {
+      m_orderColumn.reset();
+      m_columnOrder = nullptr;
+      this->orderByTime();
+    }
+    else
+    {
+      m_timeOrder.Clear();
+    }
+    m_cellCache.Clear();
+    this->RefreshAfterUpdate();
+    this->OnCurrentIndexUpdated(m_events.GetCurrentItemIndex());
+  }
+
+  bool EventsVirtualListControl::IsTimeOrdered() const
+  {
+    return m_timeOrdered;
+  }
+
+  void EventsVirtualListControl::SetColumnOrder(std::optional<long> column)
+  {
+    if (column == m_orderColumn || (column && m_events.IsLazy()))
+      return;
+    if (column && (*column < 0 || static_cast<std::size_t>(*column) >= m_columnNames.size() ||
+                   m_columnNames[*column].empty()))
+      return;
+    m_orderColumn = column;
+    m_columnOrder = nullptr;
+    if (column)
+    {
+      m_timeOrdered = false;
+      m_timeOrder.Clear();
+      this->orderByColumn();
+    }
+    m_cellCache.Clear();
+    this->RefreshAfterUpdate();
+    this->OnCurrentIndexUpdated(m_events.GetCurrentItemIndex());
+  }
+
+  std::optional<long> EventsVirtualListControl::GetOrderColumn() const
+  {
+    return m_orderColumn;
+  }
+
+  bool EventsVirtualListControl::GoToTime(db::Timestamp time)
+  {
+    const auto &store = m_events.GetStore();
+    std::size_t row;
+    if (m_timeOrdered)
+    {
+      row = m_timeOrder.LowerBound(time);
+    }
+    else if (!m_columnOrder && store.IsTimeSorted() && !m_events.IsLazy())
+    {
+      const auto times = store.GetTimes();
+      if (m_filter.IsActive())
+      {
+        const auto &rows = m_filter.GetRows();
+        row = static_cast<std::size_t>(std::ranges::lower_bound(rows, time, {}, [times](uint32_t r)
+                                                                { return times[r]; }) -
+                                       rows.begin());
+      }
+      else
+      {
+        row = *std::ranges::partition_point(std::views::iota(std::size_t(0), times.size()), [&](std::size_t r)
+                                            { return times[r] < time; });
+      }
+    }
+    else
+    {
+      return false;
+    }
+
+    const auto shown = this->GetShownCount();
+    if (shown == 0)
+      return true;
+    const long selected = static_cast<long>(std::min(row, shown - 1));
+    this->SetItemState(selected, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED, wxLIST_STATE_SELECTED | wxLIST_STATE_FOCUSED);
+    this->EnsureVisible(selected);
+    return true;
+  }
+
+  void EventsVirtualListControl::orderByTime()
+  {
+    if (m_filter.IsActive())
+      m_timeOrder.Assign(m_filter.GetRows());
+    else
+      m_timeOrder.Assign();
+  }
+
+  bool EventsVirtualListControl::orderByColumn()
+  {
+    m_columnOrder = nullptr;
+    const auto field = m_columnFields[*m_orderColumn];
+    if (!field)
+      return true;
+    if (auto *cached = m_columnOrders.Find(*field))
+    {
+      m_columnOrder = cached->get();
+      const auto ordered = m_columnOrder->Size();
+      return m_filter.IsActive() ? m_columnOrder->Add(std::span<const uint32_t>(m_filter.GetRows()).subspan(ordered))
+                                 : m_columnOrder->Add(ordered);
+    }
+    m_columnOrder = m_columnOrders.Put(*field, std::make_unique<search::ColumnOrder>(m_events.GetStore(), *field)).get();
+    if (m_filter.IsActive())
+      m_columnOrder->Assign(m_filter.GetRows());
+    else
+      m_columnOrder->Assign();
+    return true;
+  }
+
+  void EventsVirtualListControl::OnColumnClick(wxListEvent &event)
+  {
+    const long column = event.GetColumn();
+    if (column < 0 || static_cast<std::size_t>(column) >= m_columnNames.size())
+      return;
+    if (m_columnNames[column] == db::EventStore::kTimeField)
+    {
+      this->SetTimeOrder(!m_timeOrdered);
+    }
+    else if (!m_columnNames[column].empty())
+    {
+      this->SetColumnOrder(m_orderColumn == column ? std::nullopt : std::optional<long>(column));
+    }
+    else if (column == 0)
+    {
+      // the id column shows the events as read
+      this->SetTimeOrder(false);
+      this->SetColumnOrder(std::nullopt);
+    }
+  }
+
+  long EventsVirtualListControl::eventIndex(long row) const
+  {
+    if (m_timeOrdered)
+      return static_cast<long>(m_timeOrder.Row(static_cast<std::size_t>(row)));
+    if (m_columnOrder)
+      return static_cast<long>(m_columnOrder->Row(static_cast<std::size_t>(row)));
+    return m_filter.IsActive() ? static_cast<long>(m_filter.Row(static_cast<std::size_t>(row))) : row;
+  }
+
+  std::optional<long> EventsVirtualListControl::shownRow(std::size_t index) const
+  {
+    std::optional<std::size_t> row = index;
+    if (m_timeOrdered)
+      row = m_timeOrder.Position(index);
+    else if (m_columnOrder)
+      row = m_columnOrder->Position(index);
+    else if (m_filter.IsActive())
+      row = m_filter.Position(index);
+    if (!row)
+      return std::nullopt;
+    return static_cast<long>(*row);
+  }
+
+  void EventsVirtualListControl::SetFollowTail(bool follow)
+  {
+    m_followTail = follow;
   }
 
   void EventsVirtualListControl::OnCurrentIndexUpdated(const int index)
   {
-    // do nothing
+    // follow events picked in the other views, e.g. search results, as long
+    // as the filter shows them
+    if (index < 0)
+      return;
+    auto row = this->shownRow(static_cast<std::size_t>(index));
+    if (row && *row < this->GetItemCount())
+      this->EnsureVisible(*row);
   }
 } // namespace gui
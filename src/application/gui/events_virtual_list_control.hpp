@@ -6,6 +6,19 @@
 
 #include "mvc/view.hpp"
 #include "db/events_container.hpp"
+#include "db/field_dictionary.hpp"
+#include "db/timestamp.hpp"
+#include "search/column_order.hpp"
+#include "search/event_filter.hpp"
+#include "search/filter_view.hpp"
+#include "search/time_order.hpp"
+#include "util/lru_cache.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace gui
 {
@@ -17,16 +30,78 @@ namespace gui
 
 		virtual wxString OnGetItemText(long index, long column) const wxOVERRIDE;
 		void RefreshAfterUpdate();
+		// keeps the last event in view as events are appended, as long as the
+		// user has not scrolled away from it
+		void SetFollowTail(bool follow);
+		// shows only the events passing the filter, an empty filter shows all
+		void SetFilter(search::EventFilter filter);
+		// events shown, all of them without a filter
+		std::size_t GetShownCount() const;
+		// shows the events in the order of their timestamps rather than as
+		// they were read, also toggled by a click on the timestamp header
+		void SetTimeOrder(bool ordered);
+		bool IsTimeOrdered() const;
+		// Shows the events in the order of the values of a field column,
+		// ties as they were read, none to show them as read. A click on the
+		// header of the column toggles it.
+		void SetColumnOrder(std::optional<long> column);
+		std::optional<long> GetOrderColumn() const;
+		// Selects the first shown event at or after the time, the last one
+		// if there is none. False if the shown events are not in time order,
+		// so there is nothing to search.
+		bool GoToTime(db::Timestamp time);
 
 		// implement View interface
 		virtual void OnDataUpdated() override;
 		virtual void OnCurrentIndexUpdated(const int index) override;
+		virtual void OnDataAppended(const std::size_t first, const std::size_t last) override;
 
 	private:
-		const wxString getColumnName(const int column) const;
+		void appendFieldColumn(const std::string &name);
+		// the file of each event, shown while several logs are merged
+		void updateSourceColumn();
+		// maps column headers to field ids so a cell is a single column lookup,
+		// true if a column got a field it did not have
+		bool resolveColumns(const bool reset);
+		wxString formatCell(long index, long column) const;
+		// event shown in a row of the list and the row showing an event
+		long eventIndex(long row) const;
+		std::optional<long> shownRow(std::size_t index) const;
+		// orders the events the filter passes, all without one
+		void orderByTime();
+		// Orders them by the column, from its cached order where there is
+		// one, which only has to take the rows shown since it was used.
+		// False if rows already ordered moved.
+		bool orderByColumn();
+		void OnColumnClick(wxListEvent &event);
+		// fills the cache for the rows around the range about to be painted
+		void OnCacheHint(wxListEvent &event);
 
 	private:
 		db::EventsContainer &m_events;
+		// header name and resolved field id of every column, empty for "id"
+		// and "source"
+		std::vector<std::string> m_columnNames;
+		std::vector<std::optional<db::FieldId>> m_columnFields;
+		long m_sourceColumn{-1};
+		std::size_t m_resolvedFieldCount{0};
+		bool m_followTail{false};
+		search::FilterView m_filter;
+		search::TimeOrder m_timeOrder;
+		bool m_timeOrdered{false};
+		// column the events are ordered by and its order, null while the
+		// column has no field
+		std::optional<long> m_orderColumn;
+		search::ColumnOrder *m_columnOrder{nullptr};
+		// Orders of the columns used last, 4 bytes per shown event each,
+		// kept so switching back to a column is instant. They are of the
+		// rows the filter passes and dropped with it.
+		static constexpr std::size_t kCachedOrders = 4;
+		util::LruCache<db::FieldId, std::unique_ptr<search::ColumnOrder>> m_columnOrders{kCachedOrders};
+		// formatted cells keyed by row and column. It holds a few screens so
+		// scrolling back and forth does not format the same cells again.
+		static constexpr std::size_t kCachedCells = 32768;
+		mutable util::LruCache<uint64_t, wxString> m_cellCache{kCachedCells};
 	};
 
 } // namespace gui
@@ -13,7 +13,8 @@ namespace gui
     this->AppendColumn("param");
     this->AppendColumn("value");
 
-    m_events.RegisterOndDataUpdated(this);
+    // the detail pane shows one event, appended ones never change it
+    m_events.RegisterOndDataUpdated(this, mvc::Change::Data | mvc::Change::CurrentIndex);
   }
 
   void ItemVirtualListControl::OnDataUpdated()
@@ -23,11 +24,20 @@ namespace gui
 
   void ItemVirtualListControl::OnCurrentIndexUpdated(const int index)
   {
+    selectEvent(index);
+    this->Refresh();
+  }
+
+  void ItemVirtualListControl::selectEvent(const int index)
+  {
+    if (index < 0 || index >= static_cast<int>(m_events.Size()))
+      m_current.reset();
+    else
+      m_current = m_events.GetEvent(index);
 
-    auto s = m_events.GetEvent(m_events.GetCurrentItemIndex()).getEventItems().size();
-    this->SetItemCount(s);
-    this->RefreshItem(s - 1);
-    this->Update();
+    // rows are only converted to wxString once they are on screen
+    m_rows.assign(m_current ? m_current->getEventItems().size() : 0, Row());
+    this->SetItemCount(m_rows.size());
   }
 
   const wxString ItemVirtualListControl::getColumnName(const int column) const
@@ -40,15 +50,25 @@ namespace gui
 
   wxString ItemVirtualListControl::OnGetItemText(long index, long column) const
   {
+    LOGVIEWER_PROFILE_SCOPE("ItemList::OnGetItemText");
+    if (!m_current || index < 0 || static_cast<std::size_t>(index) >= m_rows.size())
+      return wxEmptyString;
 
-    auto items = m_events.GetEvent(m_events.GetCurrentItemIndex()).getEventItems();
+    auto &row = m_rows[index];
+    if (!row.ready)
+    {
+      auto [name, value] = m_current->getEventItems()[index];
+      row.name = wxString::FromUTF8(name.data(), name.size());
+      row.value = wxString::FromUTF8(value.data(), value.size());
+      row.ready = true;
+    }
 
     switch (column)
     {
     case 0:
-      return items[index].first;
+      return row.name;
     case 1:
-      return items.at(index).second;
+      return row.value;
     default:
       return "";
     }
@@ -56,8 +76,8 @@ namespace gui
 
   void ItemVirtualListControl::RefreshAfterUpdate()
   {
-    this->SetItemCount(m_events.GetEvent(m_events.GetCurrentItemIndex()).getEventItems().size());
+    // the store may have been cleared, the cached view is no longer valid
+    selectEvent(m_events.GetCurrentItemIndex());
     this->Refresh();
-    this->Update();
   }
 } // namespace gui
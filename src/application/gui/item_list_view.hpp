@@ -6,6 +6,10 @@
 
 #include "mvc/view.hpp"
 #include "db/events_container.hpp"
+#include "db/event_view.hpp"
+
+#include <optional>
+#include <vector>
 
 namespace gui
 {
@@ -23,10 +27,21 @@ namespace gui
 		virtual void OnCurrentIndexUpdated(const int index) override;
 
 	private:
+		struct Row
+		{
+			wxString name;
+			wxString value;
+			bool ready{false};
+		};
+
 		const wxString getColumnName(const int column) const;
+		// caches a view of the selected event, the rows are filled in as they are shown
+		void selectEvent(const int index);
 
 	private:
 		db::EventsContainer &m_events;
+		std::optional<db::EventView> m_current;
+		mutable std::vector<Row> m_rows;
 	};
 
 } // namespace gui
@@ -1,17 +1,103 @@
 #include "gui/main_window.hpp"
 #include "gui/events_virtual_list_control.hpp"
+#include "parser/compressed_log_parser.hpp"
+#include "parser/merge_worker.hpp"
+#include "parser/parallel_xml_parser.hpp"
+#include "parser/tail_xml_parser.hpp"
+#include "search/event_filter.hpp"
+#include "db/timestamp.hpp"
+#include "parser/xml_event_index.hpp"
+#include "util/compressed_file.hpp"
+#include "util/profiler.hpp"
+
+#include <wx/filedlg.h>
+#include <wx/numdlg.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
 
 namespace gui
 {
+  namespace
+  {
+    // Generates synthetic events for the "Populate dummy data" menu entry.
+    // Progress is counted in events.
+    class DummyDataParser : public parser::DataParser
+    {
+    public:
+      explicit DummyDataParser(const long count)
+          : m_count(count)
+      {
+      }
+
+      void ParseData(std::istream &input) override
+      {
+        generate();
+      }
+
+      void ParseData(const std::filesystem::path &file) override
+      {
+        generate();
+      }
+
+      uint64_t GetCurrentProgress() const override
+      {
+        return m_current;
+      }
+
+      uint64_t GetTotalProgress() const override
+      {
+        return m_count;
+      }
+
+      db::Event &GetEvent() const override
+      {
+        throw std::logic_error("DummyDataParser hands generated events to its observers");
+      }
+
+    private:
+      void generate()
+      {
+        for (long i = 0; i < m_count && !IsStopRequested(); ++i)
+        {
+          if (i % 10)
+          {
+            NewEventNotification(db::Event(i, {{"timestamp", "dummyTimestamp"}, {"type", "dummyType"}, {"info", "dummyInfo"}, {"dummy", "dummy"}}));
+          }
+          else
+          {
+            NewEventNotification(db::Event(i, {{"timestamp", "dummyTimestamp"}, {"type", "dummyType"}, {"info", "dummyInfo"}}));
+          }
+          m_current = i + 1;
+        }
+      }
+
+    private:
+      const long m_count;
+      std::atomic<uint64_t> m_current{0};
+    };
+  } // namespace
 
   MainWindow::MainWindow(const wxString &title, const wxPoint &pos, const wxSize &size)
       : wxFrame(NULL, wxID_ANY, title, pos, size)
   {
 
+    m_refreshTimer.SetOwner(this, ID_RefreshTimer);
+    m_notifyTimer.SetOwner(this, ID_NotifyTimer);
+    m_events.DeferNotifications(std::chrono::milliseconds(m_frameIntervalMs));
+#ifdef LOGVIEWER_PROFILING
+    m_profileTimer.SetOwner(this, ID_ProfileTimer);
+    m_profileTimer.Start(m_profileIntervalMs);
+#endif
+
     this->setupMenu();
     this->setupLayout();
 
     this->Bind(wxEVT_CLOSE_WINDOW, &MainWindow::OnClose, this);
+    this->Bind(wxEVT_IDLE, &MainWindow::OnIdle, this);
   }
 
   void MainWindow::setupMenu()
@@ -28,12 +114,24 @@ namespace gui
     menuView->Append(wxID_VIEW_LIST, "Hide Search Result Panel", "Change view", wxITEM_CHECK);
     menuView->Append(ID_ViewLeftPanel, "Hide Left Panel", "Change view", wxITEM_CHECK);
     menuView->Append(ID_ViewRightPanel, "Hide Right Panel", "Change view", wxITEM_CHECK);
+    menuView->AppendSeparator();
+    menuView->Append(ID_IndexEvents, "Index Events While Loading", "Build a word index for instant searches of the next log", wxITEM_CHECK);
+    menuView->Append(ID_CacheLogs, "Cache Parsed Logs", "Keep a binary copy next to parsed logs to reopen them instantly", wxITEM_CHECK);
+    menuView->Append(ID_LoadOnDemand, "Load Events On Demand", "Parse the events of the next log only when they are shown", wxITEM_CHECK);
+    menuView->Append(ID_FollowFile, "Follow File", "Keep reading the next log as it grows, uncheck to stop", wxITEM_CHECK);
+    menuView->Append(ID_MemoryBudget, "Memory Budget...", "Spill the values of the next log to a temporary file past this much memory");
+#ifdef LOGVIEWER_PROFILING
+    menuView->AppendSeparator();
+    menuView->Append(ID_RecordTrace, "Record Trace", "Record every profiled call until unchecked", wxITEM_CHECK);
+    menuView->Append(ID_ExportTrace, "Export Trace...", "Save the recorded calls as Chrome trace JSON");
+#endif
 
     wxMenuBar *menuBar = new wxMenuBar;
     menuBar->Append(menuFile, "&File");
     menuBar->Append(menuHelp, "&Help");
     menuBar->Append(menuView, "&View");
     SetMenuBar(menuBar);
+    menuBar->Check(ID_CacheLogs, m_cacheLogs);
   }
 
   void MainWindow::OnSize(wxSizeEvent &event)
@@ -72,8 +170,8 @@ namespace gui
     m_rigth_spliter = new wxSplitterWindow(m_left_spliter, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxSP_BORDER | wxSP_LIVE_UPDATE);
     m_rigth_spliter->SetMinimumPaneSize(200);
 
-    m_leftPanel = new wxPanel(m_left_spliter);
-    m_searchResultPanel = new wxPanel(m_bottom_spliter);
+    m_leftPanel = new gui::OverviewPanel(m_events, m_left_spliter);
+    m_searchResultPanel = new gui::SearchResultsPanel(m_events, m_bottom_spliter);
     m_eventsListCtrl = new gui::EventsVirtualListControl(m_events, m_rigth_spliter); // main panel
     m_itemView = new gui::ItemVirtualListControl(m_events, m_rigth_spliter);
 
@@ -86,17 +184,45 @@ namespace gui
     m_rigth_spliter->SplitVertically(m_eventsListCtrl, m_itemView, -1);
     m_rigth_spliter->SetSashGravity(0.8);
 
-    m_leftPanel->SetBackgroundColour(wxColor(200, 100, 200));
-    m_searchResultPanel->SetBackgroundColour(wxColor(100, 200, 200));
+    m_leftPanel->SetOnTimeSelected([this](db::Timestamp time)
+                                   {
+                                     // the list is put in time order to find the time in it
+                                     if (!m_eventsListCtrl->GoToTime(time))
+                                       m_eventsListCtrl->SetTimeOrder(true);
+                                     if (!m_eventsListCtrl->GoToTime(time))
+                                       SetStatusText("The events cannot be put in time order"); });
 
-    CreateToolBar();
+    setupToolBar();
     setupStatusBar();
   }
 
+  void MainWindow::setupToolBar()
+  {
+    wxToolBar *toolBar = CreateToolBar();
+    toolBar->AddControl(new wxStaticText(toolBar, wxID_ANY, "Filter "));
+    m_filterText = new wxTextCtrl(toolBar, ID_FilterText, "", wxDefaultPosition, wxSize(500, -1), wxTE_PROCESS_ENTER);
+    m_filterText->SetHint("type=ERROR,WARN timestamp>=2024-01-01 timestamp<2024-01-02 info~timeout");
+    toolBar->AddControl(m_filterText);
+    toolBar->AddSeparator();
+    toolBar->AddControl(new wxStaticText(toolBar, wxID_ANY, "Go to "));
+    m_goToText = new wxTextCtrl(toolBar, ID_GoToTime, "", wxDefaultPosition, wxSize(200, -1), wxTE_PROCESS_ENTER);
+    m_goToText->SetHint("2024-01-01 12:00:00");
+    toolBar->AddControl(m_goToText);
+    toolBar->Realize();
+    m_filterText->Bind(wxEVT_TEXT_ENTER, &MainWindow::OnFilter, this);
+    m_goToText->Bind(wxEVT_TEXT_ENTER, &MainWindow::OnGoToTime, this);
+  }
+
   void MainWindow::setupStatusBar()
   {
 
+#ifdef LOGVIEWER_PROFILING
+    CreateStatusBar(3); // 1 - Message, 2-Progressbar, 3-Profiler summary
+    const int widths[] = {-2, -1, -3};
+    GetStatusBar()->SetStatusWidths(3, widths);
+#else
     CreateStatusBar(2); // 1 - Message, 2-Progressbar
+#endif
 
     wxRect rect;
     GetStatusBar()->GetFieldRect(1, rect);
@@ -107,44 +233,290 @@ namespace gui
 
   void MainWindow::populateData()
   {
+    m_loadedFile.clear();
+    m_eventsListCtrl->SetFollowTail(false);
+    startLoading(std::make_unique<DummyDataParser>(m_eventsNum), {});
+  }
+
+  void MainWindow::loadFile(const wxString &path)
+  {
+    const std::filesystem::path file(path.ToStdWstring());
+
+    waitForCacheWrite();
+    m_searchResultPanel->SuspendSearch();
+    m_index.Clear();
+    m_searchResultPanel->SetIndex(nullptr);
+    m_loadedFile.clear();
+    // compressed logs are archives, read through a decompression stage
+    const bool compressed = util::CompressedFile::Detect(file) != util::CompressedFile::Format::None;
+    m_eventsListCtrl->SetFollowTail(m_followFile && !compressed);
+
+    if (m_followFile && !compressed)
+    {
+      // a growing log is neither cached nor indexed by offsets
+      startLoading(std::make_unique<parser::TailXmlParser>(), file);
+      m_following = true;
+      SetStatusText("Following " + path);
+      return;
+    }
+    if (m_cacheLogs && m_events.OpenCache(file))
+    {
+      m_progressGauge->SetValue(m_progressGauge->GetRange());
+      SetStatusText("Data ready, opened from cache");
+      return;
+    }
+    if (m_loadOnDemand && !compressed)
+    {
+      openOnDemand(file);
+      return;
+    }
 
+    m_loadedFile = file;
+    startLoading(std::make_unique<parser::CompressedLogParser>(std::make_unique<parser::ParallelXmlParser>()), file);
+  }
+
+  void MainWindow::openOnDemand(const std::filesystem::path &file)
+  {
+    SetStatusText("Scanning ..");
+    try
+    {
+      const auto start = std::chrono::steady_clock::now();
+      auto index = std::make_unique<parser::XmlEventIndex>(file);
+      auto scanMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+      const auto count = index->Size();
+      // filters run over stored events, the pages loaded on demand have none
+      m_filterText->Clear();
+      m_eventsListCtrl->SetFilter({});
+      m_events.OpenLazy(std::move(index));
+      m_progressGauge->SetValue(m_progressGauge->GetRange());
+      SetStatusText(wxString::Format("Data ready, %zu events found in %lld ms, parsed when shown",
+                                     count, static_cast<long long>(scanMs)));
+    }
+    catch (const std::exception &e)
+    {
+      m_events.Clear();
+      SetStatusText("Loading failed");
+      wxMessageBox(e.what(), "Cannot open log", wxOK | wxICON_ERROR);
+    }
+  }
+
+  void MainWindow::loadFiles(const std::vector<std::filesystem::path> &files)
+  {
+    waitForCacheWrite();
+    m_loadedFile.clear();
+    m_eventsListCtrl->SetFollowTail(false);
+
+    // each log gets its own parser, parsing them all at once
+    std::vector<std::unique_ptr<parser::DataParser>> parsers;
+    for (std::size_t i = 0; i < files.size(); ++i)
+      parsers.push_back(std::make_unique<parser::CompressedLogParser>(std::make_unique<parser::ParallelXmlParser>()));
+    prepareLoading();
+    auto worker = std::make_unique<parser::MergeWorker>(std::move(parsers), m_stopLoading);
+    auto *merge = worker.get();
+    m_events.SetSources(files);
+    startWorker(std::move(worker));
+    merge->Start(files);
+  }
+
+  void MainWindow::startLoading(std::unique_ptr<parser::DataParser> dataParser, const std::filesystem::path &file)
+  {
+    prepareLoading();
+    auto worker = std::make_unique<parser::ParserWorker>(std::move(dataParser), m_stopLoading);
+    auto *parse = worker.get();
+    startWorker(std::move(worker));
+    parse->Start(file);
+  }
+
+  void MainWindow::prepareLoading()
+  {
     SetStatusText("Loading ..");
+    m_progressGauge->SetRange(m_progressRange);
     m_progressGauge->SetValue(0);
 
+    waitForCacheWrite();
+    m_searchResultPanel->SuspendSearch();
+    m_index.Clear();
+    m_searchResultPanel->SetIndex(m_indexEvents ? &m_index : nullptr);
+    m_events.Clear();
+    m_events.SetMemoryBudget(m_memoryBudget);
+    m_reserved = false;
     m_processing = true;
-    for (long i = 0; i < m_eventsNum; ++i)
+    m_stopLoading = false;
+  }
+
+  void MainWindow::startWorker(std::unique_ptr<parser::BatchProducer> worker)
+  {
+    // the batch observer is set before the worker starts
+    m_worker = std::move(worker);
+    if (m_indexEvents)
     {
-      if (i % 10)
-      {
-        m_events.AddEvent(db::Event(i, {{"timestamp", "dummyTimestamp"}, {"type", "dummyType"}, {"info", "dummyInfo"}, {"dummy", "dummy"}}));
-      }
-      else
+      m_worker->SetBatchObserver([this](const parser::BatchProducer::Batch &batch)
+                                 { m_index.Add(batch); });
+    }
+    m_refreshTimer.Start(m_refreshIntervalMs);
+  }
+
+  void MainWindow::OnRefreshTimer(wxTimerEvent &event)
+  {
+    if (m_worker == nullptr)
+      return;
+
+    // everything parsed since the last tick reaches the views as one append,
+    // a running search keeps reading the rows it started with meanwhile
+    parser::BatchProducer::Batch batch;
+    if (m_worker->TryPopBatch(batch))
+    {
+      m_events.BeginUpdate();
+      do
+        m_events.AddEvents(std::move(batch));
+      while (m_worker->TryPopBatch(batch));
+      reserveForEstimate();
+      m_events.EndUpdate();
+    }
+
+    auto total = m_worker->GetTotalProgress();
+    if (total > 0)
+      m_progressGauge->SetValue(static_cast<int>(m_worker->GetCurrentProgress() * m_progressRange / total));
+
+    if (!m_worker->IsFinished())
+      return;
+
+    m_refreshTimer.Stop();
+    m_worker->Join();
+    auto error = m_worker->GetError();
+    m_worker.reset();
+    m_processing = false;
+    const bool followed = std::exchange(m_following, false);
+
+    if (m_closerequest)
+    {
+      waitForCacheWrite();
+      m_searchResultPanel->SuspendSearch();
+      this->Destroy();
+      return;
+    }
+
+    if (error.empty())
+    {
+      m_progressGauge->SetValue(m_progressRange);
+      if (followed)
+        SetStatusText("Stopped following");
+      else if (const auto &spillError = m_events.GetStore().GetSpillError(); !spillError.empty())
+        SetStatusText("Data ready, kept in memory past the budget: " + wxString::FromUTF8(spillError));
+      else if (m_indexEvents)
       {
-        m_events.AddEvent(db::Event(i, {{"timestamp", "dummyTimestamp"}, {"type", "dummyType"}, {"info", "dummyInfo"}}));
+        auto buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(m_index.GetBuildTime()).count();
+        SetStatusText(wxString::Format("Data ready, index of %.1f MB built in %lld ms",
+                                       m_index.MemoryUsage() / (1024.0 * 1024.0), static_cast<long long>(buildMs)));
       }
-
-      if (i % 100 == 0)
+      else if (const auto spilled = m_events.GetStore().GetSpilledSize(); spilled > 0)
       {
-        m_progressGauge->SetValue(i);
-        wxYield();
+        SetStatusText(wxString::Format("Data ready, %.1f MB of values spilled to disk", spilled / (1024.0 * 1024.0)));
       }
-
-      if (m_closerequest)
+      else
       {
-        m_processing = false;
-        this->Destroy();
-        return;
+        SetStatusText("Data ready");
       }
+      saveCache();
+    }
+    else
+    {
+      SetStatusText("Loading failed");
+      wxMessageBox(error, "Cannot open log", wxOK | wxICON_ERROR);
     }
+  }
 
-    SetStatusText("Data ready");
-    m_processing = false;
+  void MainWindow::reserveForEstimate()
+  {
+    if (m_reserved)
+      return;
+
+    // the events of the first batches extrapolated to the whole input
+    // size the store once instead of letting it grow by doubling
+    auto current = m_worker->GetCurrentProgress();
+    auto total = m_worker->GetTotalProgress();
+    if (current == 0 || total == 0)
+      return;
+    m_events.Reserve(static_cast<std::size_t>(m_events.Size() * static_cast<double>(total) / current));
+    m_reserved = true;
+  }
+
+  void MainWindow::saveCache()
+  {
+    if (!m_cacheLogs || m_loadedFile.empty())
+      return;
+
+    // the views only read the store, it stays unchanged until the write is
+    // waited for
+    m_cacheWrite = std::async(std::launch::async, [this, file = m_loadedFile]
+                              {
+                                try
+                                {
+                                  m_events.SaveCache(file);
+                                }
+                                catch (const std::exception &)
+                                {
+                                  // no cache, the log is parsed again next time
+                                } });
   }
+
+  void MainWindow::waitForCacheWrite()
+  {
+    if (m_cacheWrite.valid())
+      m_cacheWrite.get();
+  }
+
   void MainWindow::OnExit(wxCommandEvent &event)
   {
     Close(true);
   }
 
+  void MainWindow::OnIdle(wxIdleEvent &event)
+  {
+    this->flushNotifications();
+    event.Skip();
+  }
+
+  void MainWindow::OnNotifyTimer(wxTimerEvent &event)
+  {
+    this->flushNotifications();
+  }
+
+  void MainWindow::flushNotifications()
+  {
+    m_events.Flush();
+    // too soon after the last delivery, come back when the frame is over
+    if (m_events.HasPending() && !m_notifyTimer.IsRunning())
+      m_notifyTimer.StartOnce(m_frameIntervalMs);
+  }
+
+#ifdef LOGVIEWER_PROFILING
+  void MainWindow::OnProfileTimer(wxTimerEvent &event)
+  {
+    SetStatusText(wxString::FromUTF8(util::Profiler::Instance().FormatSummary()), 2);
+  }
+
+  void MainWindow::OnRecordTrace(wxCommandEvent &event)
+  {
+    if (event.IsChecked())
+      util::Profiler::Instance().StartTrace();
+    else
+      util::Profiler::Instance().StopTrace();
+  }
+
+  void MainWindow::OnExportTrace(wxCommandEvent &event)
+  {
+    wxFileDialog dialog(this, "Export trace", "", "logviewer_trace.json", "Chrome trace (*.json)|*.json",
+                        wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (dialog.ShowModal() == wxID_CANCEL)
+      return;
+
+    std::ofstream out(std::filesystem::path(dialog.GetPath().ToStdWstring()), std::ios::binary);
+    util::Profiler::Instance().WriteChromeTrace(out);
+    SetStatusText(out ? "Trace exported, open it in chrome://tracing or Perfetto" : "Cannot write the trace");
+  }
+#endif
+
   void MainWindow::OnClose(wxCloseEvent &event)
   {
 
@@ -152,9 +524,12 @@ namespace gui
     {
       event.Veto();
       m_closerequest = true;
+      m_stopLoading = true;
     }
     else
     {
+      waitForCacheWrite();
+      m_searchResultPanel->SuspendSearch();
       this->Destroy();
     }
   }
@@ -166,9 +541,34 @@ namespace gui
   }
   void MainWindow::OnHello(wxCommandEvent &event)
   {
+    if (m_processing)
+      return;
     populateData();
   }
 
+  void MainWindow::OnOpen(wxCommandEvent &event)
+  {
+    if (m_processing)
+      return;
+
+    wxFileDialog openFileDialog(this, "Open log files", "", "", "XML logs (*.xml;*.xml.gz;*.xml.zst)|*.xml;*.xml.gz;*.xml.zst|All files (*.*)|*.*",
+                                wxFD_OPEN | wxFD_FILE_MUST_EXIST | wxFD_MULTIPLE);
+    if (openFileDialog.ShowModal() == wxID_CANCEL)
+      return;
+
+    wxArrayString paths;
+    openFileDialog.GetPaths(paths);
+    if (paths.size() == 1)
+    {
+      loadFile(paths[0]);
+      return;
+    }
+    std::vector<std::filesystem::path> files;
+    for (const auto &path : paths)
+      files.emplace_back(path.ToStdWstring());
+    loadFiles(files);
+  }
+
   void MainWindow::OnHideSearchResult(wxCommandEvent &event)
   {
     if (event.IsChecked())
@@ -214,14 +614,103 @@ namespace gui
     this->Layout();
   }
 
+  void MainWindow::OnIndexEvents(wxCommandEvent &event)
+  {
+    // applies to the next log, the loaded one has no index to add to
+    m_indexEvents = event.IsChecked();
+  }
+
+  void MainWindow::OnCacheLogs(wxCommandEvent &event)
+  {
+    m_cacheLogs = event.IsChecked();
+  }
+
+  void MainWindow::OnLoadOnDemand(wxCommandEvent &event)
+  {
+    m_loadOnDemand = event.IsChecked();
+  }
+
+  void MainWindow::OnMemoryBudget(wxCommandEvent &event)
+  {
+    const long megabytes = wxGetNumberFromUser("Values of the events loaded past this many MB are kept in a temporary file.",
+                                               "MB, 0 for no limit:", "Memory Budget",
+                                               static_cast<long>(m_memoryBudget >> 20), 0, 1 << 20, this);
+    if (megabytes < 0)
+      return;
+    // applies to the next log, the loading one may be storing values
+    m_memoryBudget = static_cast<std::size_t>(megabytes) << 20;
+    SetStatusText(megabytes == 0 ? wxString("No memory budget for the next log")
+                                 : wxString::Format("Memory budget of %ld MB for the next log", megabytes));
+  }
+
+  void MainWindow::OnFilter(wxCommandEvent &event)
+  {
+    if (m_events.IsLazy())
+    {
+      SetStatusText("Filters need a fully loaded log");
+      return;
+    }
+
+    search::EventFilter filter;
+    try
+    {
+      filter = search::EventFilter::Parse(m_filterText->GetValue().ToStdString(wxConvUTF8));
+    }
+    catch (const std::exception &e)
+    {
+      SetStatusText(wxString::Format("Invalid filter: %s", e.what()));
+      return;
+    }
+
+    const bool all = filter.Empty();
+    m_eventsListCtrl->SetFilter(std::move(filter));
+    if (all)
+      SetStatusText(wxString::Format("%zu events", m_events.Size()));
+    else
+      SetStatusText(wxString::Format("%zu of %zu events pass the filter", m_eventsListCtrl->GetShownCount(), m_events.Size()));
+  }
+
+  void MainWindow::OnGoToTime(wxCommandEvent &event)
+  {
+    auto time = db::ParseTimestamp(m_goToText->GetValue().ToStdString(wxConvUTF8));
+    if (!time)
+    {
+      SetStatusText("Invalid time, expected e.g. 2024-01-01 12:00:00");
+      return;
+    }
+    if (!m_eventsListCtrl->GoToTime(*time))
+      SetStatusText("The events are not in time order, click the timestamp header to sort them");
+  }
+
+  void MainWindow::OnFollowFile(wxCommandEvent &event)
+  {
+    m_followFile = event.IsChecked();
+    // the followed log keeps what was read, the worker winds down on the next tick
+    if (!m_followFile && m_following)
+      m_stopLoading = true;
+  }
+
   wxBEGIN_EVENT_TABLE(MainWindow, wxFrame)
       EVT_MENU(ID_Hello, MainWindow::OnHello)
+          EVT_MENU(wxID_OPEN, MainWindow::OnOpen)
           EVT_MENU(wxID_VIEW_LIST, MainWindow::OnHideSearchResult)
               EVT_MENU(ID_ViewLeftPanel, MainWindow::OnHideLeftPanel)
                   EVT_MENU(ID_ViewRightPanel, MainWindow::OnHideRightPanel)
+                  EVT_MENU(ID_IndexEvents, MainWindow::OnIndexEvents)
+                  EVT_MENU(ID_CacheLogs, MainWindow::OnCacheLogs)
+                  EVT_MENU(ID_LoadOnDemand, MainWindow::OnLoadOnDemand)
+                  EVT_MENU(ID_FollowFile, MainWindow::OnFollowFile)
+                  EVT_MENU(ID_MemoryBudget, MainWindow::OnMemoryBudget)
                       EVT_MENU(wxID_EXIT, MainWindow::OnExit)
                           EVT_MENU(wxID_ABOUT, MainWindow::OnAbout)
                               EVT_SIZE(MainWindow::OnSize)
+                                  EVT_TIMER(ID_RefreshTimer, MainWindow::OnRefreshTimer)
+                                      EVT_TIMER(ID_NotifyTimer, MainWindow::OnNotifyTimer)
+#ifdef LOGVIEWER_PROFILING
+                                          EVT_TIMER(ID_ProfileTimer, MainWindow::OnProfileTimer)
+                                              EVT_MENU(ID_RecordTrace, MainWindow::OnRecordTrace)
+                                                  EVT_MENU(ID_ExportTrace, MainWindow::OnExportTrace)
+#endif
                                   wxEND_EVENT_TABLE()
 
 } // namespace gui
\ No newline at end of file
@@ -3,10 +3,23 @@
 
 #include <wx/wx.h>
 #include <wx/splitter.h>
+#include <wx/timer.h>
 
 #include "gui/events_virtual_list_control.hpp"
 #include "gui/item_list_view.hpp"
+#include "gui/overview_panel.hpp"
+#include "gui/search_results_panel.hpp"
 #include "db/events_container.hpp"
+#include "parser/data_parser.hpp"
+#include "parser/batch_producer.hpp"
+#include "parser/parser_worker.hpp"
+#include "search/token_index.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <vector>
 
 namespace gui
 {
@@ -14,7 +27,19 @@ namespace gui
 	{
 		ID_Hello = 1,
 		ID_ViewLeftPanel = 2,
-		ID_ViewRightPanel = 3
+		ID_ViewRightPanel = 3,
+		ID_RefreshTimer = 4,
+		ID_IndexEvents = 5,
+		ID_CacheLogs = 6,
+		ID_LoadOnDemand = 7,
+		ID_FollowFile = 8,
+		ID_FilterText = 9,
+		ID_GoToTime = 10,
+		ID_NotifyTimer = 11,
+		ID_ProfileTimer = 12,
+		ID_RecordTrace = 13,
+		ID_ExportTrace = 14,
+		ID_MemoryBudget = 15
 
 	};
 
@@ -25,6 +50,7 @@ namespace gui
 
 	private:
 		void OnHello(wxCommandEvent &event);
+		void OnOpen(wxCommandEvent &event);
 		void OnExit(wxCommandEvent &event);
 		void OnClose(wxCloseEvent &event);
 		void OnAbout(wxCommandEvent &event);
@@ -32,28 +58,96 @@ namespace gui
 		void OnHideSearchResult(wxCommandEvent &event);
 		void OnHideLeftPanel(wxCommandEvent &event);
 		void OnHideRightPanel(wxCommandEvent &event);
+		void OnIndexEvents(wxCommandEvent &event);
+		void OnCacheLogs(wxCommandEvent &event);
+		void OnLoadOnDemand(wxCommandEvent &event);
+		void OnFollowFile(wxCommandEvent &event);
+		void OnMemoryBudget(wxCommandEvent &event);
+		void OnFilter(wxCommandEvent &event);
+		void OnGoToTime(wxCommandEvent &event);
+		void OnRefreshTimer(wxTimerEvent &event);
+		void OnIdle(wxIdleEvent &event);
+		void OnNotifyTimer(wxTimerEvent &event);
+#ifdef LOGVIEWER_PROFILING
+		void OnProfileTimer(wxTimerEvent &event);
+		void OnRecordTrace(wxCommandEvent &event);
+		void OnExportTrace(wxCommandEvent &event);
+#endif
 
 		wxDECLARE_EVENT_TABLE();
 
 		void setupMenu();
 		void setupLayout();
 		void setupStatusBar();
+		void setupToolBar();
 		void populateData();
+		void loadFile(const wxString &path);
+		// merges the logs by timestamp into one list
+		void loadFiles(const std::vector<std::filesystem::path> &files);
+		void openOnDemand(const std::filesystem::path &file);
+		void startLoading(std::unique_ptr<parser::DataParser> dataParser, const std::filesystem::path &file);
+		// resets the views for the worker that is started next
+		void prepareLoading();
+		void startWorker(std::unique_ptr<parser::BatchProducer> worker);
+		void reserveForEstimate();
+		void saveCache();
+		void waitForCacheWrite();
+		// delivers the merged view notifications once the frame interval passed
+		void flushNotifications();
 
 	private:
 		gui::EventsVirtualListControl *m_eventsListCtrl{nullptr};
 		gui::ItemVirtualListControl *m_itemView{nullptr};
-		wxPanel *m_leftPanel{nullptr};
-		wxPanel *m_searchResultPanel{nullptr};
+		gui::OverviewPanel *m_leftPanel{nullptr};
+		gui::SearchResultsPanel *m_searchResultPanel{nullptr};
 		wxSplitterWindow *m_bottom_spliter{nullptr};
 		wxSplitterWindow *m_left_spliter{nullptr};
 		wxSplitterWindow *m_rigth_spliter{nullptr};
 		db::EventsContainer m_events;
 		wxGauge *m_progressGauge{nullptr};
+		wxTextCtrl *m_filterText{nullptr};
+		wxTextCtrl *m_goToText{nullptr};
 		const long m_eventsNum{100000};
+		const int m_progressRange{1000};
+		// the list is refreshed at this fixed interval while a log is loading
+		const int m_refreshIntervalMs{50};
+		wxTimer m_refreshTimer;
+		// views are notified at most once per frame, pending notifications
+		// wait for idle time or for this timer
+		const int m_frameIntervalMs{16};
+		wxTimer m_notifyTimer;
+#ifdef LOGVIEWER_PROFILING
+		// the status bar field after the gauge shows the slowest profiled sites
+		const int m_profileIntervalMs{1000};
+		wxTimer m_profileTimer;
+#endif
+
+		// filled by the worker thread while loading when indexing is on
+		search::TokenIndex m_index;
+		bool m_indexEvents{false};
+
+		// parsed logs get a sidecar cache for the next time they are opened
+		bool m_cacheLogs{true};
+		std::filesystem::path m_loadedFile;
+		// the store is written out in the background, it must not change meanwhile
+		std::future<void> m_cacheWrite;
+
+		// logs are only scanned for event boundaries and parsed as they are viewed
+		bool m_loadOnDemand{false};
+		// opened logs are followed as they grow until this is unchecked
+		bool m_followFile{false};
+		bool m_following{false};
+		// bytes of memory past which the values of a loaded log are spilled, 0 for none
+		std::size_t m_memoryBudget{0};
 
 		std::atomic<bool> m_closerequest{false};
+		// stops the parser, on close or when following is turned off
+		std::atomic<bool> m_stopLoading{false};
 		bool m_processing{false};
+		// the container was sized for the estimated number of events
+		bool m_reserved{false};
+		// declared last, the worker thread reads m_stopLoading until it is joined
+		std::unique_ptr<parser::BatchProducer> m_worker;
 	};
 
 } // namespace gui
@@ -0,0 +1,196 @@
+#include "gui/overview_panel.hpp"
+
+#include <wx/dcbuffer.h>
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "util/profiler.hpp"
+
+namespace gui
+{
+  namespace
+  {
+    // "YYYY-MM-DD HH:MM:SS" without the fraction
+    wxString formatTime(db::Timestamp time)
+    {
+      return wxString::FromUTF8(db::FormatTimestamp(time).substr(0, 19));
+    }
+  } // namespace
+
+  OverviewPanel::OverviewPanel(db::EventsContainer &events, wxWindow *parent, const wxWindowID id)
+      : wxPanel(parent, id), m_events(events), m_histogram(events.GetStore())
+  {
+    this->SetBackgroundStyle(wxBG_STYLE_PAINT);
+    this->Bind(wxEVT_PAINT, &OverviewPanel::OnPaint, this);
+    this->Bind(wxEVT_LEFT_DOWN, &OverviewPanel::OnLeftDown, this);
+    this->Bind(wxEVT_SIZE, [this](wxSizeEvent &evt)
+               {
+                 this->Refresh();
+                 evt.Skip(); });
+
+    m_events.RegisterOndDataUpdated(this);
+  }
+
+  void OverviewPanel::SetOnTimeSelected(std::function<void(db::Timestamp)> onTimeSelected)
+  {
+    m_onTimeSelected = std::move(onTimeSelected);
+  }
+
+  void OverviewPanel::OnDataUpdated()
+  {
+    // events loaded on demand are not in the store and not counted
+    m_histogram.Rebuild();
+    m_currentTime.reset();
+    this->Refresh();
+  }
+
+  void OverviewPanel::OnDataAppended(const std::size_t first, const std::size_t last)
+  {
+    m_histogram.Append(first, last);
+    this->Refresh();
+  }
+
+  void OverviewPanel::OnCurrentIndexUpdated(const int index)
+  {
+    const auto &store = m_events.GetStore();
+    const auto time = index >= 0 && static_cast<std::size_t>(index) < store.size() ? store.GetTime(index) : db::EventStore::kNoTime;
+    m_currentTime = time == db::EventStore::kNoTime ? std::nullopt : std::optional<db::Timestamp>(time);
+    this->Refresh();
+  }
+
+  void OverviewPanel::OnPaint(wxPaintEvent &event)
+  {
+    LOGVIEWER_PROFILE_SCOPE("Overview::OnPaint");
+    wxAutoBufferedPaintDC dc(this);
+    dc.SetBackground(wxBrush(this->GetBackgroundColour()));
+    dc.Clear();
+    dc.SetFont(this->GetFont());
+
+    const wxRect client = this->GetClientRect();
+    const wxRect histogram = this->histogramRect();
+    this->drawTypes(dc, wxRect(client.x, client.y, client.width, histogram.y - client.y));
+    this->drawHistogram(dc, histogram);
+  }
+
+  void OverviewPanel::OnLeftDown(wxMouseEvent &event)
+  {
+    const auto area = this->histogramRect();
+    if (!m_onTimeSelected || !m_histogram.HasTimes() || !area.Contains(event.GetPosition()) || area.width <= 0)
+      return;
+    const auto bucket = static_cast<std::size_t>(event.GetX() - area.x) * search::EventHistogram::kBuckets /
+                        static_cast<std::size_t>(area.width);
+    m_onTimeSelected(m_histogram.GetBucketStart(std::min(bucket, search::EventHistogram::kBuckets - 1)));
+  }
+
+  void OverviewPanel::drawTypes(wxDC &dc, const wxRect &area) const
+  {
+    const auto total = m_histogram.GetCount();
+    int y = area.y + m_margin;
+    dc.SetTextForeground(this->GetForegroundColour());
+    dc.DrawText(wxString::Format("%zu events", total), area.x + m_margin, y);
+    y += m_rowHeight;
+
+    const auto &types = m_histogram.GetTypes();
+    auto drawRow = [&](std::size_t type, const wxString &name)
+    {
+      const auto count = m_histogram.GetTypeCount(type);
+      const int swatch = m_rowHeight - 8;
+      dc.SetPen(*wxTRANSPARENT_PEN);
+      dc.SetBrush(wxBrush(typeColour(type)));
+      dc.DrawRectangle(area.x + m_margin, y + 3, swatch, swatch);
+      dc.DrawText(name, area.x + m_margin + swatch + 4, y);
+      const auto text = wxString::Format("%zu", count);
+      dc.DrawText(text, area.GetRight() - m_margin - dc.GetTextExtent(text).x, y);
+      // share of all events as a line under the row
+      const int width = total > 0 ? static_cast<int>((area.width - 2 * m_margin) * count / total) : 0;
+      dc.DrawRectangle(area.x + m_margin, y + m_rowHeight - 2, width, 1);
+      y += m_rowHeight;
+    };
+    for (std::size_t type = 0; type < types.size(); ++type)
+      drawRow(type, types[type].empty() ? wxString("(none)") : wxString::FromUTF8(types[type].data(), types[type].size()));
+    if (m_histogram.GetTypeCount(search::EventHistogram::kOtherTypes) > 0)
+      drawRow(search::EventHistogram::kOtherTypes, "(other)");
+  }
+
+  void OverviewPanel::drawHistogram(wxDC &dc, const wxRect &area) const
+  {
+    const auto fullest = m_histogram.GetMaxBucketCount();
+    if (!m_histogram.HasTimes() || fullest == 0 || area.width <= 0 || area.height <= 0)
+    {
+      dc.DrawText("No timestamps", area.x + m_margin, area.y);
+      return;
+    }
+
+    constexpr auto buckets = search::EventHistogram::kBuckets;
+    const auto &types = m_histogram.GetTypes();
+    const int bottom = area.GetBottom() + 1;
+    auto heightOf = [&](std::size_t count)
+    {
+      return static_cast<int>(static_cast<uint64_t>(area.height) * count / fullest);
+    };
+
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    for (std::size_t bucket = 0; bucket < buckets; ++bucket)
+    {
+      const int left = area.x + static_cast<int>(area.width * bucket / buckets);
+      const int right = area.x + static_cast<int>(area.width * (bucket + 1) / buckets);
+      std::size_t stacked = 0;
+      auto drawType = [&](std::size_t type)
+      {
+        const auto count = m_histogram.GetBucketCount(bucket, type);
+        if (count == 0)
+          return;
+        const int top = bottom - heightOf(stacked + count);
+        dc.SetBrush(wxBrush(typeColour(type)));
+        dc.DrawRectangle(left, top, std::max(right - left, 1), bottom - heightOf(stacked) - top);
+        stacked += count;
+      };
+      for (std::size_t type = 0; type < types.size(); ++type)
+        drawType(type);
+      drawType(search::EventHistogram::kOtherTypes);
+    }
+
+    if (m_currentTime)
+    {
+      if (auto bucket = m_histogram.BucketOf(*m_currentTime))
+      {
+        const int x = area.x + static_cast<int>(area.width * (2 * *bucket + 1) / (2 * buckets));
+        dc.SetPen(wxPen(*wxRED));
+        dc.DrawLine(x, area.y, x, bottom);
+      }
+    }
+
+    dc.SetTextForeground(this->GetForegroundColour());
+    const auto first = formatTime(m_histogram.GetBucketStart(0));
+    const auto last = formatTime(m_histogram.GetBucketStart(buckets));
+    dc.DrawText(first, area.x, bottom + 2);
+    dc.DrawText(last, area.GetRight() - dc.GetTextExtent(last).x, bottom + 2 + m_rowHeight);
+  }
+
+  wxRect OverviewPanel::histogramRect() const
+  {
+    const wxRect client = this->GetClientRect();
+    std::size_t rows = 1 + m_histogram.GetTypes().size();
+    if (m_histogram.GetTypeCount(search::EventHistogram::kOtherTypes) > 0)
+      ++rows;
+    const int top = client.y + 2 * m_margin + static_cast<int>(rows) * m_rowHeight;
+    // two rows of time labels below
+    const int height = client.GetBottom() - m_margin - 2 * m_rowHeight - top;
+    return wxRect(client.x + m_margin, top, client.width - 2 * m_margin, std::max(height, 0));
+  }
+
+  wxColour OverviewPanel::typeColour(std::size_t type)
+  {
+    static const wxColour colours[] = {
+        wxColour(31, 119, 180), wxColour(255, 127, 14), wxColour(44, 160, 44), wxColour(214, 39, 40),
+        wxColour(148, 103, 189), wxColour(140, 86, 75), wxColour(227, 119, 194), wxColour(188, 189, 34),
+        wxColour(23, 190, 207), wxColour(174, 199, 232), wxColour(255, 187, 120), wxColour(152, 223, 138),
+        wxColour(255, 152, 150), wxColour(197, 176, 213), wxColour(196, 156, 148), wxColour(219, 219, 141)};
+    if (type >= std::size(colours))
+      return wxColour(127, 127, 127);
+    return colours[type];
+  }
+} // namespace gui
@@ -0,0 +1,56 @@
+#ifndef GUI_OVERVIEWPANEL_HPP
+#define GUI_OVERVIEWPANEL_HPP
+
+#include <wx/wx.h>
+
+#include "mvc/view.hpp"
+#include "db/events_container.hpp"
+#include "db/timestamp.hpp"
+#include "search/event_histogram.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+namespace gui
+{
+	// Overview of the left panel: the events of every type and a histogram
+	// of the events over time, stacked by type, with a mark at the current
+	// event. It is drawn from the counters of a search::EventHistogram that
+	// counts events as they are appended, so painting costs the same for any
+	// number of events. A click on the histogram goes to the time clicked.
+	class OverviewPanel : public wxPanel, public mvc::View
+	{
+	public:
+		OverviewPanel(db::EventsContainer &events, wxWindow *parent, const wxWindowID id = wxID_ANY);
+
+		// called with the start of the bucket clicked
+		void SetOnTimeSelected(std::function<void(db::Timestamp)> onTimeSelected);
+
+		// implement View interface
+		virtual void OnDataUpdated() override;
+		virtual void OnCurrentIndexUpdated(const int index) override;
+		virtual void OnDataAppended(const std::size_t first, const std::size_t last) override;
+
+	private:
+		void OnPaint(wxPaintEvent &event);
+		void OnLeftDown(wxMouseEvent &event);
+
+		void drawTypes(wxDC &dc, const wxRect &area) const;
+		void drawHistogram(wxDC &dc, const wxRect &area) const;
+		// part of the panel below the type rows
+		wxRect histogramRect() const;
+		static wxColour typeColour(std::size_t type);
+
+	private:
+		db::EventsContainer &m_events;
+		search::EventHistogram m_histogram;
+		std::function<void(db::Timestamp)> m_onTimeSelected;
+		std::optional<db::Timestamp> m_currentTime;
+		const int m_rowHeight{18};
+		const int m_margin{6};
+	};
+
+} // namespace gui
+
+#endif // GUI_OVERVIEWPANEL_HPP
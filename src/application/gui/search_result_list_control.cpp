@@ -0,0 +1,69 @@
+#include "gui/search_result_list_control.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace gui
+{
+  SearchResultListControl::SearchResultListControl(db::EventsContainer &events, wxWindow *parent,
+                                                   const wxWindowID id, const wxPoint &pos, const wxSize &size)
+      : m_events(events), wxListCtrl(parent, id, pos, size, wxLC_REPORT | wxLC_VIRTUAL)
+  {
+
+    this->AppendColumn("id");
+    this->AppendColumn("field");
+    this->AppendColumn("value", wxLIST_FORMAT_LEFT, 600);
+
+    this->Bind(wxEVT_LIST_ITEM_SELECTED, [this](wxListEvent &evt)
+               {
+                 if (this->m_rows != nullptr && evt.GetIndex() >= 0 && static_cast<std::size_t>(evt.GetIndex()) < this->m_rows->size())
+                   this->m_events.SetCurrentItem(static_cast<int>((*this->m_rows)[evt.GetIndex()]));
+               });
+  }
+
+  void SearchResultListControl::SetResults(const std::vector<std::size_t> *rows, const search::Matcher *matcher)
+  {
+    m_rows = rows;
+    m_matcher = matcher;
+    m_shownCount = rows ? rows->size() : 0;
+    this->SetItemCount(m_shownCount);
+    this->Refresh();
+  }
+
+  void SearchResultListControl::RefreshResults()
+  {
+    const std::size_t count = m_rows ? m_rows->size() : 0;
+    if (count == m_shownCount)
+      return;
+    this->SetItemCount(count);
+
+    // results are only ever appended, repaint the new ones that are on screen
+    long top = this->GetTopItem();
+    long bottom = top + this->GetCountPerPage();
+    if (count > m_shownCount && static_cast<long>(m_shownCount) <= bottom)
+      this->RefreshItems(std::max<long>(m_shownCount, top), std::min<long>(count - 1, bottom));
+    else if (count < m_shownCount)
+      this->Refresh();
+    m_shownCount = count;
+  }
+
+  wxString SearchResultListControl::OnGetItemText(long index, long column) const
+  {
+    if (m_rows == nullptr || index < 0 || static_cast<std::size_t>(index) >= m_rows->size())
+      return wxEmptyString;
+
+    auto event = m_events.GetEvent(static_cast<int>((*m_rows)[index]));
+    if (column == 0)
+      return std::to_string(event.getId());
+
+    if (m_matcher == nullptr)
+      return wxEmptyString;
+    auto position = event.findInEvent(*m_matcher);
+    if (!position)
+      return wxEmptyString;
+
+    auto item = event.getEventItems()[*position];
+    auto text = column == 1 ? item.first : item.second;
+    return wxString::FromUTF8(text.data(), text.size());
+  }
+} // namespace gui
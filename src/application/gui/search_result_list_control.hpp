@@ -0,0 +1,39 @@
+#ifndef GUI_SEARCHRESULTLISTCONTROL_HPP
+#define GUI_SEARCHRESULTLISTCONTROL_HPP
+
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+
+#include "db/events_container.hpp"
+#include "search/matcher.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace gui
+{
+	// Virtual list of the rows found by a search, with the first field of
+	// each event that matched. Selecting a result makes it the current event.
+	class SearchResultListControl : public wxListCtrl
+	{
+	public:
+		SearchResultListControl(db::EventsContainer &events, wxWindow *parent, const wxWindowID id = wxID_ANY,
+														const wxPoint &pos = wxDefaultPosition, const wxSize &size = wxDefaultSize);
+
+		virtual wxString OnGetItemText(long index, long column) const wxOVERRIDE;
+		// Shows the rows of a new search, null for none. The matcher picks the
+		// field shown for each row.
+		void SetResults(const std::vector<std::size_t> *rows, const search::Matcher *matcher);
+		// shows the rows appended since the last refresh
+		void RefreshResults();
+
+	private:
+		db::EventsContainer &m_events;
+		const std::vector<std::size_t> *m_rows{nullptr};
+		const search::Matcher *m_matcher{nullptr};
+		std::size_t m_shownCount{0};
+	};
+
+} // namespace gui
+
+#endif // GUI_SEARCHRESULTLISTCONTROL_HPP
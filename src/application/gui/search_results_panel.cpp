@@ -0,0 +1,215 @@
+#include "gui/search_results_panel.hpp"
+
+#include <algorithm>
+#include <regex>
+#include <string>
+
+namespace gui
+{
+  SearchResultsPanel::SearchResultsPanel(db::EventsContainer &events, wxWindow *parent, const wxWindowID id)
+      : wxPanel(parent, id), m_events(events), m_search(events.GetStore())
+  {
+
+    m_query = new wxSearchCtrl(this, wxID_ANY);
+    m_query->ShowCancelButton(true);
+    m_query->SetDescriptiveText("Search events");
+    m_matchCase = new wxCheckBox(this, wxID_ANY, "Match case");
+    m_matchCase->SetValue(true);
+    m_regex = new wxCheckBox(this, wxID_ANY, "Regular expression");
+    m_regex->SetValue(true);
+    m_indexed = new wxCheckBox(this, wxID_ANY, "Whole words from index");
+    m_indexed->SetToolTip("Find events with all the words or field=value pairs of the query. "
+                          "Needs View > Index Events While Loading.");
+    m_indexed->Enable(false);
+    m_status = new wxStaticText(this, wxID_ANY, wxEmptyString);
+    m_results = new SearchResultListControl(m_events, this);
+
+    auto *queryRow = new wxBoxSizer(wxHORIZONTAL);
+    queryRow->Add(m_query, 1, wxEXPAND | wxRIGHT, 5);
+    queryRow->Add(m_matchCase, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    queryRow->Add(m_regex, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    queryRow->Add(m_indexed, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, 5);
+    queryRow->Add(m_status, 0, wxALIGN_CENTER_VERTICAL);
+
+    auto *layout = new wxBoxSizer(wxVERTICAL);
+    layout->Add(queryRow, 0, wxEXPAND | wxALL, 2);
+    layout->Add(m_results, 1, wxEXPAND);
+    this->SetSizer(layout);
+
+    m_query->Bind(wxEVT_TEXT, &SearchResultsPanel::OnQueryChanged, this);
+    m_query->Bind(wxEVT_SEARCH_CANCEL, [this](wxCommandEvent &evt)
+                  { this->m_query->Clear(); });
+    m_matchCase->Bind(wxEVT_CHECKBOX, &SearchResultsPanel::OnQueryChanged, this);
+    m_regex->Bind(wxEVT_CHECKBOX, &SearchResultsPanel::OnQueryChanged, this);
+    m_indexed->Bind(wxEVT_CHECKBOX, &SearchResultsPanel::OnQueryChanged, this);
+
+    m_pollTimer.SetOwner(this);
+    this->Bind(wxEVT_TIMER, &SearchResultsPanel::OnPollTimer, this);
+
+    m_events.RegisterOndDataUpdated(this);
+  }
+
+  SearchResultsPanel::~SearchResultsPanel()
+  {
+    m_pollTimer.Stop();
+    m_search.Cancel();
+  }
+
+  void SearchResultsPanel::SuspendSearch()
+  {
+    m_search.Suspend();
+  }
+
+  void SearchResultsPanel::SetIndex(const search::TokenIndex *index)
+  {
+    // takes effect with the next search, the data is about to change
+    m_index = index;
+    m_indexed->Enable(m_index != nullptr);
+    if (m_index == nullptr)
+      m_indexed->SetValue(false);
+  }
+
+  void SearchResultsPanel::OnDataUpdated()
+  {
+    // the rows found so far may be gone
+    restartSearch();
+  }
+
+  void SearchResultsPanel::OnDataAppended(const std::size_t first, const std::size_t last)
+  {
+    if (isIndexQuery())
+      queryIndex();
+    else
+      resumeSearch();
+  }
+
+  void SearchResultsPanel::OnCurrentIndexUpdated(const int index)
+  {
+    // do nothing
+  }
+
+  void SearchResultsPanel::OnQueryChanged(wxCommandEvent &event)
+  {
+    restartSearch();
+  }
+
+  void SearchResultsPanel::OnPollTimer(wxTimerEvent &event)
+  {
+    m_search.Poll();
+    m_results->RefreshResults();
+    if (!m_search.IsRunning())
+      m_pollTimer.Stop();
+    updateStatus();
+  }
+
+  bool SearchResultsPanel::isIndexQuery() const
+  {
+    return m_index != nullptr && m_indexed->IsChecked() && !m_query->GetValue().empty();
+  }
+
+  void SearchResultsPanel::restartSearch()
+  {
+    m_search.Cancel();
+    m_pollTimer.Stop();
+    m_results->SetResults(nullptr, nullptr);
+    m_indexResults.clear();
+
+    if (isIndexQuery())
+    {
+      queryIndex();
+      return;
+    }
+
+    const std::string pattern(m_query->GetValue().utf8_str());
+    if (pattern.empty())
+    {
+      updateStatus();
+      return;
+    }
+    if (m_events.IsLazy())
+    {
+      // the search reads the stored events, the pages loaded on demand have none
+      m_status->SetLabel("Search needs a fully loaded log");
+      this->Layout();
+      return;
+    }
+
+    search::SearchOptions options;
+    options.mode = m_regex->IsChecked() ? search::SearchOptions::Mode::Auto : search::SearchOptions::Mode::Literal;
+    options.caseSensitive = m_matchCase->IsChecked();
+    try
+    {
+      m_search.Start(std::make_shared<const search::Matcher>(pattern, options));
+    }
+    catch (const std::regex_error &)
+    {
+      m_status->SetLabel("Invalid expression");
+      return;
+    }
+
+    m_results->SetResults(&m_search.GetResults(), m_search.GetMatcher());
+    m_pollTimer.Start(m_pollIntervalMs);
+    updateStatus();
+  }
+
+  void SearchResultsPanel::resumeSearch()
+  {
+    if (!m_search.IsActive())
+      return;
+
+    m_search.Resume();
+    if (m_search.IsRunning() && !m_pollTimer.IsRunning())
+      m_pollTimer.Start(m_pollIntervalMs);
+  }
+
+  void SearchResultsPanel::queryIndex()
+  {
+    const std::string query(m_query->GetValue().utf8_str());
+    auto rows = m_index->Find(query);
+    if (!rows)
+    {
+      m_indexResults.clear();
+      m_results->SetResults(nullptr, nullptr);
+      m_status->SetLabel("Not in the index, search without whole words");
+      this->Layout();
+      return;
+    }
+
+    // the index may be ahead of the events handed to the container
+    rows->erase(std::lower_bound(rows->begin(), rows->end(), m_events.Size()), rows->end());
+    const bool grown = !m_indexResults.empty() && rows->size() >= m_indexResults.size();
+    m_indexResults = std::move(*rows);
+
+    if (grown)
+    {
+      // later events only add rows at the end
+      m_results->RefreshResults();
+    }
+    else
+    {
+      // show the field with the first word or value of the query
+      auto term = query.substr(0, query.find(' '));
+      term = term.substr(term.find('=') == std::string::npos ? 0 : term.find('=') + 1);
+      m_indexMatcher = std::make_unique<search::Matcher>(term, search::SearchOptions{search::SearchOptions::Mode::Literal, false});
+      m_results->SetResults(&m_indexResults, m_indexMatcher.get());
+    }
+
+    m_status->SetLabel(std::to_string(m_indexResults.size()) + " matches from the index");
+    this->Layout();
+  }
+
+  void SearchResultsPanel::updateStatus()
+  {
+    if (!m_search.IsActive())
+    {
+      m_status->SetLabel(wxEmptyString);
+      return;
+    }
+
+    std::string status = std::to_string(m_search.GetResults().size()) + " matches";
+    if (m_search.IsRunning())
+      status += " in " + std::to_string(m_search.GetSearchedRows()) + " of " + std::to_string(m_events.Size()) + " events";
+    m_status->SetLabel(status);
+    this->Layout();
+  }
+} // namespace gui
@@ -0,0 +1,71 @@
+#ifndef GUI_SEARCHRESULTSPANEL_HPP
+#define GUI_SEARCHRESULTSPANEL_HPP
+
+#include <wx/wx.h>
+#include <wx/srchctrl.h>
+#include <wx/timer.h>
+
+#include "mvc/view.hpp"
+#include "db/events_container.hpp"
+#include "gui/search_result_list_control.hpp"
+#include "search/container_search.hpp"
+#include "search/matcher.hpp"
+#include "search/token_index.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace gui
+{
+	// Search box and result list of the bottom panel. Every change of the
+	// query cancels the running search and starts a new one over the whole
+	// container; results appear while the scan goes on. With a token index
+	// whole word and field=value queries are answered from the index.
+	class SearchResultsPanel : public wxPanel, public mvc::View
+	{
+	public:
+		SearchResultsPanel(db::EventsContainer &events, wxWindow *parent, const wxWindowID id = wxID_ANY);
+		~SearchResultsPanel();
+
+		// Stops the running scan, it resumes with the next data notification.
+		// Must be called before the container is changed.
+		void SuspendSearch();
+		// index of the loaded events, null if there is none
+		void SetIndex(const search::TokenIndex *index);
+
+		// implement View interface
+		virtual void OnDataUpdated() override;
+		virtual void OnCurrentIndexUpdated(const int index) override;
+		virtual void OnDataAppended(const std::size_t first, const std::size_t last) override;
+
+	private:
+		void OnQueryChanged(wxCommandEvent &event);
+		void OnPollTimer(wxTimerEvent &event);
+
+		void restartSearch();
+		void resumeSearch();
+		void queryIndex();
+		bool isIndexQuery() const;
+		void updateStatus();
+
+	private:
+		db::EventsContainer &m_events;
+		search::ContainerSearch m_search;
+		wxSearchCtrl *m_query{nullptr};
+		wxCheckBox *m_matchCase{nullptr};
+		wxCheckBox *m_regex{nullptr};
+		wxCheckBox *m_indexed{nullptr};
+		wxStaticText *m_status{nullptr};
+		SearchResultListControl *m_results{nullptr};
+		const search::TokenIndex *m_index{nullptr};
+		std::vector<std::size_t> m_indexResults;
+		// finds the field to show for index results
+		std::unique_ptr<search::Matcher> m_indexMatcher;
+		// results are collected from the scan at this interval
+		const int m_pollIntervalMs{30};
+		wxTimer m_pollTimer;
+	};
+
+} // namespace gui
+
+#endif // GUI_SEARCHRESULTSPANEL_HPP
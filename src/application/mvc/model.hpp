@@ -2,32 +2,104 @@
 #define MVC_MODEL_HPP
 
 #include "mvc/view.hpp"
+#include "util/profiler.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
 #include <vector>
-#include <iostream>
-#include <mutex>
 
 namespace mvc
 {
+	// Notifies the registered views of changes to the data. Notifications
+	// raised between BeginUpdate and EndUpdate are merged: appended ranges
+	// join into one, a data change replaces them and only the last current
+	// item is reported. Deferred appends and current items are merged the
+	// same way until Flush.
 	template <typename Container>
 
 	class Model
 	{
 	public:
+		using Clock = std::chrono::steady_clock;
+
 		Model() {};
 		virtual ~Model() {}
-		void RegisterOndDataUpdated(View *view)
+		// `changes` is a mask of Change kinds the view wants to hear about
+		void RegisterOndDataUpdated(View *view, unsigned changes = Change::All)
 		{
-			m_views.push_back(view);
+			m_views.push_back({view, changes});
 		}
 
 		void NotifyDataChanged()
 		{
+			m_pendingChange = true;
+			m_pendingFirst = m_pendingLast = 0;
+			// not deferred, the views would show rows that may be gone meanwhile
+			if (m_updateDepth == 0)
+				deliver();
+		}
+
+		void NotifyDataAppended(const std::size_t first, const std::size_t last)
+		{
+			if (first == last)
+				return;
 
-			for (auto v : m_views)
+			if (!m_pendingChange)
 			{
-				v->OnDataUpdated();
+				if (m_pendingFirst == m_pendingLast)
+					m_pendingFirst = first;
+				m_pendingLast = last;
 			}
+			if (!holding())
+				deliver();
+		}
+
+		// Notifications raised between BeginUpdate and the matching EndUpdate
+		// are merged and delivered once by the outermost EndUpdate.
+		void BeginUpdate()
+		{
+			++m_updateDepth;
+		}
+
+		void EndUpdate()
+		{
+			if (m_updateDepth == 0 || --m_updateDepth > 0)
+				return;
+			// a data change raised inside the update does not wait for Flush
+			if (!m_deferred || m_pendingChange)
+				deliver();
+		}
+
+		// From now on appends and current item changes are only delivered by
+		// Flush, merged and at most once per `interval`, e.g. once per frame
+		// from idle time. Data changes still go out right away.
+		void DeferNotifications(const Clock::duration interval)
+		{
+			m_deferred = true;
+			m_interval = interval;
+		}
+
+		// delivers the pending notifications unless the last delivery was
+		// less than the interval ago or an update is open; true if it did
+		bool Flush(const Clock::time_point now = Clock::now())
+		{
+			if (m_updateDepth > 0 || !HasPending())
+				return false;
+			if (m_lastFlush && now - *m_lastFlush < m_interval)
+				return false;
+			m_lastFlush = now;
+			deliver();
+			return true;
+		}
+
+		bool HasPending() const
+		{
+			return m_pendingChange || m_pendingFirst != m_pendingLast || m_pendingCurrent;
 		}
 
 		int GetCurrentItemIndex()
@@ -38,19 +110,43 @@ namespace mvc
 		void SetCurrentItem(const int item)
 		{
 			m_currentItem = item;
-			for (auto v : m_views)
-			{
-				v->OnCurrentIndexUpdated(item);
-			}
+			m_pendingCurrent = true;
+			if (!holding())
+				deliver();
 		}
 
 		void AddItem(auto &&item)
 		{
-			m_data.push_back(item);
+			m_data.push_back(std::forward<decltype(item)>(item));
+			this->NotifyDataAppended(m_data.size() - 1, m_data.size());
+		}
+
+		// appends the whole range, moving from it if it is an rvalue
+		template <std::ranges::input_range Range>
+		void AddItems(Range &&items)
+		{
+			auto first = m_data.size();
+			if constexpr (std::is_rvalue_reference_v<Range &&>)
+				std::ranges::move(items, std::back_inserter(m_data));
+			else
+				std::ranges::copy(items, std::back_inserter(m_data));
+			this->NotifyDataAppended(first, m_data.size());
+		}
+
+		// makes room for this many items in total
+		void Reserve(const std::size_t count)
+		{
+			m_data.reserve(count);
+		}
+
+		void Clear()
+		{
+			m_data.clear();
+			m_currentItem = -1;
 			this->NotifyDataChanged();
 		}
 
-		auto &GetItem(const int index)
+		decltype(auto) GetItem(const int index)
 		{
 			return m_data.at(index);
 		}
@@ -62,10 +158,56 @@ namespace mvc
 
 	protected:
 		Container m_data;
-		int m_currentItem;
+		int m_currentItem{-1};
+
+	private:
+		struct Subscription
+		{
+			View *view;
+			unsigned changes;
+		};
+
+		bool holding() const
+		{
+			return m_updateDepth > 0 || m_deferred;
+		}
+
+		void deliver()
+		{
+			LOGVIEWER_PROFILE_SCOPE("Model::Notify");
+			// views may raise notifications of their own, they start a new round
+			const bool changed = std::exchange(m_pendingChange, false);
+			const auto first = std::exchange(m_pendingFirst, 0);
+			const auto last = std::exchange(m_pendingLast, 0);
+			const bool current = std::exchange(m_pendingCurrent, false);
+
+			for (const auto &[view, changes] : m_views)
+			{
+				if (changed && (changes & Change::Data))
+					view->OnDataUpdated();
+				else if (!changed && first != last && (changes & Change::Appended))
+					view->OnDataAppended(first, last);
+			}
+			if (current)
+			{
+				for (const auto &[view, changes] : m_views)
+				{
+					if (changes & Change::CurrentIndex)
+						view->OnCurrentIndexUpdated(m_currentItem);
+				}
+			}
+		}
 
 	private:
-		std::vector<View *> m_views;
+		std::vector<Subscription> m_views;
+		int m_updateDepth{0};
+		bool m_pendingChange{false};
+		std::size_t m_pendingFirst{0};
+		std::size_t m_pendingLast{0};
+		bool m_pendingCurrent{false};
+		bool m_deferred{false};
+		Clock::duration m_interval{};
+		std::optional<Clock::time_point> m_lastFlush;
 	};
 
 } // namespace mvc
@@ -1,8 +1,22 @@
 #ifndef MVC_VIEW_HPP
 #define MVC_VIEW_HPP
 
+#include <cstddef>
+
 namespace mvc
 {
+	// kinds of change a view is notified of, see Model::RegisterOndDataUpdated
+	struct Change
+	{
+		enum : unsigned
+		{
+			Data = 1 << 0,
+			Appended = 1 << 1,
+			CurrentIndex = 1 << 2,
+			All = Data | Appended | CurrentIndex
+		};
+	};
+
 	class View
 	{
 	public:
@@ -10,6 +24,12 @@ namespace mvc
 		virtual ~View() {}
 		virtual void OnDataUpdated() = 0;
 		virtual void OnCurrentIndexUpdated(const int index) = 0;
+		// Items [first, last) were appended. Views that cannot update
+		// incrementally get a plain data changed notification.
+		virtual void OnDataAppended(const std::size_t, const std::size_t)
+		{
+			OnDataUpdated();
+		}
 	};
 
 } // namespace mvc
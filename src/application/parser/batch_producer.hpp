@@ -0,0 +1,39 @@
+#ifndef PARSER_BATCHPRODUCER_HPP
+#define PARSER_BATCHPRODUCER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "db/event.hpp"
+
+namespace parser
+{
+	// Consumer side of a worker that parses events on threads of its own
+	// and hands them over to a single consumer thread in batches.
+	class BatchProducer
+	{
+	public:
+		using Batch = std::vector<db::Event>;
+
+		virtual ~BatchProducer() = default;
+
+		// Called on a worker thread with every batch before it is queued,
+		// for consumers that only need to look at the events. Set it before
+		// the worker is started.
+		virtual void SetBatchObserver(std::function<void(const Batch &)> observer) = 0;
+		virtual void Join() = 0;
+
+		virtual bool TryPopBatch(Batch &batch) = 0;
+		// true once parsing is done and every batch has been popped
+		virtual bool IsFinished() const = 0;
+		// error raised while parsing, valid once IsFinished() returns true
+		virtual const std::string &GetError() const = 0;
+		virtual uint64_t GetCurrentProgress() const = 0;
+		virtual uint64_t GetTotalProgress() const = 0;
+	};
+
+} // namespace parser
+
+#endif // PARSER_BATCHPRODUCER_HPP
@@ -0,0 +1,87 @@
+#include "parser/compressed_log_parser.hpp"
+
+#include <utility>
+
+namespace parser
+{
+  CompressedLogParser::CompressedLogParser(std::unique_ptr<DataParser> parser, util::ThreadPool &pool)
+      : m_parser(std::move(parser)), m_pool(pool)
+  {
+    m_parser->RegisterObserver(this);
+  }
+
+  void CompressedLogParser::ParseData(std::istream &input)
+  {
+    m_compressed = false;
+    m_parser->SetStopToken(GetStopToken());
+    m_parser->ParseData(input);
+  }
+
+  void CompressedLogParser::ParseData(const std::filesystem::path &file)
+  {
+    m_parser->SetStopToken(GetStopToken());
+    if (util::CompressedFile::Detect(file) == util::CompressedFile::Format::None)
+    {
+      m_compressed = false;
+      m_parser->ParseData(file);
+      return;
+    }
+
+    util::CompressedFile decompressed(file, m_pool);
+    m_input = &decompressed;
+    m_currentProgress = 0;
+    m_totalProgress = decompressed.GetCompressedSize();
+    m_compressed = true;
+
+    std::istream input(&decompressed);
+    try
+    {
+      m_parser->ParseData(input);
+    }
+    catch (...)
+    {
+      m_input = nullptr;
+      throw;
+    }
+    m_input = nullptr;
+    m_currentProgress = decompressed.GetCompressedConsumed();
+    // the stream ends early on an error as well
+    if (!IsStopRequested())
+      decompressed.Check();
+  }
+
+  uint64_t CompressedLogParser::GetCurrentProgress() const
+  {
+    return m_compressed ? m_currentProgress.load() : m_parser->GetCurrentProgress();
+  }
+
+  uint64_t CompressedLogParser::GetTotalProgress() const
+  {
+    return m_compressed ? m_totalProgress.load() : m_parser->GetTotalProgress();
+  }
+
+  db::Event &CompressedLogParser::GetEvent() const
+  {
+    return m_parser->GetEvent();
+  }
+
+  void CompressedLogParser::ProgressUpdated() const
+  {
+    if (m_input != nullptr)
+      m_currentProgress = m_input->GetCompressedConsumed();
+    // the observer interface reports through a const call, the observers
+    // of this parser are told from the same thread
+    const_cast<CompressedLogParser *>(this)->SendProgress();
+  }
+
+  void CompressedLogParser::NewEventFound(db::Event &&event)
+  {
+    NewEventNotification(std::move(event));
+  }
+
+  void CompressedLogParser::InputIdle()
+  {
+    SendIdle();
+  }
+
+} // namespace parser
@@ -0,0 +1,51 @@
+#ifndef PARSER_COMPRESSEDLOGPARSER_HPP
+#define PARSER_COMPRESSEDLOGPARSER_HPP
+
+#include <atomic>
+#include <filesystem>
+#include <istream>
+#include <memory>
+
+#include "parser/data_parser.hpp"
+#include "util/compressed_file.hpp"
+#include "util/thread_pool.hpp"
+
+namespace parser
+{
+	// Puts a decompression stage in front of another parser, so gzip and
+	// zstd compressed logs open like plain ones: the file is decompressed
+	// on a thread of its own while the parser reads it as a stream. Plain
+	// files go to the parser as they are. Progress is measured in bytes of
+	// the compressed file.
+	class CompressedLogParser : public DataParser, private DataParserObserver
+	{
+	public:
+		explicit CompressedLogParser(std::unique_ptr<DataParser> parser, util::ThreadPool &pool = util::ThreadPool::Shared());
+
+		void ParseData(std::istream &input) override;
+		// throws std::runtime_error for corrupt or truncated compressed data
+		void ParseData(const std::filesystem::path &file) override;
+
+		uint64_t GetCurrentProgress() const override;
+		uint64_t GetTotalProgress() const override;
+		db::Event &GetEvent() const override;
+
+	private:
+		// implement DataParserObserver interface, forwards what the parser reports
+		void ProgressUpdated() const override;
+		void NewEventFound(db::Event &&event) override;
+		void InputIdle() override;
+
+	private:
+		std::unique_ptr<DataParser> m_parser;
+		util::ThreadPool &m_pool;
+		// the input being parsed, on the parsing thread
+		const util::CompressedFile *m_input{nullptr};
+		std::atomic<bool> m_compressed{false};
+		mutable std::atomic<uint64_t> m_currentProgress{0};
+		std::atomic<uint64_t> m_totalProgress{0};
+	};
+
+} // namespace parser
+
+#endif // PARSER_COMPRESSEDLOGPARSER_HPP
@@ -1,10 +1,17 @@
 #ifndef PARSER_DATAPARSER_HPP
 #define PARSER_DATAPARSER_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <istream>
+#include <stdexcept>
 #include <vector>
 
 #include "db/event.hpp"
+#include "util/profiler.hpp"
 
 namespace parser
 {
@@ -14,22 +21,39 @@ namespace parser
 	public:
 		virtual void ProgressUpdated() const = 0;
 		virtual void NewEventFound(db::Event &&event) = 0;
+		// the parser caught up with its input and waits for more of it
+		virtual void InputIdle() {}
 	};
 
 	class DataParser
 	{
 	public:
+		virtual ~DataParser() = default;
 		virtual void ParseData(std::istream &input) = 0;
-		virtual uint32_t GetCurrentProgress() const = 0;
-		virtual uint32_t GetTotalProgress() const = 0;
+		virtual void ParseData(const std::filesystem::path &file)
+		{
+			std::ifstream input(file, std::ios::binary);
+			if (!input)
+				throw std::runtime_error("Cannot open " + file.string());
+			ParseData(input);
+		}
+		// progress is measured in bytes of input
+		virtual uint64_t GetCurrentProgress() const = 0;
+		virtual uint64_t GetTotalProgress() const = 0;
 		virtual db::Event &GetEvent() const = 0;
 
+		// The last observer takes the event, the ones before it get a copy.
+		// With the usual single observer nothing is copied.
 		void NewEventNotification(db::Event &&event)
 		{
-			for (auto o : observers)
+			LOGVIEWER_PROFILE_SCOPE("DataParser::NewEventNotification");
+			if (observers.empty())
+				return;
+			for (std::size_t i = 0; i + 1 < observers.size(); ++i)
 			{
-				o->NewEventFound(std::move(event));
+				observers[i]->NewEventFound(db::Event(event));
 			}
+			observers.back()->NewEventFound(std::move(event));
 		}
 
 		void SendProgress()
@@ -39,13 +63,38 @@ namespace parser
 				o->ProgressUpdated();
 			}
 		}
+
+		void SendIdle()
+		{
+			for (auto o : observers)
+			{
+				o->InputIdle();
+			}
+		}
 		void RegisterObserver(DataParserObserver *observer)
 		{
 			observers.push_back(observer);
 		}
 
+		// Parsing stops early once `stopRequested` becomes true.
+		void SetStopToken(const std::atomic<bool> *stopRequested)
+		{
+			m_stopRequested = stopRequested;
+		}
+
+		const std::atomic<bool> *GetStopToken() const
+		{
+			return m_stopRequested;
+		}
+
+		bool IsStopRequested() const
+		{
+			return m_stopRequested != nullptr && m_stopRequested->load(std::memory_order_relaxed);
+		}
+
 	private:
 		std::vector<DataParserObserver *> observers;
+		const std::atomic<bool> *m_stopRequested{nullptr};
 	};
 
 } // namespace parser
@@ -0,0 +1,189 @@
+#include "parser/merge_worker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "db/event_store.hpp"
+
+namespace parser
+{
+  MergeWorker::MergeWorker(std::vector<std::unique_ptr<DataParser>> parsers, const std::atomic<bool> &stopRequested,
+                           std::size_t batchSize, std::size_t queueCapacity)
+      : m_stopRequested(stopRequested), m_batchSize(batchSize), m_queue(queueCapacity)
+  {
+    if (parsers.size() > std::size_t(UINT16_MAX) + 1)
+      throw std::invalid_argument("MergeWorker: too many logs");
+    m_cursors.resize(parsers.size());
+    for (std::size_t i = 0; i < parsers.size(); ++i)
+      m_cursors[i].worker = std::make_unique<ParserWorker>(std::move(parsers[i]), m_stopRequested, batchSize, queueCapacity);
+    m_batch.reserve(m_batchSize);
+  }
+
+  MergeWorker::~MergeWorker()
+  {
+    Join();
+  }
+
+  void MergeWorker::Start(const std::vector<std::filesystem::path> &files)
+  {
+    if (files.size() != m_cursors.size())
+      throw std::invalid_argument("MergeWorker::Start: one file per parser expected");
+    m_done = false;
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+      m_cursors[i].file = files[i];
+      m_cursors[i].worker->Start(files[i]);
+    }
+    m_thread = std::thread(&MergeWorker::run, this);
+  }
+
+  void MergeWorker::SetBatchObserver(std::function<void(const Batch &)> observer)
+  {
+    m_batchObserver = std::move(observer);
+  }
+
+  void MergeWorker::Join()
+  {
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  bool MergeWorker::TryPopBatch(Batch &batch)
+  {
+    return m_queue.TryPop(batch);
+  }
+
+  bool MergeWorker::IsFinished() const
+  {
+    // the last batch is pushed before m_done is released
+    return m_done.load(std::memory_order_acquire) && m_queue.Empty();
+  }
+
+  const std::string &MergeWorker::GetError() const
+  {
+    return m_error;
+  }
+
+  uint64_t MergeWorker::GetCurrentProgress() const
+  {
+    return std::accumulate(m_cursors.begin(), m_cursors.end(), uint64_t(0), [](uint64_t total, const Cursor &cursor)
+                           { return total + cursor.worker->GetCurrentProgress(); });
+  }
+
+  uint64_t MergeWorker::GetTotalProgress() const
+  {
+    return std::accumulate(m_cursors.begin(), m_cursors.end(), uint64_t(0), [](uint64_t total, const Cursor &cursor)
+                           { return total + cursor.worker->GetTotalProgress(); });
+  }
+
+  void MergeWorker::run()
+  {
+    // cursors at an event, the earliest on top of the heap
+    auto later = [this](std::size_t left, std::size_t right)
+    {
+      const auto leftTime = m_cursors[left].time;
+      const auto rightTime = m_cursors[right].time;
+      return leftTime > rightTime || (leftTime == rightTime && left > right);
+    };
+    std::vector<std::size_t> heap;
+    heap.reserve(m_cursors.size());
+    // cursors that have to show their next event before the earliest is known
+    std::vector<std::size_t> waiting(m_cursors.size());
+    std::iota(waiting.begin(), waiting.end(), std::size_t(0));
+
+    while (!m_stopRequested.load(std::memory_order_relaxed))
+    {
+      for (auto next = waiting.begin(); next != waiting.end();)
+      {
+        auto &cursor = m_cursors[*next];
+        if (advance(cursor))
+        {
+          heap.push_back(*next);
+          std::ranges::push_heap(heap, later);
+          next = waiting.erase(next);
+        }
+        else if (cursor.worker->IsFinished())
+        {
+          next = waiting.erase(next);
+        }
+        else
+        {
+          ++next;
+        }
+      }
+
+      if (!waiting.empty())
+      {
+        // hand over what is merged while a parser catches up
+        if (!m_batch.empty())
+          pushBatch();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      if (heap.empty())
+        break;
+
+      std::ranges::pop_heap(heap, later);
+      const auto source = heap.back();
+      heap.pop_back();
+      auto &cursor = m_cursors[source];
+      auto &event = cursor.batch[cursor.position++];
+      event.setSource(static_cast<db::SourceId>(source));
+      m_batch.push_back(std::move(event));
+      if (m_batch.size() >= m_batchSize)
+        pushBatch();
+      waiting.push_back(source);
+    }
+
+    if (!m_batch.empty())
+      pushBatch();
+    for (auto &cursor : m_cursors)
+    {
+      cursor.worker->Join();
+      if (cursor.worker->GetError().empty())
+        continue;
+      if (!m_error.empty())
+        m_error += '\n';
+      m_error += cursor.file.string() + ": " + cursor.worker->GetError();
+    }
+    m_done.store(true, std::memory_order_release);
+  }
+
+  bool MergeWorker::advance(Cursor &cursor)
+  {
+    while (cursor.position >= cursor.batch.size())
+    {
+      if (!cursor.worker->TryPopBatch(cursor.batch))
+        return false;
+      cursor.position = 0;
+    }
+
+    if (auto time = db::ParseTimestamp(cursor.batch[cursor.position].findByKey(db::EventStore::kTimeField)))
+      cursor.time = *time;
+    return true;
+  }
+
+  void MergeWorker::pushBatch()
+  {
+    if (m_batchObserver)
+      m_batchObserver(m_batch);
+
+    // the queue is bounded, so a slow consumer throttles the merge and
+    // with it the parsers
+    while (!m_queue.TryPush(std::move(m_batch)))
+    {
+      if (m_stopRequested.load(std::memory_order_relaxed))
+      {
+        m_batch.clear();
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    m_batch = Batch();
+    m_batch.reserve(m_batchSize);
+  }
+
+} // namespace parser
@@ -0,0 +1,83 @@
+#ifndef PARSER_MERGEWORKER_HPP
+#define PARSER_MERGEWORKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db/event.hpp"
+#include "db/timestamp.hpp"
+#include "parser/batch_producer.hpp"
+#include "parser/data_parser.hpp"
+#include "parser/parser_worker.hpp"
+#include "util/spsc_queue.hpp"
+
+namespace parser
+{
+	// Parses several logs at once, each by its own DataParser on its own
+	// ParserWorker, and merges their events by timestamp into one stream
+	// as they come. Each log has a cursor into the batch it is read from
+	// and a heap picks the earliest of the cursors, so the merge holds no
+	// more than the batches in flight; nothing is concatenated or sorted.
+	// An event without a timestamp goes with the event before it in its
+	// log, events of the same time keep the order of the logs given.
+	//
+	// Every event gets the position of its log as db::SourceId. An event
+	// is only merged once every log still parsing has shown its next one,
+	// so a slow log holds the others back until its parser catches up.
+	class MergeWorker : public BatchProducer
+	{
+	public:
+		MergeWorker(std::vector<std::unique_ptr<DataParser>> parsers, const std::atomic<bool> &stopRequested,
+					std::size_t batchSize = 4096, std::size_t queueCapacity = 64);
+		~MergeWorker();
+
+		// as many files as parsers, the first file goes to the first parser
+		void Start(const std::vector<std::filesystem::path> &files);
+
+		// implement BatchProducer interface
+		void SetBatchObserver(std::function<void(const Batch &)> observer) override;
+		void Join() override;
+		bool TryPopBatch(Batch &batch) override;
+		bool IsFinished() const override;
+		// errors of all logs that failed, the others are merged regardless
+		const std::string &GetError() const override;
+		uint64_t GetCurrentProgress() const override;
+		uint64_t GetTotalProgress() const override;
+
+	private:
+		struct Cursor
+		{
+			std::unique_ptr<ParserWorker> worker;
+			std::filesystem::path file;
+			Batch batch;
+			std::size_t position{0};
+			// time of the event at the position
+			db::Timestamp time{INT64_MIN};
+		};
+
+		void run();
+		// moves the cursor to the next event, false if it has to wait for a batch
+		bool advance(Cursor &cursor);
+		void pushBatch();
+
+	private:
+		const std::atomic<bool> &m_stopRequested;
+		const std::size_t m_batchSize;
+		std::vector<Cursor> m_cursors;
+		util::SpscQueue<Batch> m_queue;
+		Batch m_batch;
+		std::function<void(const Batch &)> m_batchObserver;
+		std::string m_error;
+		std::atomic<bool> m_done{false};
+		std::thread m_thread;
+	};
+
+} // namespace parser
+
+#endif // PARSER_MERGEWORKER_HPP
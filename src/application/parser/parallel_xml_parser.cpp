@@ -0,0 +1,120 @@
+#include "parser/parallel_xml_parser.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+
+#include "util/mapped_file.hpp"
+
+namespace parser
+{
+  ParallelXmlParser::ParallelXmlParser(std::string eventElement, std::size_t chunkSize, util::ThreadPool &pool)
+      : XmlParser(std::move(eventElement)), m_chunkSize(std::max<std::size_t>(chunkSize, 1)), m_pool(pool)
+  {
+  }
+
+  void ParallelXmlParser::ParseData(const std::filesystem::path &file)
+  {
+    std::error_code error;
+    auto size = std::filesystem::file_size(file, error);
+    if (error || m_pool.Size() < 2 || size < 2 * m_chunkSize)
+    {
+      XmlParser::ParseData(file);
+      return;
+    }
+
+    util::MappedFile mapping(file);
+    reset(mapping.Size());
+    auto data = mapping.View();
+    const std::size_t chunks = (data.size() + m_chunkSize - 1) / m_chunkSize;
+    // bounds the memory held by parsed but not yet delivered chunks
+    const std::size_t maxInFlight = 2 * m_pool.Size();
+
+    std::deque<std::future<Chunk>> inFlight;
+    std::size_t submitted = 0;
+    auto waitAll = [&inFlight]
+    {
+      for (auto &future : inFlight)
+        future.wait();
+      inFlight.clear();
+    };
+
+    try
+    {
+      bool first = true;
+      std::size_t expected = 0;
+      while (submitted < chunks || !inFlight.empty())
+      {
+        while (submitted < chunks && inFlight.size() < maxInFlight && !IsStopRequested())
+        {
+          auto begin = submitted * m_chunkSize;
+          auto end = std::min(begin + m_chunkSize, data.size());
+          inFlight.push_back(m_pool.Submit([this, data, begin, end]
+                                           { return parseChunk(data, begin, end); }));
+          ++submitted;
+        }
+        if (inFlight.empty() || IsStopRequested())
+          break;
+
+        auto chunk = inFlight.front().get();
+        inFlight.pop_front();
+        const auto chunkBegin = chunk.begin;
+
+        if (!first && chunk.firstSeen != expected)
+          chunk = parseChunk(data, expected == std::string_view::npos ? data.size() : expected, chunk.end);
+        first = false;
+
+        for (auto &event : chunk.events)
+        {
+          event.setId(m_nextId++);
+          NewEventNotification(std::move(event));
+        }
+        expected = chunk.next;
+
+        mapping.ReleaseRange(chunkBegin, chunk.end - chunkBegin);
+        updateProgress(chunk.end);
+      }
+    }
+    catch (...)
+    {
+      // the tasks still read from the mapping
+      waitAll();
+      throw;
+    }
+    waitAll();
+
+    if (!IsStopRequested())
+    {
+      m_currentProgress = data.size();
+      SendProgress();
+    }
+  }
+
+  ParallelXmlParser::Chunk ParallelXmlParser::parseChunk(std::string_view data, std::size_t begin,
+                                                         std::size_t end) const
+  {
+    Chunk chunk;
+    chunk.begin = begin;
+    chunk.end = end;
+
+    std::size_t pos = std::min(begin, data.size());
+    while (!IsStopRequested())
+    {
+      auto span = m_scanner.FindNextEvent(data, pos);
+      if (!span)
+        break;
+      if (chunk.firstSeen == std::string_view::npos)
+        chunk.firstSeen = span->begin;
+      if (span->begin >= end)
+      {
+        chunk.next = span->begin;
+        break;
+      }
+
+      auto &event = chunk.events.emplace_back(0);
+      m_scanner.ParseEvent(data.substr(span->begin, span->end - span->begin), event);
+    }
+    return chunk;
+  }
+
+} // namespace parser
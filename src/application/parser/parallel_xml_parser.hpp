@@ -0,0 +1,51 @@
+#ifndef PARSER_PARALLELXMLPARSER_HPP
+#define PARSER_PARALLELXMLPARSER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parser/xml_parser.hpp"
+#include "util/thread_pool.hpp"
+
+namespace parser
+{
+	// Parses a memory mapped file in chunks on a thread pool. Chunks are cut
+	// at fixed offsets and every chunk looks for its first event on its own;
+	// when the events are stitched back in file order each chunk is checked
+	// against the boundary found by its predecessor and parsed again from
+	// there if they disagree (e.g. a chunk that started inside a comment).
+	// Streams are parsed sequentially. Must not be called from a pool thread.
+	class ParallelXmlParser : public XmlParser
+	{
+	public:
+		explicit ParallelXmlParser(std::string eventElement = "event", std::size_t chunkSize = 16 << 20,
+								   util::ThreadPool &pool = util::ThreadPool::Shared());
+
+		using XmlParser::ParseData;
+		void ParseData(const std::filesystem::path &file) override;
+
+	private:
+		struct Chunk
+		{
+			std::size_t begin{0};
+			std::size_t end{0};
+			// start of the first event the scan found, inside the chunk or not
+			std::size_t firstSeen{std::string_view::npos};
+			// start of the first event at or after `end`, where the next chunk has to begin
+			std::size_t next{std::string_view::npos};
+			// numbered when they are delivered
+			std::vector<db::Event> events;
+		};
+
+		Chunk parseChunk(std::string_view data, std::size_t begin, std::size_t end) const;
+
+	private:
+		const std::size_t m_chunkSize;
+		util::ThreadPool &m_pool;
+	};
+
+} // namespace parser
+
+#endif // PARSER_PARALLELXMLPARSER_HPP
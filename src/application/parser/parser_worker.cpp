@@ -0,0 +1,121 @@
+#include "parser/parser_worker.hpp"
+
+#include <chrono>
+#include <exception>
+#include <utility>
+
+namespace parser
+{
+  ParserWorker::ParserWorker(std::unique_ptr<DataParser> parser, const std::atomic<bool> &stopRequested,
+                             std::size_t batchSize, std::size_t queueCapacity)
+      : m_parser(std::move(parser)), m_stopRequested(stopRequested), m_batchSize(batchSize),
+        m_queue(queueCapacity)
+  {
+    m_parser->RegisterObserver(this);
+    m_parser->SetStopToken(&m_stopRequested);
+    m_batch.reserve(m_batchSize);
+  }
+
+  ParserWorker::~ParserWorker()
+  {
+    Join();
+  }
+
+  void ParserWorker::SetBatchObserver(std::function<void(const Batch &)> observer)
+  {
+    m_batchObserver = std::move(observer);
+  }
+
+  void ParserWorker::Start(const std::filesystem::path &file)
+  {
+    m_done = false;
+    m_thread = std::thread(&ParserWorker::run, this, file);
+  }
+
+  void ParserWorker::Join()
+  {
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  bool ParserWorker::TryPopBatch(Batch &batch)
+  {
+    return m_queue.TryPop(batch);
+  }
+
+  bool ParserWorker::IsFinished() const
+  {
+    // the last batch is pushed before m_done is released
+    return m_done.load(std::memory_order_acquire) && m_queue.Empty();
+  }
+
+  const std::string &ParserWorker::GetError() const
+  {
+    return m_error;
+  }
+
+  uint64_t ParserWorker::GetCurrentProgress() const
+  {
+    return m_parser->GetCurrentProgress();
+  }
+
+  uint64_t ParserWorker::GetTotalProgress() const
+  {
+    return m_parser->GetTotalProgress();
+  }
+
+  void ParserWorker::ProgressUpdated() const
+  {
+    // the consumer polls the progress at its own pace
+  }
+
+  void ParserWorker::NewEventFound(db::Event &&event)
+  {
+    m_batch.push_back(std::move(event));
+    if (m_batch.size() >= m_batchSize)
+      pushBatch();
+  }
+
+  void ParserWorker::InputIdle()
+  {
+    if (!m_batch.empty())
+      pushBatch();
+  }
+
+  void ParserWorker::run(std::filesystem::path file)
+  {
+    try
+    {
+      LOGVIEWER_PROFILE_SCOPE("DataParser::ParseData");
+      m_parser->ParseData(file);
+    }
+    catch (const std::exception &e)
+    {
+      m_error = e.what();
+    }
+
+    if (!m_batch.empty())
+      pushBatch();
+    m_done.store(true, std::memory_order_release);
+  }
+
+  void ParserWorker::pushBatch()
+  {
+    if (m_batchObserver)
+      m_batchObserver(m_batch);
+
+    // the queue is bounded, so a slow consumer throttles the parser
+    while (!m_queue.TryPush(std::move(m_batch)))
+    {
+      if (m_stopRequested.load(std::memory_order_relaxed))
+      {
+        m_batch.clear();
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    m_batch = Batch();
+    m_batch.reserve(m_batchSize);
+  }
+
+} // namespace parser
@@ -0,0 +1,63 @@
+#ifndef PARSER_PARSERWORKER_HPP
+#define PARSER_PARSERWORKER_HPP
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db/event.hpp"
+#include "parser/batch_producer.hpp"
+#include "parser/data_parser.hpp"
+#include "util/spsc_queue.hpp"
+
+namespace parser
+{
+	// Runs a DataParser on its own thread and hands the parsed events over
+	// to a single consumer thread in batches.
+	class ParserWorker : public DataParserObserver, public BatchProducer
+	{
+	public:
+		ParserWorker(std::unique_ptr<DataParser> parser, const std::atomic<bool> &stopRequested,
+					 std::size_t batchSize = 4096, std::size_t queueCapacity = 64);
+		~ParserWorker();
+
+		void Start(const std::filesystem::path &file);
+
+		// implement BatchProducer interface
+		void SetBatchObserver(std::function<void(const Batch &)> observer) override;
+		void Join() override;
+		bool TryPopBatch(Batch &batch) override;
+		bool IsFinished() const override;
+		const std::string &GetError() const override;
+		uint64_t GetCurrentProgress() const override;
+		uint64_t GetTotalProgress() const override;
+
+		// implement DataParserObserver interface, called on the worker thread
+		void ProgressUpdated() const override;
+		void NewEventFound(db::Event &&event) override;
+		// hands over the events parsed so far instead of waiting for a full batch
+		void InputIdle() override;
+
+	private:
+		void run(std::filesystem::path file);
+		void pushBatch();
+
+	private:
+		std::unique_ptr<DataParser> m_parser;
+		const std::atomic<bool> &m_stopRequested;
+		const std::size_t m_batchSize;
+		util::SpscQueue<Batch> m_queue;
+		Batch m_batch;
+		std::function<void(const Batch &)> m_batchObserver;
+		std::string m_error;
+		std::atomic<bool> m_done{false};
+		std::thread m_thread;
+	};
+
+} // namespace parser
+
+#endif // PARSER_PARSERWORKER_HPP
@@ -0,0 +1,98 @@
+#include "parser/tail_xml_parser.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "util/file_watcher.hpp"
+
+namespace parser
+{
+  namespace
+  {
+    constexpr std::size_t kReadChunk = 1 << 20;
+  } // namespace
+
+  TailXmlParser::TailXmlParser(std::string eventElement, std::chrono::milliseconds idleTimeout)
+      : XmlParser(std::move(eventElement)), m_idleTimeout(idleTimeout)
+  {
+  }
+
+  void TailXmlParser::ParseData(const std::filesystem::path &file)
+  {
+    std::ifstream input(file, std::ios::binary);
+    if (!input)
+      throw std::runtime_error("Cannot open " + file.string());
+    auto watcher = std::make_unique<util::FileWatcher>(file);
+    reset(std::filesystem::file_size(file));
+
+    // bytes of the file read so far, buffer holds the ones past the last
+    // complete event
+    uint64_t read = 0;
+    std::string buffer;
+    while (!IsStopRequested())
+    {
+      // asked first, what the old file got until now is still read
+      const bool replaced = watcher->IsReplaced();
+
+      // the size of the open file, the path may name another one by now
+      input.clear();
+      input.seekg(0, std::ios::end);
+      const auto end = input.tellg();
+      const uint64_t size = end < 0 ? read : static_cast<uint64_t>(end);
+      if (size < read)
+      {
+        // rotated in place, what is there now is new
+        read = 0;
+        buffer.clear();
+      }
+
+      if (size > read)
+      {
+        input.clear();
+        input.seekg(static_cast<std::streamoff>(read));
+        while (read < size && !IsStopRequested())
+        {
+          auto filled = buffer.size();
+          buffer.resize(filled + std::min<uint64_t>(kReadChunk, size - read));
+          input.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+          const auto got = static_cast<std::size_t>(input.gcount());
+          buffer.resize(filled + got);
+          read += got;
+          if (got == 0)
+            break;
+
+          std::string_view data(buffer);
+          std::size_t pos = 0;
+          while (auto span = m_scanner.FindNextEvent(data, pos))
+            emitEvent(data.substr(span->begin, span->end - span->begin));
+          buffer.erase(0, pos);
+        }
+        m_totalProgress = std::max<uint64_t>(m_totalProgress, read);
+        m_currentProgress = read;
+        SendProgress();
+      }
+
+      if (replaced)
+      {
+        // rotated by renaming or deleting: the old file is read to its end,
+        // the new one is followed from its start once it is there
+        std::ifstream next(file, std::ios::binary);
+        if (next)
+        {
+          input = std::move(next);
+          watcher = std::make_unique<util::FileWatcher>(file);
+          read = 0;
+          buffer.clear();
+          continue;
+        }
+      }
+
+      SendIdle();
+      watcher->Wait(m_idleTimeout);
+    }
+  }
+
+} // namespace parser
@@ -0,0 +1,37 @@
+#ifndef PARSER_TAILXMLPARSER_HPP
+#define PARSER_TAILXMLPARSER_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "parser/xml_parser.hpp"
+
+namespace parser
+{
+	// Follows a log that is still being written. The file is parsed up to
+	// its end and then watched, every write is read from where the last
+	// complete event ended, so an event written in pieces is parsed once it
+	// is whole. Nothing is ever read twice. A file that shrinks was rotated
+	// and is followed again from its start. A file renamed or deleted was
+	// rotated too: it is read to its end, then the file that takes its
+	// path is opened and followed from its start. Parsing goes on until
+	// the stop token is set; while the file is idle the parser sleeps in
+	// the watcher.
+	class TailXmlParser : public XmlParser
+	{
+	public:
+		explicit TailXmlParser(std::string eventElement = "event",
+							   std::chrono::milliseconds idleTimeout = std::chrono::milliseconds(200));
+
+		using XmlParser::ParseData;
+		void ParseData(const std::filesystem::path &file) override;
+
+	private:
+		// the stop token is checked at least this often
+		const std::chrono::milliseconds m_idleTimeout;
+	};
+
+} // namespace parser
+
+#endif // PARSER_TAILXMLPARSER_HPP
@@ -0,0 +1,102 @@
+#include "parser/xml_event_index.hpp"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <stdexcept>
+
+namespace parser
+{
+  XmlEventIndex::XmlEventIndex(const std::filesystem::path &file, std::string eventElement, std::size_t chunkSize,
+                               util::ThreadPool &pool)
+      : m_file(file), m_scanner(std::move(eventElement))
+  {
+    auto data = m_file.View();
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    const std::size_t chunks = (data.size() + chunkSize - 1) / chunkSize;
+    if (pool.Size() < 2 || chunks < 2)
+    {
+      append(scanChunk(data, 0, data.size()));
+      return;
+    }
+
+    // the spans are small, every chunk can be in flight at once
+    std::vector<std::future<Chunk>> scans;
+    scans.reserve(chunks);
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+    {
+      auto begin = chunk * chunkSize;
+      auto end = std::min(begin + chunkSize, data.size());
+      scans.push_back(pool.Submit([this, data, begin, end]
+                                  { return scanChunk(data, begin, end); }));
+    }
+
+    try
+    {
+      std::size_t expected = 0;
+      for (std::size_t i = 0; i < scans.size(); ++i)
+      {
+        auto chunk = scans[i].get();
+        if (i > 0 && chunk.firstSeen != expected)
+          chunk = scanChunk(data, expected == std::string_view::npos ? data.size() : expected, chunk.end);
+        append(chunk);
+        expected = chunk.next;
+      }
+    }
+    catch (...)
+    {
+      // the tasks still read from the mapping
+      for (auto &scan : scans)
+        if (scan.valid())
+          scan.wait();
+      throw;
+    }
+  }
+
+  std::size_t XmlEventIndex::Size() const
+  {
+    return m_begins.size();
+  }
+
+  db::Event XmlEventIndex::Load(std::size_t index) const
+  {
+    if (index >= m_begins.size())
+      throw std::out_of_range("XmlEventIndex::Load: index " + std::to_string(index) + " out of range");
+
+    db::Event event(static_cast<int>(index));
+    m_scanner.ParseEvent(m_file.View().substr(m_begins[index], m_lengths[index]), event);
+    return event;
+  }
+
+  XmlEventIndex::Chunk XmlEventIndex::scanChunk(std::string_view data, std::size_t begin, std::size_t end) const
+  {
+    Chunk chunk;
+    chunk.end = end;
+
+    std::size_t pos = std::min(begin, data.size());
+    while (auto span = m_scanner.FindNextEvent(data, pos))
+    {
+      if (chunk.firstSeen == std::string_view::npos)
+        chunk.firstSeen = span->begin;
+      if (span->begin >= end)
+      {
+        chunk.next = span->begin;
+        break;
+      }
+      chunk.spans.push_back(*span);
+    }
+    return chunk;
+  }
+
+  void XmlEventIndex::append(const Chunk &chunk)
+  {
+    for (const auto &span : chunk.spans)
+    {
+      if (span.end - span.begin > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("XmlEventIndex: event at offset " + std::to_string(span.begin) + " is too large");
+      m_begins.push_back(span.begin);
+      m_lengths.push_back(static_cast<uint32_t>(span.end - span.begin));
+    }
+  }
+
+} // namespace parser
@@ -0,0 +1,56 @@
+#ifndef PARSER_XMLEVENTINDEX_HPP
+#define PARSER_XMLEVENTINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "db/event_source.hpp"
+#include "parser/xml_scanner.hpp"
+#include "util/mapped_file.hpp"
+#include "util/thread_pool.hpp"
+
+namespace parser
+{
+	// Offsets of the event elements of a memory mapped XML log. Building it
+	// only looks for element boundaries, chunk by chunk on a thread pool and
+	// stitched like ParallelXmlParser does, so it costs a fraction of a full
+	// parse and 12 bytes per event. An event is parsed when it is loaded.
+	// Must not be built on a pool thread.
+	class XmlEventIndex : public db::EventSource
+	{
+	public:
+		// throws std::runtime_error if the file cannot be mapped
+		explicit XmlEventIndex(const std::filesystem::path &file, std::string eventElement = "event",
+							   std::size_t chunkSize = 16 << 20, util::ThreadPool &pool = util::ThreadPool::Shared());
+
+		std::size_t Size() const override;
+		db::Event Load(std::size_t index) const override;
+
+	private:
+		struct Chunk
+		{
+			std::size_t end{0};
+			// start of the first event the scan found, inside the chunk or not
+			std::size_t firstSeen{std::string_view::npos};
+			// start of the first event at or after `end`
+			std::size_t next{std::string_view::npos};
+			std::vector<XmlElementSpan> spans;
+		};
+
+		Chunk scanChunk(std::string_view data, std::size_t begin, std::size_t end) const;
+		void append(const Chunk &chunk);
+
+	private:
+		util::MappedFile m_file;
+		XmlEventScanner m_scanner;
+		std::vector<uint64_t> m_begins;
+		std::vector<uint32_t> m_lengths;
+	};
+
+} // namespace parser
+
+#endif // PARSER_XMLEVENTINDEX_HPP
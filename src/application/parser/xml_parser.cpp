@@ -0,0 +1,145 @@
+#include "parser/xml_parser.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "util/mapped_file.hpp"
+
+namespace parser
+{
+  namespace
+  {
+    constexpr std::size_t kReadChunk = 1 << 20;
+    // mapped pages behind the cursor are released in windows of this size
+    constexpr std::size_t kReleaseWindow = 64 << 20;
+    constexpr uint64_t kProgressUpdates = 1000;
+    constexpr uint64_t kMinProgressStep = 64 << 10;
+
+    uint64_t streamSize(std::istream &input)
+    {
+      auto start = input.tellg();
+      if (start < 0)
+      {
+        input.clear();
+        return 0;
+      }
+      input.seekg(0, std::ios::end);
+      auto end = input.tellg();
+      input.seekg(start);
+      if (end < 0 || !input)
+      {
+        input.clear();
+        input.seekg(start);
+        return 0;
+      }
+      return static_cast<uint64_t>(end - start);
+    }
+  } // namespace
+
+  XmlParser::XmlParser(std::string eventElement)
+      : m_scanner(std::move(eventElement))
+  {
+  }
+
+  void XmlParser::ParseData(std::istream &input)
+  {
+    reset(streamSize(input));
+
+    std::string buffer;
+    uint64_t consumed = 0; // stream offset of buffer[0]
+    while (input && !IsStopRequested())
+    {
+      auto filled = buffer.size();
+      buffer.resize(filled + kReadChunk);
+      input.read(buffer.data() + filled, kReadChunk);
+      buffer.resize(filled + static_cast<std::size_t>(input.gcount()));
+
+      std::string_view data(buffer);
+      std::size_t pos = 0;
+      while (auto span = m_scanner.FindNextEvent(data, pos))
+      {
+        emitEvent(data.substr(span->begin, span->end - span->begin));
+        updateProgress(consumed + pos);
+        if (IsStopRequested())
+          break;
+      }
+
+      // keep only the incomplete tail for the next round
+      buffer.erase(0, pos);
+      consumed += pos;
+    }
+
+    m_currentProgress = consumed + buffer.size();
+    SendProgress();
+  }
+
+  void XmlParser::ParseData(const std::filesystem::path &file)
+  {
+    util::MappedFile mapping(file);
+    mapping.AdviseSequential();
+    reset(mapping.Size());
+
+    auto data = mapping.View();
+    std::size_t pos = 0;
+    std::size_t released = 0;
+    while (auto span = m_scanner.FindNextEvent(data, pos))
+    {
+      emitEvent(data.substr(span->begin, span->end - span->begin));
+      updateProgress(pos);
+
+      if (pos - released >= kReleaseWindow)
+      {
+        mapping.ReleaseRange(released, pos - released);
+        released = pos;
+      }
+
+      if (IsStopRequested())
+        return;
+    }
+
+    m_currentProgress = data.size();
+    SendProgress();
+  }
+
+  uint64_t XmlParser::GetCurrentProgress() const
+  {
+    return m_currentProgress;
+  }
+
+  uint64_t XmlParser::GetTotalProgress() const
+  {
+    return m_totalProgress;
+  }
+
+  db::Event &XmlParser::GetEvent() const
+  {
+    throw std::logic_error("XmlParser hands parsed events to its observers");
+  }
+
+  void XmlParser::reset(uint64_t total)
+  {
+    m_nextId = 0;
+    m_currentProgress = 0;
+    m_reportedProgress = 0;
+    m_totalProgress = total;
+    m_progressStep = std::max(total / kProgressUpdates, kMinProgressStep);
+  }
+
+  void XmlParser::emitEvent(std::string_view element)
+  {
+    db::Event event(m_nextId++);
+    m_scanner.ParseEvent(element, event);
+    NewEventNotification(std::move(event));
+  }
+
+  void XmlParser::updateProgress(uint64_t offset)
+  {
+    m_currentProgress = offset;
+    if (offset - m_reportedProgress >= m_progressStep)
+    {
+      m_reportedProgress = offset;
+      SendProgress();
+    }
+  }
+
+} // namespace parser
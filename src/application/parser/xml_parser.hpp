@@ -0,0 +1,45 @@
+#ifndef PARSER_XMLPARSER_HPP
+#define PARSER_XMLPARSER_HPP
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "parser/data_parser.hpp"
+#include "parser/xml_scanner.hpp"
+
+namespace parser
+{
+	// Single pass, streaming XML log parser. Every event element found in the
+	// input is handed to the observers as soon as it is complete.
+	class XmlParser : public DataParser
+	{
+	public:
+		explicit XmlParser(std::string eventElement = "event");
+
+		void ParseData(std::istream &input) override;
+		// Memory maps the file instead of reading it through a stream.
+		void ParseData(const std::filesystem::path &file) override;
+
+		uint64_t GetCurrentProgress() const override;
+		uint64_t GetTotalProgress() const override;
+		db::Event &GetEvent() const override;
+
+	protected:
+		void reset(uint64_t total);
+		void emitEvent(std::string_view element);
+		void updateProgress(uint64_t offset);
+
+	protected:
+		XmlEventScanner m_scanner;
+		std::atomic<uint64_t> m_currentProgress{0};
+		std::atomic<uint64_t> m_totalProgress{0};
+		uint64_t m_reportedProgress{0};
+		uint64_t m_progressStep{1};
+		int m_nextId{0};
+	};
+
+} // namespace parser
+
+#endif // PARSER_XMLPARSER_HPP
@@ -0,0 +1,473 @@
+#include "parser/xml_scanner.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace parser
+{
+  namespace
+  {
+    constexpr std::size_t npos = std::string_view::npos;
+
+    bool isSpace(const char c)
+    {
+      return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool isNameEnd(const char c)
+    {
+      return isSpace(c) || c == '>' || c == '/' || c == '=';
+    }
+
+    std::size_t findChar(std::string_view data, const char c, const std::size_t from)
+    {
+      if (from >= data.size())
+        return npos;
+      auto found = static_cast<const char *>(std::memchr(data.data() + from, c, data.size() - from));
+      return found == nullptr ? npos : static_cast<std::size_t>(found - data.data());
+    }
+
+    // Position of the '>' closing the tag that contains `from`, skipping quoted attribute values.
+    std::size_t findTagEnd(std::string_view data, std::size_t from)
+    {
+      while (true)
+      {
+        from = data.find_first_of("\"'>", from);
+        if (from == npos || data[from] == '>')
+          return from;
+        from = findChar(data, data[from], from + 1);
+        if (from == npos)
+          return npos;
+        ++from;
+      }
+    }
+
+    bool isPrefixOf(std::string_view data, std::string_view pattern)
+    {
+      return data.size() < pattern.size() && pattern.starts_with(data);
+    }
+
+    // Skips comments, CDATA sections, processing instructions and declarations starting at `lt`.
+    // Returns the position after the markup, `lt` if it is not special markup and npos if it is incomplete.
+    std::size_t skipSpecial(std::string_view data, const std::size_t lt)
+    {
+      auto rest = data.substr(lt);
+      auto skipTo = [&](std::string_view terminator, std::size_t offset)
+      {
+        auto end = data.find(terminator, lt + offset);
+        return end == npos ? npos : end + terminator.size();
+      };
+
+      if (rest.starts_with("<!--"))
+        return skipTo("-->", 4);
+      if (rest.starts_with("<![CDATA["))
+        return skipTo("]]>", 9);
+      if (rest.starts_with("<?"))
+        return skipTo("?>", 2);
+      if (isPrefixOf(rest, "<!--") || isPrefixOf(rest, "<![CDATA["))
+        return npos;
+      if (rest.starts_with("<!"))
+      {
+        auto end = findTagEnd(data, lt + 2);
+        return end == npos ? npos : end + 1;
+      }
+      return lt;
+    }
+
+    std::string_view readName(std::string_view data, std::size_t &pos)
+    {
+      auto begin = pos;
+      while (pos < data.size() && !isNameEnd(data[pos]))
+        ++pos;
+      return data.substr(begin, pos - begin);
+    }
+
+    void skipSpaces(std::string_view data, std::size_t &pos)
+    {
+      while (pos < data.size() && isSpace(data[pos]))
+        ++pos;
+    }
+
+    std::string_view trim(std::string_view text)
+    {
+      std::size_t begin = 0;
+      std::size_t end = text.size();
+      while (begin < end && isSpace(text[begin]))
+        ++begin;
+      while (end > begin && isSpace(text[end - 1]))
+        --end;
+      return text.substr(begin, end - begin);
+    }
+
+    void appendUtf8(std::uint32_t cp, std::string &out)
+    {
+      if (cp < 0x80)
+      {
+        out.push_back(static_cast<char>(cp));
+      }
+      else if (cp < 0x800)
+      {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+      }
+      else if (cp < 0x10000)
+      {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+      }
+      else
+      {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+      }
+    }
+
+    // Decodes the entity reference `name` (without '&' and ';'). Returns false if it is unknown.
+    bool appendEntity(std::string_view name, std::string &out)
+    {
+      if (name == "lt")
+        out.push_back('<');
+      else if (name == "gt")
+        out.push_back('>');
+      else if (name == "amp")
+        out.push_back('&');
+      else if (name == "quot")
+        out.push_back('"');
+      else if (name == "apos")
+        out.push_back('\'');
+      else if (name.size() > 1 && name[0] == '#')
+      {
+        const bool hex = name[1] == 'x' || name[1] == 'X';
+        std::uint32_t cp = 0;
+        auto digits = name.substr(hex ? 2 : 1);
+        if (digits.empty() || digits.size() > 8)
+          return false;
+        for (const char c : digits)
+        {
+          std::uint32_t digit;
+          if (c >= '0' && c <= '9')
+            digit = c - '0';
+          else if (hex && c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+          else if (hex && c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+          else
+            return false;
+          cp = cp * (hex ? 16 : 10) + digit;
+        }
+        if (cp > 0x10FFFF)
+          return false;
+        appendUtf8(cp, out);
+      }
+      else
+        return false;
+      return true;
+    }
+
+    void appendDecodedEntities(std::string_view raw, std::string &out)
+    {
+      std::size_t pos = 0;
+      while (pos < raw.size())
+      {
+        auto amp = findChar(raw, '&', pos);
+        if (amp == npos)
+        {
+          out.append(raw.substr(pos));
+          return;
+        }
+        out.append(raw.substr(pos, amp - pos));
+        auto semicolon = findChar(raw, ';', amp + 1);
+        if (semicolon == npos || !appendEntity(raw.substr(amp + 1, semicolon - amp - 1), out))
+        {
+          // keep malformed references verbatim
+          out.push_back('&');
+          pos = amp + 1;
+          continue;
+        }
+        pos = semicolon + 1;
+      }
+    }
+  } // namespace
+
+  XmlEventScanner::XmlEventScanner(std::string eventElement)
+      : m_eventElement(std::move(eventElement))
+  {
+  }
+
+  const std::string &XmlEventScanner::GetEventElement() const
+  {
+    return m_eventElement;
+  }
+
+  bool XmlEventScanner::isEventTag(std::string_view data, std::size_t nameBegin) const
+  {
+    auto nameEnd = nameBegin + m_eventElement.size();
+    return nameEnd < data.size() && data.compare(nameBegin, m_eventElement.size(), m_eventElement) == 0 &&
+           isNameEnd(data[nameEnd]);
+  }
+
+  std::optional<XmlElementSpan> XmlEventScanner::FindNextEvent(std::string_view data, std::size_t &pos) const
+  {
+    while (true)
+    {
+      auto lt = findChar(data, '<', pos);
+      if (lt == npos)
+      {
+        pos = data.size();
+        return std::nullopt;
+      }
+
+      auto special = skipSpecial(data, lt);
+      if (special == npos)
+      {
+        pos = lt;
+        return std::nullopt;
+      }
+      if (special != lt)
+      {
+        pos = special;
+        continue;
+      }
+
+      if (lt + m_eventElement.size() + 1 >= data.size())
+      {
+        // too short to tell whether this is an event tag
+        pos = lt;
+        return std::nullopt;
+      }
+
+      if (!isEventTag(data, lt + 1))
+      {
+        pos = lt + 1;
+        continue;
+      }
+
+      auto end = findElementEnd(data, lt);
+      if (end == npos)
+      {
+        pos = lt;
+        return std::nullopt;
+      }
+      pos = end;
+      return XmlElementSpan{lt, end};
+    }
+  }
+
+  std::size_t XmlEventScanner::findElementEnd(std::string_view data, std::size_t begin) const
+  {
+    auto tagEnd = findTagEnd(data, begin + 1);
+    if (tagEnd == npos)
+      return npos;
+    if (data[tagEnd - 1] == '/')
+      return tagEnd + 1;
+
+    int depth = 1;
+    auto pos = tagEnd + 1;
+    while (true)
+    {
+      auto lt = findChar(data, '<', pos);
+      if (lt == npos || lt + 1 >= data.size())
+        return npos;
+
+      auto special = skipSpecial(data, lt);
+      if (special == npos)
+        return npos;
+      if (special != lt)
+      {
+        pos = special;
+        continue;
+      }
+
+      const bool closing = data[lt + 1] == '/';
+      auto end = findTagEnd(data, lt + 1);
+      if (end == npos)
+        return npos;
+
+      if (isEventTag(data, lt + (closing ? 2 : 1)))
+      {
+        if (closing && --depth == 0)
+          return end + 1;
+        if (!closing && data[end - 1] != '/')
+          ++depth;
+      }
+      pos = end + 1;
+    }
+  }
+
+  void XmlEventScanner::ParseEvent(std::string_view element, db::Event &event) const
+  {
+    // the items take about as many bytes as the markup, the buffer is allocated once
+    event.reserve(element.size());
+    // values that need decoding, most are taken from the element as they are
+    std::string decoded;
+
+    // attributes of the event element
+    std::size_t pos = 1 + m_eventElement.size();
+    while (true)
+    {
+      skipSpaces(element, pos);
+      if (pos >= element.size() || element[pos] == '>' || element[pos] == '/')
+        break;
+
+      auto name = readName(element, pos);
+      skipSpaces(element, pos);
+      if (name.empty() || pos >= element.size() || element[pos] != '=')
+      {
+        // not well formed, give up on the remaining attributes
+        pos = findTagEnd(element, pos);
+        break;
+      }
+      ++pos;
+      skipSpaces(element, pos);
+      if (pos >= element.size() || (element[pos] != '"' && element[pos] != '\''))
+      {
+        pos = findTagEnd(element, pos);
+        break;
+      }
+      auto valueEnd = findChar(element, element[pos], pos + 1);
+      if (valueEnd == npos)
+        return;
+
+      auto raw = element.substr(pos + 1, valueEnd - pos - 1);
+      if (raw.find('&') == npos)
+        event.addItem(name, raw);
+      else
+      {
+        decoded.clear();
+        appendDecodedEntities(raw, decoded);
+        event.addItem(name, decoded);
+      }
+      pos = valueEnd + 1;
+    }
+
+    if (pos == npos || pos >= element.size() || element[pos] == '/')
+      return;
+
+    // child elements; the content ends where the closing tag of the event starts
+    auto contentEnd = element.rfind("</");
+    if (contentEnd == npos || contentEnd <= pos)
+      return;
+    auto content = element.substr(0, contentEnd);
+    pos = pos + 1;
+
+    while (true)
+    {
+      auto lt = findChar(content, '<', pos);
+      if (lt == npos || lt + 1 >= content.size())
+        return;
+
+      auto special = skipSpecial(content, lt);
+      if (special == npos)
+        return;
+      if (special != lt || content[lt + 1] == '/')
+      {
+        // stray text, comments and closing tags at event level carry no field
+        pos = special != lt ? special : lt + 2;
+        continue;
+      }
+
+      std::size_t namePos = lt + 1;
+      auto name = readName(content, namePos);
+      auto tagEnd = findTagEnd(content, namePos);
+      if (tagEnd == npos)
+        return;
+      if (content[tagEnd - 1] == '/')
+      {
+        event.addItem(name, std::string_view());
+        pos = tagEnd + 1;
+        continue;
+      }
+
+      // find the matching closing tag, taking nested elements of the same name into account
+      int depth = 1;
+      auto inner = tagEnd + 1;
+      auto cursor = inner;
+      std::size_t innerEnd = npos;
+      while (depth > 0)
+      {
+        auto next = findChar(content, '<', cursor);
+        if (next == npos || next + 1 >= content.size())
+          break;
+        auto skipped = skipSpecial(content, next);
+        if (skipped == npos)
+          break;
+        if (skipped != next)
+        {
+          cursor = skipped;
+          continue;
+        }
+        const bool closing = content[next + 1] == '/';
+        std::size_t childNamePos = next + (closing ? 2 : 1);
+        auto childName = readName(content, childNamePos);
+        auto childEnd = findTagEnd(content, childNamePos);
+        if (childEnd == npos)
+          break;
+        if (childName == name)
+        {
+          if (closing && --depth == 0)
+            innerEnd = next;
+          else if (!closing && content[childEnd - 1] != '/')
+            ++depth;
+        }
+        cursor = childEnd + 1;
+      }
+
+      if (innerEnd == npos)
+        return;
+
+      auto raw = content.substr(inner, innerEnd - inner);
+      if (raw.find_first_of("&<") == npos)
+        event.addItem(name, trim(raw));
+      else
+      {
+        decoded.clear();
+        DecodeText(raw, decoded);
+        event.addItem(name, trim(decoded));
+      }
+      pos = cursor;
+    }
+  }
+
+  void XmlEventScanner::DecodeText(std::string_view raw, std::string &out)
+  {
+    std::size_t pos = 0;
+    while (pos < raw.size())
+    {
+      auto lt = findChar(raw, '<', pos);
+      if (lt == npos)
+      {
+        appendDecodedEntities(raw.substr(pos), out);
+        return;
+      }
+      appendDecodedEntities(raw.substr(pos, lt - pos), out);
+
+      auto rest = raw.substr(lt);
+      if (rest.starts_with("<![CDATA["))
+      {
+        auto end = raw.find("]]>", lt + 9);
+        if (end == npos)
+          end = raw.size();
+        out.append(raw.substr(lt + 9, end - lt - 9));
+        pos = end + 3;
+        continue;
+      }
+      if (rest.starts_with("<!--"))
+      {
+        auto end = raw.find("-->", lt + 4);
+        pos = end == npos ? raw.size() : end + 3;
+        continue;
+      }
+
+      // nested markup is kept as it is
+      auto end = findTagEnd(raw, lt + 1);
+      if (end == npos)
+        end = raw.size() - 1;
+      out.append(raw.substr(lt, end - lt + 1));
+      pos = end + 1;
+    }
+  }
+
+} // namespace parser
@@ -0,0 +1,52 @@
+#ifndef PARSER_XMLSCANNER_HPP
+#define PARSER_XMLSCANNER_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "db/event.hpp"
+
+namespace parser
+{
+	// Byte range [begin, end) of one event element inside a buffer.
+	struct XmlElementSpan
+	{
+		std::size_t begin{0};
+		std::size_t end{0};
+	};
+
+	// Tokenizer for flat XML logs, e.g.
+	//   <event id="1"><timestamp>..</timestamp><type>..</type></event>
+	// It works directly on a buffer and never builds a DOM.
+	class XmlEventScanner
+	{
+	public:
+		explicit XmlEventScanner(std::string eventElement = "event");
+
+		const std::string &GetEventElement() const;
+
+		// Looks for the next complete event element starting at `pos`.
+		// On success `pos` is moved past the element. Otherwise `pos` is moved
+		// to where scanning has to resume once more data is available.
+		std::optional<XmlElementSpan> FindNextEvent(std::string_view data, std::size_t &pos) const;
+
+		// Adds the attributes and the child elements of one event element to
+		// the event as (name, value) items.
+		void ParseEvent(std::string_view element, db::Event &event) const;
+
+		// Appends `raw` to `out` with entity references and CDATA sections resolved.
+		static void DecodeText(std::string_view raw, std::string &out);
+
+	private:
+		bool isEventTag(std::string_view data, std::size_t nameBegin) const;
+		std::size_t findElementEnd(std::string_view data, std::size_t begin) const;
+
+	private:
+		std::string m_eventElement;
+	};
+
+} // namespace parser
+
+#endif // PARSER_XMLSCANNER_HPP
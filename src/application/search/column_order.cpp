@@ -0,0 +1,243 @@
+#include "search/column_order.hpp"
+
+#include <algorithm>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "util/parallel_sort.hpp"
+
+namespace search
+{
+  namespace
+  {
+    // rows a task turns into keys
+    constexpr std::size_t kPartitionRows = 65536;
+
+    // the first bytes of a value as a number that orders as they do
+    uint64_t prefixOf(std::string_view value)
+    {
+      uint64_t prefix = 0;
+      for (std::size_t i = 0; i < sizeof(prefix); ++i)
+        prefix = (prefix << 8) | (i < value.size() ? static_cast<unsigned char>(value[i]) : 0);
+      return prefix;
+    }
+  } // namespace
+
+  // Sorting the keys keeps the comparisons on contiguous memory, the row
+  // makes them unique and keeps ties in order.
+  struct ColumnOrder::Key
+  {
+    uint64_t prefix;
+    db::StringRef ref;
+    uint32_t row;
+    uint32_t size;
+
+    // True if the value ends within the prefix taken at `depth`. Of two
+    // values of the same prefix one that ends there is the smaller one.
+    bool Ends(std::size_t depth) const
+    {
+      return size <= depth + sizeof(prefix);
+    }
+
+    // orders by the prefix taken at `depth`, values that go on beyond the
+    // same one by row until they are refined
+    static bool Less(const Key &left, const Key &right, std::size_t depth)
+    {
+      if (left.prefix != right.prefix)
+        return left.prefix < right.prefix;
+      const bool leftEnds = left.Ends(depth);
+      if (leftEnds != right.Ends(depth))
+        return leftEnds;
+      if (leftEnds && left.size != right.size)
+        return left.size < right.size;
+      return left.row < right.row;
+    }
+
+    static bool Tied(const Key &left, const Key &right, std::size_t depth)
+    {
+      return left.prefix == right.prefix && !left.Ends(depth) && !right.Ends(depth);
+    }
+  };
+
+  ColumnOrder::ColumnOrder(const db::EventStore &store, db::FieldId field, util::ThreadPool &pool)
+      : m_store(store), m_field(field), m_pool(pool)
+  {
+  }
+
+  void ColumnOrder::Assign(std::span<const uint32_t> rows)
+  {
+    auto wait = [](std::vector<std::future<void>> &tasks)
+    {
+      for (auto &task : tasks)
+        task.wait();
+      for (auto &task : tasks)
+        task.get();
+      tasks.clear();
+    };
+
+    std::vector<Key> keys(rows.size());
+    std::vector<std::future<void>> tasks;
+    for (std::size_t first = 0; first < rows.size(); first += kPartitionRows)
+    {
+      const auto last = std::min(first + kPartitionRows, rows.size());
+      tasks.push_back(m_pool.Submit([this, rows, &keys, first, last]
+                                    {
+                                      for (auto i = first; i < last; ++i)
+                                        keys[i] = key(rows[i]); }));
+    }
+    wait(tasks);
+
+    util::ParallelSort(keys, [](const Key &left, const Key &right)
+                       { return Key::Less(left, right, 0); }, m_pool);
+
+    // the runs left tied are refined in partitions that do not split them
+    for (std::size_t first = 0; first < keys.size();)
+    {
+      auto last = std::min(first + kPartitionRows, keys.size());
+      while (last < keys.size() && Key::Tied(keys[last - 1], keys[last], 0))
+        ++last;
+      tasks.push_back(m_pool.Submit([this, part = std::span<Key>(keys).subspan(first, last - first)]
+                                    { refine(part, 0); }));
+      first = last;
+    }
+    wait(tasks);
+
+    m_rows.resize(keys.size());
+    std::ranges::transform(keys, m_rows.begin(), &Key::row);
+  }
+
+  void ColumnOrder::Assign()
+  {
+    if (m_store.size() > UINT32_MAX)
+      throw std::length_error("ColumnOrder: too many events");
+    std::vector<uint32_t> rows(m_store.size());
+    std::iota(rows.begin(), rows.end(), uint32_t(0));
+    Assign(rows);
+  }
+
+  bool ColumnOrder::Add(std::span<const uint32_t> rows)
+  {
+    if (rows.empty())
+      return true;
+
+    std::vector<Key> keys;
+    keys.reserve(rows.size());
+    for (auto row : rows)
+      keys.push_back(key(row));
+    std::ranges::sort(keys, [](const Key &left, const Key &right)
+                      { return Key::Less(left, right, 0); });
+    refine(keys, 0);
+    std::vector<uint32_t> added(keys.size());
+    std::ranges::transform(keys, added.begin(), &Key::row);
+
+    if (m_rows.empty() || before(m_rows.back(), added.front()))
+    {
+      m_rows.insert(m_rows.end(), added.begin(), added.end());
+      return true;
+    }
+
+    std::vector<uint32_t> merged;
+    merged.reserve(m_rows.size() + added.size());
+    std::ranges::merge(m_rows, added, std::back_inserter(merged), [this](uint32_t left, uint32_t right)
+                       { return before(left, right); });
+    m_rows = std::move(merged);
+    return false;
+  }
+
+  bool ColumnOrder::Add(std::size_t first)
+  {
+    if (m_store.size() > UINT32_MAX)
+      throw std::length_error("ColumnOrder: too many events");
+    std::vector<uint32_t> rows(m_store.size() - std::min(first, m_store.size()));
+    std::iota(rows.begin(), rows.end(), static_cast<uint32_t>(first));
+    return Add(rows);
+  }
+
+  void ColumnOrder::Clear()
+  {
+    std::vector<uint32_t>().swap(m_rows);
+  }
+
+  db::FieldId ColumnOrder::GetField() const
+  {
+    return m_field;
+  }
+
+  std::size_t ColumnOrder::Size() const
+  {
+    return m_rows.size();
+  }
+
+  std::size_t ColumnOrder::Row(std::size_t position) const
+  {
+    return m_rows.at(position);
+  }
+
+  std::optional<std::size_t> ColumnOrder::Position(std::size_t row) const
+  {
+    if (row >= m_store.size())
+      return std::nullopt;
+    auto found = std::ranges::lower_bound(m_rows, static_cast<uint32_t>(row), [this](uint32_t left, uint32_t right)
+                                          { return before(left, right); });
+    if (found == m_rows.end() || *found != row)
+      return std::nullopt;
+    return static_cast<std::size_t>(found - m_rows.begin());
+  }
+
+  const std::vector<uint32_t> &ColumnOrder::GetRows() const
+  {
+    return m_rows;
+  }
+
+  ColumnOrder::Key ColumnOrder::key(uint32_t row, std::size_t depth) const
+  {
+    const auto column = m_store.GetColumn(m_field);
+    const auto ref = row < column.size() ? column[row] : db::StringRef();
+    const auto value = m_store.GetString(ref);
+    return {prefixOf(value.substr(std::min(depth, value.size()))), ref, row, static_cast<uint32_t>(value.size())};
+  }
+
+  void ColumnOrder::refine(std::span<Key> keys, std::size_t depth) const
+  {
+    // the runs still tied and the depth they are tied at; a work list rather
+    // than recursion, long equal values would go as deep as they are long
+    std::vector<std::pair<std::span<Key>, std::size_t>> work{{keys, depth}};
+    while (!work.empty())
+    {
+      const auto [part, at] = work.back();
+      work.pop_back();
+      for (std::size_t first = 0; first < part.size();)
+      {
+        auto last = first + 1;
+        bool shared = true;
+        while (last < part.size() && Key::Tied(part[last - 1], part[last], at))
+        {
+          shared = shared && part[last].ref == part[first].ref;
+          ++last;
+        }
+        // a value the run shares is in row order already
+        if (last - first > 1 && !shared)
+        {
+          const auto run = part.subspan(first, last - first);
+          const auto next = at + sizeof(Key::prefix);
+          for (auto &tied : run)
+            tied = key(tied.row, next);
+          std::ranges::sort(run, [next](const Key &left, const Key &right)
+                            { return Key::Less(left, right, next); });
+          work.emplace_back(run, next);
+        }
+        first = last;
+      }
+    }
+  }
+
+  bool ColumnOrder::before(uint32_t left, uint32_t right) const
+  {
+    const auto order = m_store.GetValue(left, m_field).compare(m_store.GetValue(right, m_field));
+    return order < 0 || (order == 0 && left < right);
+  }
+
+} // namespace search
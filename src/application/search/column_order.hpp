@@ -0,0 +1,69 @@
+#ifndef SEARCH_COLUMNORDER_HPP
+#define SEARCH_COLUMNORDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "db/event_store.hpp"
+#include "db/field_dictionary.hpp"
+#include "util/thread_pool.hpp"
+
+namespace search
+{
+	// Rows of an event store ordered by the values of one field, byte wise,
+	// ties in row order, so the order is stable. Events without the field
+	// sort as if it was empty. Only the 4 byte rows are kept, the store is
+	// not touched.
+	// The rows are sorted on the thread pool by the first 8 bytes of their
+	// values, then every run of rows whose values go on beyond the same 8
+	// bytes by the next 8, and so on, so the comparisons stay on contiguous
+	// keys. A run of one value the store shares (levels, types) is done at
+	// once. Rows added later are merged in; like the other orders it is
+	// kept on the thread that appends to the store, see db::EventStore.
+	class ColumnOrder
+	{
+	public:
+		ColumnOrder(const db::EventStore &store, db::FieldId field, util::ThreadPool &pool = util::ThreadPool::Shared());
+
+		// orders these rows, all rows of the store without any
+		void Assign(std::span<const uint32_t> rows);
+		void Assign();
+		// Merges ascending rows that were appended to the store. True if they
+		// all went after the rows ordered already.
+		bool Add(std::span<const uint32_t> rows);
+		// the rows of the store from `first` on
+		bool Add(std::size_t first);
+		void Clear();
+
+		db::FieldId GetField() const;
+		// the rows ordered, rows added to the store later are not among them
+		// until they are added
+		std::size_t Size() const;
+		// store row at a position of the order
+		std::size_t Row(std::size_t position) const;
+		// position of a store row, none if it is not ordered
+		std::optional<std::size_t> Position(std::size_t row) const;
+		const std::vector<uint32_t> &GetRows() const;
+
+	private:
+		struct Key;
+
+		// the key with the 8 bytes of the value from `depth` on
+		Key key(uint32_t row, std::size_t depth = 0) const;
+		// orders the runs of keys the 8 bytes at `depth` left tied
+		void refine(std::span<Key> keys, std::size_t depth) const;
+		bool before(uint32_t left, uint32_t right) const;
+
+	private:
+		const db::EventStore &m_store;
+		db::FieldId m_field;
+		util::ThreadPool &m_pool;
+		std::vector<uint32_t> m_rows;
+	};
+
+} // namespace search
+
+#endif // SEARCH_COLUMNORDER_HPP
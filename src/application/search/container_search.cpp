@@ -0,0 +1,176 @@
+#include "search/container_search.hpp"
+
+#include <algorithm>
+
+namespace search
+{
+  ContainerSearch::ContainerSearch(const db::EventStore &store, util::ThreadPool &pool)
+      : m_store(store), m_pool(pool)
+  {
+  }
+
+  ContainerSearch::~ContainerSearch()
+  {
+    stop();
+  }
+
+  void ContainerSearch::Start(std::shared_ptr<const Matcher> matcher)
+  {
+    stop();
+    m_results.clear();
+    m_matcher = std::move(matcher);
+    launch(0);
+  }
+
+  void ContainerSearch::Cancel()
+  {
+    stop();
+    m_matcher.reset();
+    m_results.clear();
+    m_searchedRows = 0;
+  }
+
+  void ContainerSearch::Suspend()
+  {
+    stop();
+  }
+
+  void ContainerSearch::Resume()
+  {
+    if (m_matcher == nullptr)
+      return;
+    if (IsRunning())
+    {
+      // the partitions claimed go on, Poll starts on the new rows after them
+      m_appended = true;
+      return;
+    }
+    stop();
+    launch(m_searchedRows);
+  }
+
+  std::size_t ContainerSearch::Poll()
+  {
+    if (m_scan == nullptr)
+      return m_results.size();
+
+    {
+      std::lock_guard lock(m_scan->mutex);
+      while (m_published < m_scan->partitions.size() && m_scan->done[m_published])
+      {
+        auto &hits = m_scan->partitions[m_published];
+        m_results.insert(m_results.end(), hits.begin(), hits.end());
+        std::vector<std::size_t>().swap(hits);
+        ++m_published;
+        m_searchedRows = std::min(m_scan->first + m_published * kPartitionRows, m_scan->last);
+      }
+    }
+    if (m_appended && m_published == m_scan->partitions.size())
+    {
+      stop();
+      launch(m_searchedRows);
+    }
+    return m_results.size();
+  }
+
+  void ContainerSearch::Wait()
+  {
+    // a scan of appended rows may follow the one waited for
+    while (m_scan != nullptr)
+    {
+      for (auto &worker : m_scan->workers)
+        worker.wait();
+      Poll();
+      if (!IsRunning())
+        return;
+    }
+  }
+
+  bool ContainerSearch::IsActive() const
+  {
+    return m_matcher != nullptr;
+  }
+
+  const Matcher *ContainerSearch::GetMatcher() const
+  {
+    return m_matcher.get();
+  }
+
+  bool ContainerSearch::IsRunning() const
+  {
+    return m_scan != nullptr && m_published < m_scan->partitions.size();
+  }
+
+  const std::vector<std::size_t> &ContainerSearch::GetResults() const
+  {
+    return m_results;
+  }
+
+  std::size_t ContainerSearch::GetSearchedRows() const
+  {
+    return m_searchedRows;
+  }
+
+  void ContainerSearch::launch(std::size_t first)
+  {
+    m_published = 0;
+    m_searchedRows = first;
+
+    const std::size_t last = m_store.size();
+    if (first >= last)
+      return;
+
+    m_scan = std::make_unique<Scan>();
+    m_scan->first = first;
+    m_scan->last = last;
+    const std::size_t partitions = (last - first + kPartitionRows - 1) / kPartitionRows;
+    m_scan->partitions.resize(partitions);
+    m_scan->done.resize(partitions, false);
+
+    const std::size_t workers = std::min(partitions, std::max<std::size_t>(m_pool.Size() / 2, 1));
+    for (std::size_t i = 0; i < workers; ++i)
+      m_scan->workers.push_back(m_pool.Submit([this, scan = m_scan.get()]
+                                              { scanPartitions(*scan); }));
+  }
+
+  void ContainerSearch::stop()
+  {
+    m_appended = false;
+    if (m_scan == nullptr)
+      return;
+
+    m_scan->stop = true;
+    for (auto &worker : m_scan->workers)
+      worker.wait();
+    // partitions that finished before the stop are still good
+    Poll();
+    m_scan.reset();
+  }
+
+  void ContainerSearch::scanPartitions(Scan &scan) const
+  {
+    const Matcher &matcher = *m_matcher;
+    while (true)
+    {
+      const std::size_t partition = scan.nextPartition++;
+      if (partition >= scan.partitions.size())
+        return;
+
+      const std::size_t begin = scan.first + partition * kPartitionRows;
+      const std::size_t end = std::min(begin + kPartitionRows, scan.last);
+      std::vector<std::size_t> hits;
+      for (std::size_t row = begin; row < end; ++row)
+      {
+        if ((row & 1023) == 0 && scan.stop.load(std::memory_order_relaxed))
+          return;
+        if (m_store.at(row).findInEvent(matcher))
+          hits.push_back(row);
+      }
+
+      std::lock_guard lock(scan.mutex);
+      scan.partitions[partition] = std::move(hits);
+      scan.done[partition] = true;
+    }
+  }
+
+} // namespace search
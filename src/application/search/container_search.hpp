@@ -0,0 +1,96 @@
+#ifndef SEARCH_CONTAINERSEARCH_HPP
+#define SEARCH_CONTAINERSEARCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "db/event_store.hpp"
+#include "search/matcher.hpp"
+#include "util/thread_pool.hpp"
+
+namespace search
+{
+	// Scans an event store for a matcher on the thread pool. The rows are cut
+	// into fixed size partitions that the pool workers claim in order, so the
+	// first partitions finish first; Poll publishes the finished prefix and the
+	// results stay sorted while the scan goes on.
+	//
+	// The store is read from the pool, by at most half of its workers so a
+	// log that is still loading keeps the others for its parsers. Events may
+	// be appended while a scan runs, it covers the rows there were when it
+	// started; Resume queues the new rows behind it, or carries on with the
+	// rows not searched yet once no scan runs. Suspend a scan before the
+	// store is cleared or reopened. The events of a container opened on
+	// demand are not in its store, callers search fully loaded logs only.
+	// All members are called from one thread.
+	class ContainerSearch
+	{
+	public:
+		explicit ContainerSearch(const db::EventStore &store, util::ThreadPool &pool = util::ThreadPool::Shared());
+		~ContainerSearch();
+
+		ContainerSearch(const ContainerSearch &) = delete;
+		ContainerSearch &operator=(const ContainerSearch &) = delete;
+
+		// drops the results of the previous search and searches the whole store
+		void Start(std::shared_ptr<const Matcher> matcher);
+		// stops the scan and forgets the matcher and the results
+		void Cancel();
+		// stops the scan, keeping the results published so far
+		void Suspend();
+		// scans the rows after the running scan or the last published
+		// result, new ones included
+		void Resume();
+
+		// publishes finished partitions, returns the number of results
+		std::size_t Poll();
+		// blocks until the scan is done
+		void Wait();
+
+		bool IsActive() const;
+		// matcher of the current search, null if there is none
+		const Matcher *GetMatcher() const;
+		bool IsRunning() const;
+		// matching rows in ascending order
+		const std::vector<std::size_t> &GetResults() const;
+		// rows searched, every match below this row is in the results
+		std::size_t GetSearchedRows() const;
+
+	private:
+		struct Scan
+		{
+			std::size_t first{0};
+			std::size_t last{0};
+			std::atomic<bool> stop{false};
+			std::atomic<std::size_t> nextPartition{0};
+			std::mutex mutex;
+			std::vector<std::vector<std::size_t>> partitions;
+			std::vector<bool> done;
+			std::vector<std::future<void>> workers;
+		};
+
+		void launch(std::size_t first);
+		void stop();
+		void scanPartitions(Scan &scan) const;
+
+	private:
+		static constexpr std::size_t kPartitionRows = 16384;
+
+		const db::EventStore &m_store;
+		util::ThreadPool &m_pool;
+		std::shared_ptr<const Matcher> m_matcher;
+		std::unique_ptr<Scan> m_scan;
+		// rows were appended while the scan ran, they are scanned after it
+		bool m_appended{false};
+		std::size_t m_published{0};
+		std::size_t m_searchedRows{0};
+		std::vector<std::size_t> m_results;
+	};
+
+} // namespace search
+
+#endif // SEARCH_CONTAINERSEARCH_HPP
@@ -0,0 +1,169 @@
+#include "search/event_filter.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace search
+{
+  namespace
+  {
+    // splits at separators outside double quotes, the quotes are kept or dropped
+    template <typename IsSeparator>
+    std::vector<std::string> split(std::string_view text, IsSeparator &&isSeparator, bool keepQuotes)
+    {
+      std::vector<std::string> pieces;
+      std::string piece;
+      bool quoted = false;
+      bool started = false;
+      for (char c : text)
+      {
+        if (c == '"')
+        {
+          quoted = !quoted;
+          started = true;
+          if (keepQuotes)
+            piece += c;
+          continue;
+        }
+        if (!quoted && isSeparator(c))
+        {
+          if (started)
+            pieces.push_back(std::move(piece));
+          piece.clear();
+          started = false;
+          continue;
+        }
+        piece += c;
+        started = true;
+      }
+      if (quoted)
+        throw std::invalid_argument("unterminated quote in filter");
+      if (started)
+        pieces.push_back(std::move(piece));
+      return pieces;
+    }
+
+    std::string unquote(std::string_view text)
+    {
+      auto pieces = split(text, [](char)
+                          { return false; }, false);
+      return pieces.empty() ? std::string() : pieces.front();
+    }
+  } // namespace
+
+  EventFilter EventFilter::Parse(std::string_view text)
+  {
+    EventFilter filter;
+    for (const auto &term : split(text, [](char c)
+                                  { return c == ' ' || c == '\t'; }, true))
+    {
+      const auto op = term.find_first_of("=!<>~");
+      if (op == std::string::npos || op == 0)
+        throw std::invalid_argument("filter term \"" + term + "\" is not field, operator, value");
+
+      std::string field = term.substr(0, op);
+      std::string_view rest = std::string_view(term).substr(op);
+      auto takes = [&rest](std::string_view symbol)
+      {
+        if (!rest.starts_with(symbol))
+          return false;
+        rest.remove_prefix(symbol.size());
+        return true;
+      };
+
+      auto values = [&term, &rest]
+      {
+        auto listed = split(rest, [](char c)
+                            { return c == ','; }, false);
+        if (listed.empty())
+          throw std::invalid_argument("filter term \"" + term + "\" lists no values");
+        return listed;
+      };
+
+      if (takes("!="))
+        filter.NotIn(std::move(field), values());
+      else if (takes("="))
+        filter.In(std::move(field), values());
+      else if (takes("<="))
+        filter.Compare(std::move(field), Op::LessEqual, unquote(rest));
+      else if (takes(">="))
+        filter.Compare(std::move(field), Op::GreaterEqual, unquote(rest));
+      else if (takes("<"))
+        filter.Compare(std::move(field), Op::Less, unquote(rest));
+      else if (takes(">"))
+        filter.Compare(std::move(field), Op::Greater, unquote(rest));
+      else if (takes("~"))
+        filter.Matches(std::move(field), std::make_shared<const Matcher>(unquote(rest), SearchOptions{SearchOptions::Mode::Auto, false}));
+      else
+        throw std::invalid_argument("filter term \"" + term + "\" has no operator");
+    }
+    return filter;
+  }
+
+  EventFilter &EventFilter::In(std::string field, std::vector<std::string> values)
+  {
+    m_conditions.push_back({std::move(field), Op::In, std::move(values), nullptr});
+    return *this;
+  }
+
+  EventFilter &EventFilter::NotIn(std::string field, std::vector<std::string> values)
+  {
+    m_conditions.push_back({std::move(field), Op::NotIn, std::move(values), nullptr});
+    return *this;
+  }
+
+  EventFilter &EventFilter::Compare(std::string field, Op op, std::string value)
+  {
+    if (op == Op::In || op == Op::NotIn || op == Op::Matches)
+      throw std::invalid_argument("EventFilter::Compare takes an ordering");
+    m_conditions.push_back({std::move(field), op, {std::move(value)}, nullptr});
+    return *this;
+  }
+
+  EventFilter &EventFilter::Matches(std::string field, std::shared_ptr<const Matcher> matcher)
+  {
+    m_conditions.push_back({std::move(field), Op::Matches, {}, std::move(matcher)});
+    return *this;
+  }
+
+  bool EventFilter::Empty() const
+  {
+    return m_conditions.empty();
+  }
+
+  const std::vector<EventFilter::Condition> &EventFilter::GetConditions() const
+  {
+    return m_conditions;
+  }
+
+  bool EventFilter::Passes(const Condition &condition, std::optional<std::string_view> value)
+  {
+    if (!value)
+      return condition.op == Op::NotIn;
+
+    auto isListed = [&]
+    {
+      return std::ranges::any_of(condition.values, [value](const std::string &listed)
+                                 { return listed == *value; });
+    };
+    switch (condition.op)
+    {
+    case Op::In:
+      return isListed();
+    case Op::NotIn:
+      return !isListed();
+    case Op::Less:
+      return *value < condition.values.front();
+    case Op::LessEqual:
+      return *value <= condition.values.front();
+    case Op::Greater:
+      return *value > condition.values.front();
+    case Op::GreaterEqual:
+      return *value >= condition.values.front();
+    case Op::Matches:
+      return condition.matcher->Matches(*value);
+    }
+    return false;
+  }
+
+} // namespace search
@@ -0,0 +1,69 @@
+#ifndef SEARCH_EVENTFILTER_HPP
+#define SEARCH_EVENTFILTER_HPP
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "search/matcher.hpp"
+
+namespace search
+{
+	// Conjunction of conditions on field values, e.g.
+	//   type=ERROR,WARN timestamp>=2024-01-01 timestamp<2024-01-02 info~timeout
+	// Values are compared as strings, which orders ISO timestamps in time.
+	// A search::FilterView compares timestamps on "timestamp" as times, so
+	// zone offsets are honoured and events whose time does not parse fail.
+	// An event without the field fails every condition but !=.
+	class EventFilter
+	{
+	public:
+		enum class Op
+		{
+			// one of the values
+			In,
+			// none of the values
+			NotIn,
+			Less,
+			LessEqual,
+			Greater,
+			GreaterEqual,
+			// the matcher finds the pattern in the value
+			Matches
+		};
+
+		struct Condition
+		{
+			std::string field;
+			Op op{Op::In};
+			std::vector<std::string> values;
+			std::shared_ptr<const Matcher> matcher;
+		};
+
+		// Terms separated by spaces, all of them have to hold: field=a,b,
+		// field!=a,b, field<v, field<=v, field>v, field>=v and field~pattern
+		// (case insensitive). Values with spaces or commas go in double
+		// quotes. Throws std::invalid_argument for a malformed term and
+		// std::regex_error for a pattern that does not compile.
+		static EventFilter Parse(std::string_view text);
+
+		EventFilter &In(std::string field, std::vector<std::string> values);
+		EventFilter &NotIn(std::string field, std::vector<std::string> values);
+		EventFilter &Compare(std::string field, Op op, std::string value);
+		EventFilter &Matches(std::string field, std::shared_ptr<const Matcher> matcher);
+
+		bool Empty() const;
+		const std::vector<Condition> &GetConditions() const;
+
+		// whether a value passes the condition, none if the event has no such field
+		static bool Passes(const Condition &condition, std::optional<std::string_view> value);
+
+	private:
+		std::vector<Condition> m_conditions;
+	};
+
+} // namespace search
+
+#endif // SEARCH_EVENTFILTER_HPP
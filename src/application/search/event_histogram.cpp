@@ -0,0 +1,232 @@
+#include "search/event_histogram.hpp"
+
+#include <algorithm>
+#include <span>
+
+namespace search
+{
+  EventHistogram::EventHistogram(const db::EventStore &store, std::string typeField)
+      : m_store(store), m_typeFieldName(std::move(typeField)), m_counts((kBuckets + 1) * kSlots, 0)
+  {
+  }
+
+  void EventHistogram::Append(std::size_t first, std::size_t last)
+  {
+    last = std::min(last, m_store.size());
+    for (auto block = first; block < last; block += kBlockRows)
+      countBlock(block, std::min(block + kBlockRows, last));
+    if (first < last)
+      m_counted += last - first;
+  }
+
+  void EventHistogram::Rebuild()
+  {
+    Clear();
+    Append(0, m_store.size());
+  }
+
+  void EventHistogram::Clear()
+  {
+    m_typeField.reset();
+    m_counted = 0;
+    m_shift = 0;
+    m_firstBucket = 0;
+    m_timeRange.reset();
+    std::ranges::fill(m_counts, 0);
+    m_types.clear();
+    m_typeSlots.clear();
+    m_refSlots.clear();
+  }
+
+  std::size_t EventHistogram::GetCount() const
+  {
+    return m_counted;
+  }
+
+  const std::vector<std::string> &EventHistogram::GetTypes() const
+  {
+    return m_types;
+  }
+
+  std::size_t EventHistogram::GetTypeCount(std::size_t type) const
+  {
+    std::size_t count = 0;
+    for (std::size_t bucket = 0; bucket <= kBuckets; ++bucket)
+      count += counter(bucket, type);
+    return count;
+  }
+
+  bool EventHistogram::HasTimes() const
+  {
+    return m_timeRange.has_value();
+  }
+
+  db::Timestamp EventHistogram::GetBucketWidth() const
+  {
+    return db::Timestamp(1) << m_shift;
+  }
+
+  db::Timestamp EventHistogram::GetBucketStart(std::size_t bucket) const
+  {
+    return (m_firstBucket + static_cast<int64_t>(bucket)) << m_shift;
+  }
+
+  std::size_t EventHistogram::GetBucketCount(std::size_t bucket) const
+  {
+    std::size_t count = 0;
+    for (std::size_t type = 0; type < kSlots; ++type)
+      count += counter(bucket, type);
+    return count;
+  }
+
+  std::size_t EventHistogram::GetBucketCount(std::size_t bucket, std::size_t type) const
+  {
+    return counter(bucket, type);
+  }
+
+  std::size_t EventHistogram::GetMaxBucketCount() const
+  {
+    std::size_t fullest = 0;
+    for (std::size_t bucket = 0; bucket < kBuckets; ++bucket)
+      fullest = std::max(fullest, GetBucketCount(bucket));
+    return fullest;
+  }
+
+  std::optional<std::size_t> EventHistogram::BucketOf(db::Timestamp time) const
+  {
+    if (!m_timeRange || time == db::EventStore::kNoTime)
+      return std::nullopt;
+    const auto bucket = (time >> m_shift) - m_firstBucket;
+    if (bucket < 0 || bucket >= static_cast<int64_t>(kBuckets))
+      return std::nullopt;
+    return static_cast<std::size_t>(bucket);
+  }
+
+  std::size_t EventHistogram::GetUntimedCount() const
+  {
+    return GetBucketCount(kBuckets);
+  }
+
+  void EventHistogram::countBlock(std::size_t first, std::size_t last)
+  {
+    const auto rows = last - first;
+
+    std::fill_n(m_blockTimes.begin(), rows, db::EventStore::kNoTime);
+    m_store.GetTimes().ForEachRun(first, last, [&](std::span<const db::Timestamp> run, std::size_t at)
+                                  { std::ranges::copy(run, m_blockTimes.begin() + (at - first)); });
+
+    // kNoTime is the smallest time, it never raises the maximum
+    db::Timestamp low = INT64_MAX;
+    db::Timestamp high = db::EventStore::kNoTime;
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+      const auto time = m_blockTimes[i];
+      low = std::min(low, time == db::EventStore::kNoTime ? INT64_MAX : time);
+      high = std::max(high, time);
+    }
+    if (low <= high)
+      fit(low, high);
+
+    const auto shift = m_shift;
+    const auto firstBucket = m_firstBucket;
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+      const auto time = m_blockTimes[i];
+      m_blockBuckets[i] = time == db::EventStore::kNoTime ? static_cast<uint32_t>(kBuckets)
+                                                          : static_cast<uint32_t>((time >> shift) - firstBucket);
+    }
+
+    if (!m_typeField)
+      m_typeField = m_store.GetFields().Find(m_typeFieldName);
+    const auto column = m_typeField ? m_store.GetColumn(*m_typeField) : util::SegmentedSpan<const db::StringRef>();
+    const auto covered = std::clamp(column.size(), first, last);
+    column.ForEachRun(first, covered, [&](std::span<const db::StringRef> run, std::size_t at)
+                      {
+                        auto *types = m_blockTypes.data() + (at - first);
+                        for (std::size_t i = 0; i < run.size(); ++i)
+                          types[i] = typeOf(run[i]); });
+    // the column ends with the last event that has the field
+    if (covered < last)
+      std::fill_n(m_blockTypes.begin() + (covered - first), last - covered, typeOf(db::StringRef()));
+
+    for (std::size_t i = 0; i < rows; ++i)
+      ++m_counts[m_blockBuckets[i] * kSlots + m_blockTypes[i]];
+  }
+
+  void EventHistogram::fit(db::Timestamp low, db::Timestamp high)
+  {
+    if (m_timeRange)
+    {
+      low = std::min(low, m_timeRange->first);
+      high = std::max(high, m_timeRange->second);
+    }
+    int shift = m_timeRange ? m_shift : 0;
+    while (static_cast<uint64_t>(high >> shift) - static_cast<uint64_t>(low >> shift) >= kBuckets)
+      ++shift;
+    const bool covered = m_timeRange && shift == m_shift && (low >> shift) >= m_firstBucket &&
+                         (high >> shift) < m_firstBucket + static_cast<int64_t>(kBuckets);
+    if (!covered)
+    {
+      const int64_t firstBucket = low >> shift;
+      if (m_timeRange)
+      {
+        // the buckets only grow, so every old one falls into one new one
+        std::vector<uint64_t> counts(m_counts.size(), 0);
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket)
+        {
+          const auto to = ((m_firstBucket + static_cast<int64_t>(bucket)) >> (shift - m_shift)) - firstBucket;
+          if (to < 0 || to >= static_cast<int64_t>(kBuckets))
+            continue;
+          for (std::size_t type = 0; type < kSlots; ++type)
+            counts[static_cast<std::size_t>(to) * kSlots + type] += counter(bucket, type);
+        }
+        std::copy_n(m_counts.begin() + kBuckets * kSlots, kSlots, counts.begin() + kBuckets * kSlots);
+        m_counts = std::move(counts);
+      }
+      m_shift = shift;
+      m_firstBucket = firstBucket;
+    }
+    m_timeRange = {low, high};
+  }
+
+  uint8_t EventHistogram::typeOf(db::StringRef ref)
+  {
+    for (const auto &[cached, slot] : m_refSlots)
+    {
+      if (cached == ref)
+        return slot;
+    }
+
+    const auto value = m_store.GetString(ref);
+    auto found = m_typeSlots.find(value);
+    uint8_t slot;
+    if (found != m_typeSlots.end())
+    {
+      slot = found->second;
+    }
+    else if (m_types.size() < kMaxTypes)
+    {
+      slot = static_cast<uint8_t>(m_types.size());
+      m_types.emplace_back(value);
+      m_typeSlots.emplace(m_types.back(), slot);
+    }
+    else
+    {
+      slot = static_cast<uint8_t>(kOtherTypes);
+    }
+    if (m_refSlots.size() < kCachedRefs)
+      m_refSlots.emplace_back(ref, slot);
+    return slot;
+  }
+
+  uint64_t &EventHistogram::counter(std::size_t bucket, std::size_t type)
+  {
+    return m_counts[bucket * kSlots + type];
+  }
+
+  const uint64_t &EventHistogram::counter(std::size_t bucket, std::size_t type) const
+  {
+    return m_counts[bucket * kSlots + type];
+  }
+
+} // namespace search
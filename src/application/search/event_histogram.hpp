@@ -0,0 +1,118 @@
+#ifndef SEARCH_EVENTHISTOGRAM_HPP
+#define SEARCH_EVENTHISTOGRAM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "db/event_store.hpp"
+#include "db/field_dictionary.hpp"
+#include "db/timestamp.hpp"
+
+namespace search
+{
+	// Counts of the events of a store by type and time, kept up to date as
+	// rows are appended, so an overview of any number of events is drawn
+	// from a few thousand counters and never from the events.
+	//
+	// Time is cut into kBuckets buckets of a power of two microseconds. When
+	// an event falls outside of them the width is doubled as often as needed
+	// and the counts of neighbouring buckets are added up, so counting never
+	// goes back to the store. Events without a time are counted apart.
+	// Types are the values of a field, the first kMaxTypes of them are
+	// counted by name and the others together. Rows are counted in blocks:
+	// the times of a block are turned into buckets in one branch free loop
+	// over contiguous memory, and the types the column shares are looked up
+	// by their reference rather than their text. Kept on the writer's thread,
+	// see db::EventStore.
+	class EventHistogram
+	{
+	public:
+		static constexpr std::size_t kBuckets = 256;
+		static constexpr std::size_t kMaxTypes = 16;
+		// type of the events of the types past the first kMaxTypes
+		static constexpr std::size_t kOtherTypes = kMaxTypes;
+
+		explicit EventHistogram(const db::EventStore &store, std::string typeField = "type");
+
+		// counts rows [first, last) appended since the last count
+		void Append(std::size_t first, std::size_t last);
+		// counts the whole store again, after it was cleared or replaced
+		void Rebuild();
+		void Clear();
+
+		// rows counted
+		std::size_t GetCount() const;
+		// names of the types counted by name, in the order they were seen,
+		// events without the field are of type ""
+		const std::vector<std::string> &GetTypes() const;
+		// events of a type, kOtherTypes for the ones not counted by name
+		std::size_t GetTypeCount(std::size_t type) const;
+
+		// false until an event has a time, the buckets are empty until then
+		bool HasTimes() const;
+		db::Timestamp GetBucketWidth() const;
+		// first time of a bucket, it goes on up to the next one
+		db::Timestamp GetBucketStart(std::size_t bucket) const;
+		std::size_t GetBucketCount(std::size_t bucket) const;
+		std::size_t GetBucketCount(std::size_t bucket, std::size_t type) const;
+		// count of the fullest bucket
+		std::size_t GetMaxBucketCount() const;
+		// bucket of a time, none if it is before or after all of them
+		std::optional<std::size_t> BucketOf(db::Timestamp time) const;
+		std::size_t GetUntimedCount() const;
+
+	private:
+		static constexpr std::size_t kSlots = kMaxTypes + 1;
+		// rows turned into buckets and types at a time
+		static constexpr std::size_t kBlockRows = 4096;
+
+		struct NameHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+		};
+
+		void countBlock(std::size_t first, std::size_t last);
+		// makes the buckets cover [low, high]
+		void fit(db::Timestamp low, db::Timestamp high);
+		uint8_t typeOf(db::StringRef ref);
+		uint64_t &counter(std::size_t bucket, std::size_t type);
+		const uint64_t &counter(std::size_t bucket, std::size_t type) const;
+
+	private:
+		const db::EventStore &m_store;
+		std::string m_typeFieldName;
+		std::optional<db::FieldId> m_typeField;
+		std::size_t m_counted{0};
+
+		// bucket b counts [(m_firstBucket + b) << m_shift, (m_firstBucket + b + 1) << m_shift)
+		int m_shift{0};
+		int64_t m_firstBucket{0};
+		std::optional<std::pair<db::Timestamp, db::Timestamp>> m_timeRange;
+		// kSlots counters per bucket, the bucket after the last is the untimed events
+		std::vector<uint64_t> m_counts;
+
+		std::vector<std::string> m_types;
+		std::unordered_map<std::string, uint8_t, NameHash, std::equal_to<>> m_typeSlots;
+		// references of the values of the type column seen so far and their
+		// type, shared values repeat their reference
+		static constexpr std::size_t kCachedRefs = 64;
+		std::vector<std::pair<db::StringRef, uint8_t>> m_refSlots;
+
+		// the rows of the block being counted
+		std::array<db::Timestamp, kBlockRows> m_blockTimes;
+		std::array<uint32_t, kBlockRows> m_blockBuckets;
+		std::array<uint8_t, kBlockRows> m_blockTypes;
+	};
+
+} // namespace search
+
+#endif // SEARCH_EVENTHISTOGRAM_HPP
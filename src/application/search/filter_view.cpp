@@ -0,0 +1,200 @@
+#include "search/filter_view.hpp"
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+namespace search
+{
+  FilterView::FilterView(const db::EventStore &store, util::ThreadPool &pool)
+      : m_store(store), m_pool(pool)
+  {
+  }
+
+  void FilterView::Apply(EventFilter filter)
+  {
+    m_filter = std::move(filter);
+    Reapply();
+  }
+
+  void FilterView::Reapply()
+  {
+    m_rows.clear();
+    m_evaluated = 0;
+    if (IsActive())
+      evaluate(0, m_store.size());
+  }
+
+  void FilterView::Append(std::size_t last)
+  {
+    if (!IsActive())
+      return;
+    evaluate(m_evaluated, last);
+  }
+
+  void FilterView::Clear()
+  {
+    m_filter = EventFilter();
+    std::vector<uint32_t>().swap(m_rows);
+    m_evaluated = 0;
+  }
+
+  bool FilterView::IsActive() const
+  {
+    return !m_filter.Empty();
+  }
+
+  const EventFilter &FilterView::GetFilter() const
+  {
+    return m_filter;
+  }
+
+  std::size_t FilterView::Size() const
+  {
+    return m_rows.size();
+  }
+
+  std::size_t FilterView::Row(std::size_t position) const
+  {
+    return m_rows.at(position);
+  }
+
+  std::optional<std::size_t> FilterView::Position(std::size_t row) const
+  {
+    auto found = std::ranges::lower_bound(m_rows, row);
+    if (found == m_rows.end() || *found != row)
+      return std::nullopt;
+    return static_cast<std::size_t>(found - m_rows.begin());
+  }
+
+  const std::vector<uint32_t> &FilterView::GetRows() const
+  {
+    return m_rows;
+  }
+
+  void FilterView::evaluate(std::size_t first, std::size_t last)
+  {
+    first = std::max(first, m_evaluated);
+    if (first >= last)
+      return;
+    if (last > UINT32_MAX)
+      throw std::length_error("FilterView: too many events");
+
+    // a few appended rows are not worth a round trip through the pool
+    if (last - first <= kPartitionRows || m_pool.Size() < 2)
+    {
+      evaluatePartition(first, last, m_rows);
+    }
+    else
+    {
+      const std::size_t partitions = (last - first + kPartitionRows - 1) / kPartitionRows;
+      std::vector<std::vector<uint32_t>> passed(partitions);
+      std::vector<std::future<void>> workers;
+      workers.reserve(partitions);
+      for (std::size_t partition = 0; partition < partitions; ++partition)
+      {
+        const auto begin = first + partition * kPartitionRows;
+        const auto end = std::min(begin + kPartitionRows, last);
+        workers.push_back(m_pool.Submit([this, begin, end, &rows = passed[partition]]
+                                        { evaluatePartition(begin, end, rows); }));
+      }
+      for (auto &worker : workers)
+        worker.wait();
+      for (auto &worker : workers)
+        worker.get();
+      for (const auto &rows : passed)
+        m_rows.insert(m_rows.end(), rows.begin(), rows.end());
+    }
+    m_evaluated = last;
+  }
+
+  void FilterView::evaluatePartition(std::size_t first, std::size_t last, std::vector<uint32_t> &rows) const
+  {
+    struct Resolved
+    {
+      const EventFilter::Condition *condition;
+      util::SegmentedSpan<const db::StringRef> column;
+    };
+
+    // Ordering conditions on the time field with timestamp values become
+    // one inclusive range of the time column; events without a time are
+    // below it. The rest are checked on the string columns, where fields
+    // the store does not know see no values.
+    db::Timestamp low = db::EventStore::kNoTime + 1;
+    db::Timestamp high = INT64_MAX;
+    bool timeRange = false;
+    const auto &fields = m_store.GetFields();
+    std::vector<Resolved> conditions;
+    for (const auto &condition : m_filter.GetConditions())
+    {
+      if (auto bound = timeBound(condition))
+      {
+        timeRange = true;
+        switch (condition.op)
+        {
+        case EventFilter::Op::Less:
+          high = std::min(high, *bound - 1);
+          break;
+        case EventFilter::Op::LessEqual:
+          high = std::min(high, *bound);
+          break;
+        case EventFilter::Op::Greater:
+          low = std::max(low, *bound + 1);
+          break;
+        default:
+          low = std::max(low, *bound);
+          break;
+        }
+        continue;
+      }
+      auto field = fields.Find(condition.field);
+      conditions.push_back({&condition, field ? m_store.GetColumn(*field) : util::SegmentedSpan<const db::StringRef>()});
+    }
+
+    auto passes = [&](std::size_t row)
+    {
+      return std::ranges::all_of(conditions, [this, row](const Resolved &resolved)
+                                 {
+                                   std::optional<std::string_view> value;
+                                   if (row < resolved.column.size() && !resolved.column[row].IsNull())
+                                     value = m_store.GetString(resolved.column[row]);
+                                   return EventFilter::Passes(*resolved.condition, value); });
+    };
+
+    if (!timeRange)
+    {
+      for (std::size_t row = first; row < last; ++row)
+        if (passes(row))
+          rows.push_back(static_cast<uint32_t>(row));
+      return;
+    }
+
+    // a branchless pass over each contiguous run of the integer column the
+    // compiler vectorizes, the string conditions only see the rows in range
+    const std::size_t count = last - first;
+    std::vector<uint8_t> inRange(count);
+    m_store.GetTimes().ForEachRun(first, last, [&](std::span<const db::Timestamp> times, std::size_t start)
+                                  {
+                                    uint8_t *out = inRange.data() + (start - first);
+                                    for (std::size_t i = 0; i < times.size(); ++i)
+                                      out[i] = static_cast<uint8_t>((times[i] >= low) & (times[i] <= high)); });
+    for (std::size_t i = 0; i < count; ++i)
+      if (inRange[i] && passes(first + i))
+        rows.push_back(static_cast<uint32_t>(first + i));
+  }
+
+  std::optional<db::Timestamp> FilterView::timeBound(const EventFilter::Condition &condition)
+  {
+    using Op = EventFilter::Op;
+    if (condition.field != db::EventStore::kTimeField || condition.values.size() != 1)
+      return std::nullopt;
+    if (condition.op != Op::Less && condition.op != Op::LessEqual && condition.op != Op::Greater && condition.op != Op::GreaterEqual)
+      return std::nullopt;
+    auto bound = db::ParseTimestamp(condition.values.front());
+    // the bounds are moved by one on either side
+    if (bound && (*bound == INT64_MAX || *bound <= db::EventStore::kNoTime + 1))
+      return std::nullopt;
+    return bound;
+  }
+
+} // namespace search
@@ -0,0 +1,68 @@
+#ifndef SEARCH_FILTERVIEW_HPP
+#define SEARCH_FILTERVIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "db/event_store.hpp"
+#include "db/timestamp.hpp"
+#include "search/event_filter.hpp"
+#include "util/thread_pool.hpp"
+
+namespace search
+{
+	// Rows of an event store that pass a filter, as an ascending index of 4
+	// bytes per passing row; the events themselves are not copied. The whole
+	// store is evaluated in partitions on the thread pool, rows appended
+	// later are evaluated on their own. Field names are resolved on every
+	// evaluation, so fields first seen in appended rows are found. Time
+	// ranges are evaluated on the integer time column of the store. The
+	// partitions read the store while the calling thread, the one that
+	// appends to it (see db::EventStore), waits for them.
+	class FilterView
+	{
+	public:
+		explicit FilterView(const db::EventStore &store, util::ThreadPool &pool = util::ThreadPool::Shared());
+
+		// evaluates the filter over the whole store, an empty filter is none
+		void Apply(EventFilter filter);
+		// evaluates the filter again, after the store was cleared or replaced
+		void Reapply();
+		// Evaluates the rows appended since the last evaluation, up to
+		// `last`. Rows evaluated already are skipped, a repeated
+		// notification adds nothing.
+		void Append(std::size_t last);
+		void Clear();
+
+		bool IsActive() const;
+		const EventFilter &GetFilter() const;
+		// rows passing the filter
+		std::size_t Size() const;
+		// store row of a position in the filtered rows
+		std::size_t Row(std::size_t position) const;
+		// position of a store row in the filtered rows, none if it does not pass
+		std::optional<std::size_t> Position(std::size_t row) const;
+		const std::vector<uint32_t> &GetRows() const;
+
+	private:
+		void evaluate(std::size_t first, std::size_t last);
+		void evaluatePartition(std::size_t first, std::size_t last, std::vector<uint32_t> &rows) const;
+		// timestamp of a <, <=, > or >= condition on the time field
+		static std::optional<db::Timestamp> timeBound(const EventFilter::Condition &condition);
+
+	private:
+		static constexpr std::size_t kPartitionRows = 16384;
+
+		const db::EventStore &m_store;
+		util::ThreadPool &m_pool;
+		EventFilter m_filter;
+		std::vector<uint32_t> m_rows;
+		// rows evaluated so far
+		std::size_t m_evaluated{0};
+	};
+
+} // namespace search
+
+#endif // SEARCH_FILTERVIEW_HPP
@@ -0,0 +1,229 @@
+#include "search/matcher.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace search
+{
+  namespace
+  {
+    constexpr std::size_t kCacheSize = 16;
+
+    unsigned char fold(unsigned char c)
+    {
+      return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+    }
+
+    bool isLetter(unsigned char c)
+    {
+      return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+    }
+
+    bool isRegexSyntax(char c)
+    {
+      return std::strchr("\\^$.|?*+()[]{}", c) != nullptr && c != '\0';
+    }
+
+    // rough frequency of a byte in log text, higher is more common
+    int byteRank(unsigned char c)
+    {
+      static constexpr std::string_view kLetters = "etaoinshrdlcumwfgypbvkjxqz";
+      if (c == ' ')
+        return 255;
+      if (c >= 'a' && c <= 'z')
+        return 250 - 4 * static_cast<int>(kLetters.find(static_cast<char>(c)));
+      if (c >= '0' && c <= '9')
+        return 160;
+      if (std::strchr("<>/=\":-._,", c) != nullptr && c != '\0')
+        return 200;
+      if (c >= 'A' && c <= 'Z')
+        return 120;
+      return 50;
+    }
+
+    // the literal a pattern in regex syntax searches for, if it is one:
+    // escaped punctuation is unescaped and a leading or trailing ".*" is
+    // dropped as it does not change whether regex_search finds a match
+    std::optional<std::string> literalOf(std::string_view pattern)
+    {
+      if (pattern.starts_with(".*"))
+        pattern.remove_prefix(2);
+      if (pattern.ends_with(".*") && !pattern.ends_with("\\.*"))
+        pattern.remove_suffix(2);
+
+      std::string literal;
+      literal.reserve(pattern.size());
+      for (std::size_t i = 0; i < pattern.size(); ++i)
+      {
+        const char c = pattern[i];
+        if (c == '\\')
+        {
+          if (i + 1 == pattern.size())
+            return std::nullopt;
+          const auto next = static_cast<unsigned char>(pattern[++i]);
+          // \d, \w, \n and friends are classes or control characters
+          if (!std::ispunct(next))
+            return std::nullopt;
+          literal.push_back(static_cast<char>(next));
+        }
+        else if (isRegexSyntax(c))
+          return std::nullopt;
+        else
+          literal.push_back(c);
+      }
+      return literal;
+    }
+
+    struct CacheEntry
+    {
+      std::string pattern;
+      SearchOptions options;
+      std::unique_ptr<Matcher> matcher;
+    };
+  } // namespace
+
+  Matcher::Matcher(std::string pattern, SearchOptions options)
+      : m_pattern(std::move(pattern)), m_options(options)
+  {
+    std::optional<std::string> literal;
+    if (m_options.mode == SearchOptions::Mode::Literal)
+      literal = m_pattern;
+    else if (m_options.mode == SearchOptions::Mode::Auto)
+      literal = literalOf(m_pattern);
+
+    if (!literal)
+    {
+      auto flags = std::regex::ECMAScript | std::regex::optimize;
+      if (!m_options.caseSensitive)
+        flags |= std::regex::icase;
+      m_kind = Kind::Regex;
+      m_regex = std::make_shared<const std::regex>(m_pattern, flags);
+      return;
+    }
+
+    m_literal = std::move(*literal);
+    // folding only matters if the literal has letters
+    const bool folded = !m_options.caseSensitive && std::ranges::any_of(m_literal, [](char c)
+                                                                       { return isLetter(static_cast<unsigned char>(c)); });
+    if (!folded)
+    {
+      m_kind = Kind::Literal;
+      for (std::size_t i = 1; i < m_literal.size(); ++i)
+        if (byteRank(static_cast<unsigned char>(m_literal[i])) < byteRank(static_cast<unsigned char>(m_literal[m_rarePosition])))
+          m_rarePosition = i;
+      return;
+    }
+
+    m_kind = Kind::CaseInsensitiveLiteral;
+    for (auto &c : m_literal)
+      c = static_cast<char>(fold(static_cast<unsigned char>(c)));
+    const std::size_t length = m_literal.size();
+    m_skip.fill(length);
+    for (std::size_t i = 0; i + 1 < length; ++i)
+      m_skip[static_cast<unsigned char>(m_literal[i])] = length - 1 - i;
+  }
+
+  const Matcher &Matcher::Cached(const std::string &pattern, SearchOptions options)
+  {
+    thread_local std::vector<CacheEntry> cache;
+
+    auto found = std::ranges::find_if(cache, [&](const CacheEntry &entry)
+                                      { return entry.options == options && entry.pattern == pattern; });
+    if (found == cache.end())
+    {
+      // compile before touching the cache so a bad pattern leaves it intact
+      auto matcher = std::make_unique<Matcher>(pattern, options);
+      if (cache.size() == kCacheSize)
+        cache.pop_back();
+      cache.insert(cache.begin(), {pattern, options, std::move(matcher)});
+      return *cache.front().matcher;
+    }
+
+    std::rotate(cache.begin(), found, found + 1);
+    return *cache.front().matcher;
+  }
+
+  bool Matcher::Matches(std::string_view text) const
+  {
+    switch (m_kind)
+    {
+    case Kind::Literal:
+      return findLiteral(text);
+    case Kind::CaseInsensitiveLiteral:
+      return findFolded(text);
+    case Kind::Regex:
+      return std::regex_search(text.begin(), text.end(), *m_regex);
+    }
+    return false;
+  }
+
+  bool Matcher::findLiteral(std::string_view text) const
+  {
+    const std::size_t length = m_literal.size();
+    if (length == 0)
+      return true;
+    if (text.size() < length)
+      return false;
+
+    // memchr for the rarest byte is vectorised by the C library, every hit
+    // is a candidate start that is confirmed with one memcmp
+    const char rare = m_literal[m_rarePosition];
+    const char *scan = text.data() + m_rarePosition;
+    const char *scanEnd = text.data() + (text.size() - length) + m_rarePosition + 1;
+    while (scan < scanEnd)
+    {
+      const auto *hit = static_cast<const char *>(std::memchr(scan, rare, static_cast<std::size_t>(scanEnd - scan)));
+      if (hit == nullptr)
+        return false;
+      if (std::memcmp(hit - m_rarePosition, m_literal.data(), length) == 0)
+        return true;
+      scan = hit + 1;
+    }
+    return false;
+  }
+
+  bool Matcher::findFolded(std::string_view text) const
+  {
+    const std::size_t length = m_literal.size();
+    if (text.size() < length)
+      return false;
+
+    const auto *data = reinterpret_cast<const unsigned char *>(text.data());
+    const auto *literal = reinterpret_cast<const unsigned char *>(m_literal.data());
+    std::size_t position = 0;
+    while (position <= text.size() - length)
+    {
+      std::size_t i = length;
+      while (i > 0 && fold(data[position + i - 1]) == literal[i - 1])
+        --i;
+      if (i == 0)
+        return true;
+      position += m_skip[fold(data[position + length - 1])];
+    }
+    return false;
+  }
+
+  Matcher::Kind Matcher::GetKind() const
+  {
+    return m_kind;
+  }
+
+  const std::string &Matcher::GetPattern() const
+  {
+    return m_pattern;
+  }
+
+  const SearchOptions &Matcher::GetOptions() const
+  {
+    return m_options;
+  }
+
+  const std::string &Matcher::GetLiteral() const
+  {
+    return m_literal;
+  }
+
+} // namespace search
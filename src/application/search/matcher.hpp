@@ -0,0 +1,78 @@
+#ifndef SEARCH_MATCHER_HPP
+#define SEARCH_MATCHER_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+
+namespace search
+{
+	struct SearchOptions
+	{
+		enum class Mode
+		{
+			// literal unless the pattern uses regex syntax
+			Auto,
+			Literal,
+			Regex
+		};
+
+		Mode mode{Mode::Auto};
+		bool caseSensitive{true};
+
+		bool operator==(const SearchOptions &other) const = default;
+	};
+
+	// A search pattern compiled once and matched against many values. Plain
+	// substrings never go through std::regex: they are found with a memchr
+	// scan for their rarest byte followed by a memcmp, case insensitive ones
+	// with a Boyer-Moore-Horspool search over folded bytes. Patterns that
+	// only look like regexes ("a\.b", "error.*") are reduced to literals.
+	// Matching is thread safe.
+	class Matcher
+	{
+	public:
+		enum class Kind
+		{
+			Literal,
+			CaseInsensitiveLiteral,
+			Regex
+		};
+
+		// throws std::regex_error if a regex pattern does not compile
+		explicit Matcher(std::string pattern, SearchOptions options = {});
+
+		// Matcher for the pattern out of a small per-thread cache, so repeated
+		// searches for the same pattern compile it once.
+		static const Matcher &Cached(const std::string &pattern, SearchOptions options = {});
+
+		bool Matches(std::string_view text) const;
+
+		Kind GetKind() const;
+		const std::string &GetPattern() const;
+		const SearchOptions &GetOptions() const;
+		// substring matched by literal kinds, after unescaping and folding
+		const std::string &GetLiteral() const;
+
+	private:
+		bool findLiteral(std::string_view text) const;
+		bool findFolded(std::string_view text) const;
+
+	private:
+		std::string m_pattern;
+		SearchOptions m_options;
+		Kind m_kind{Kind::Literal};
+		std::string m_literal;
+		// literal search: the rarest byte of the literal and its position
+		std::size_t m_rarePosition{0};
+		// folded search
+		std::array<std::size_t, 256> m_skip{};
+		std::shared_ptr<const std::regex> m_regex;
+	};
+
+} // namespace search
+
+#endif // SEARCH_MATCHER_HPP
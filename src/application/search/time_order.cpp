@@ -0,0 +1,133 @@
+#include "search/time_order.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "util/parallel_sort.hpp"
+
+namespace search
+{
+  namespace
+  {
+    // the time is the key, the row makes it unique and keeps ties in order.
+    // Sorting the pairs keeps the comparisons on contiguous memory.
+    struct Key
+    {
+      db::Timestamp time;
+      uint32_t row;
+
+      bool operator<(const Key &other) const
+      {
+        return time < other.time || (time == other.time && row < other.row);
+      }
+    };
+  } // namespace
+
+  TimeOrder::TimeOrder(const db::EventStore &store, util::ThreadPool &pool)
+      : m_store(store), m_pool(pool)
+  {
+  }
+
+  void TimeOrder::Assign(std::span<const uint32_t> rows)
+  {
+    const auto times = m_store.GetTimes();
+    std::vector<Key> keys;
+    keys.reserve(rows.size());
+    for (auto row : rows)
+      keys.push_back({times[row], row});
+    util::ParallelSort(keys, std::less<>(), m_pool);
+
+    m_rows.resize(keys.size());
+    std::ranges::transform(keys, m_rows.begin(), &Key::row);
+  }
+
+  void TimeOrder::Assign()
+  {
+    if (m_store.size() > UINT32_MAX)
+      throw std::length_error("TimeOrder: too many events");
+    std::vector<uint32_t> rows(m_store.size());
+    std::iota(rows.begin(), rows.end(), uint32_t(0));
+    // a log written in time order is ordered already
+    if (m_store.IsTimeSorted())
+      m_rows = std::move(rows);
+    else
+      Assign(rows);
+  }
+
+  bool TimeOrder::Add(std::span<const uint32_t> rows)
+  {
+    if (rows.empty())
+      return true;
+
+    std::vector<uint32_t> added(rows.begin(), rows.end());
+    std::ranges::stable_sort(added, [times = m_store.GetTimes()](uint32_t left, uint32_t right)
+                             { return times[left] < times[right]; });
+    if (m_rows.empty() || before(m_rows.back(), added.front()))
+    {
+      m_rows.insert(m_rows.end(), added.begin(), added.end());
+      return true;
+    }
+
+    std::vector<uint32_t> merged;
+    merged.reserve(m_rows.size() + added.size());
+    std::ranges::merge(m_rows, added, std::back_inserter(merged), [this](uint32_t left, uint32_t right)
+                       { return before(left, right); });
+    m_rows = std::move(merged);
+    return false;
+  }
+
+  bool TimeOrder::Add(std::size_t first)
+  {
+    if (m_store.size() > UINT32_MAX)
+      throw std::length_error("TimeOrder: too many events");
+    std::vector<uint32_t> rows(m_store.size() - std::min(first, m_store.size()));
+    std::iota(rows.begin(), rows.end(), static_cast<uint32_t>(first));
+    return Add(rows);
+  }
+
+  void TimeOrder::Clear()
+  {
+    std::vector<uint32_t>().swap(m_rows);
+  }
+
+  std::size_t TimeOrder::Size() const
+  {
+    return m_rows.size();
+  }
+
+  std::size_t TimeOrder::Row(std::size_t position) const
+  {
+    return m_rows.at(position);
+  }
+
+  std::optional<std::size_t> TimeOrder::Position(std::size_t row) const
+  {
+    if (row >= m_store.size())
+      return std::nullopt;
+    auto found = std::ranges::lower_bound(m_rows, static_cast<uint32_t>(row), [this](uint32_t left, uint32_t right)
+                                          { return before(left, right); });
+    if (found == m_rows.end() || *found != row)
+      return std::nullopt;
+    return static_cast<std::size_t>(found - m_rows.begin());
+  }
+
+  std::size_t TimeOrder::LowerBound(db::Timestamp time) const
+  {
+    auto found = std::ranges::lower_bound(m_rows, time, {}, [times = m_store.GetTimes()](uint32_t row)
+                                          { return times[row]; });
+    return static_cast<std::size_t>(found - m_rows.begin());
+  }
+
+  const std::vector<uint32_t> &TimeOrder::GetRows() const
+  {
+    return m_rows;
+  }
+
+  bool TimeOrder::before(uint32_t left, uint32_t right) const
+  {
+    const auto times = m_store.GetTimes();
+    return Key{times[left], left} < Key{times[right], right};
+  }
+
+} // namespace search
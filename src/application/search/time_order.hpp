@@ -0,0 +1,57 @@
+#ifndef SEARCH_TIMEORDER_HPP
+#define SEARCH_TIMEORDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "db/event_store.hpp"
+#include "db/timestamp.hpp"
+#include "util/thread_pool.hpp"
+
+namespace search
+{
+	// Rows of an event store ordered by the time column, ties and events
+	// without a time (first) in row order. Only the 4 byte rows are kept,
+	// times are read from the store when rows are compared. The rows are
+	// sorted on the thread pool, rows added later are merged in by Add on
+	// the thread that appends them, see db::EventStore.
+	class TimeOrder
+	{
+	public:
+		explicit TimeOrder(const db::EventStore &store, util::ThreadPool &pool = util::ThreadPool::Shared());
+
+		// orders these rows, all rows of the store without any
+		void Assign(std::span<const uint32_t> rows);
+		void Assign();
+		// Merges ascending rows that were appended to the store. True if they
+		// all went after the rows ordered already, as they do for a log that
+		// is written in time order.
+		bool Add(std::span<const uint32_t> rows);
+		// the rows of the store from `first` on
+		bool Add(std::size_t first);
+		void Clear();
+
+		std::size_t Size() const;
+		// store row at a position of the order
+		std::size_t Row(std::size_t position) const;
+		// position of a store row, none if it is not ordered
+		std::optional<std::size_t> Position(std::size_t row) const;
+		// position of the first event at or after the time, Size() if none is
+		std::size_t LowerBound(db::Timestamp time) const;
+		const std::vector<uint32_t> &GetRows() const;
+
+	private:
+		bool before(uint32_t left, uint32_t right) const;
+
+	private:
+		const db::EventStore &m_store;
+		util::ThreadPool &m_pool;
+		std::vector<uint32_t> m_rows;
+	};
+
+} // namespace search
+
+#endif // SEARCH_TIMEORDER_HPP
@@ -0,0 +1,268 @@
+#include "search/token_index.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace search
+{
+  namespace
+  {
+    bool isWordByte(unsigned char c)
+    {
+      return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+    }
+
+    char fold(char c)
+    {
+      return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    void foldInto(std::string_view text, std::string &out)
+    {
+      out.resize(text.size());
+      std::ranges::transform(text, out.begin(), fold);
+    }
+
+    // calls `word` for every word of the text
+    template <typename Callback>
+    void forEachWord(std::string_view text, Callback &&word)
+    {
+      std::size_t position = 0;
+      while (position < text.size())
+      {
+        while (position < text.size() && !isWordByte(static_cast<unsigned char>(text[position])))
+          ++position;
+        const std::size_t begin = position;
+        while (position < text.size() && isWordByte(static_cast<unsigned char>(text[position])))
+          ++position;
+        if (position > begin)
+          word(text.substr(begin, position - begin));
+      }
+    }
+
+    template <typename Map>
+    std::size_t mapUsage(const Map &map)
+    {
+      // node with key, value and next pointer plus the bucket array
+      return map.bucket_count() * sizeof(void *) + map.size() * (sizeof(typename Map::value_type) + sizeof(void *));
+    }
+  } // namespace
+
+  void TokenIndex::Postings::Append(std::size_t row)
+  {
+    if (count > 0 && row == last)
+      return;
+
+    auto delta = count == 0 ? row : row - last;
+    while (delta >= 0x80)
+    {
+      deltas.push_back(static_cast<uint8_t>(delta | 0x80));
+      delta >>= 7;
+    }
+    deltas.push_back(static_cast<uint8_t>(delta));
+    last = row;
+    ++count;
+  }
+
+  std::vector<std::size_t> TokenIndex::Postings::Decode() const
+  {
+    std::vector<std::size_t> rows;
+    rows.reserve(count);
+    std::size_t row = 0;
+    std::size_t delta = 0;
+    int shift = 0;
+    for (auto byte : deltas)
+    {
+      delta |= static_cast<std::size_t>(byte & 0x7F) << shift;
+      shift += 7;
+      if (byte & 0x80)
+        continue;
+      row += delta;
+      rows.push_back(row);
+      delta = 0;
+      shift = 0;
+    }
+    return rows;
+  }
+
+  void TokenIndex::Add(const db::Event &event)
+  {
+    Add(std::span<const db::Event>(&event, 1));
+  }
+
+  void TokenIndex::Add(std::span<const db::Event> events)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock lock(m_mutex);
+    for (const auto &event : events)
+      addEvent(event);
+    m_buildTime += std::chrono::steady_clock::now() - start;
+  }
+
+  void TokenIndex::addEvent(const db::Event &event)
+  {
+    const std::size_t row = m_size++;
+    for (const auto &[name, value] : event.getEventItems())
+    {
+      addWords(value, row);
+
+      // every field gets an entry, so one seen only with long values is
+      // told apart from one never seen
+      auto entry = m_fields.find(name);
+      if (entry == m_fields.end())
+        entry = m_fields.emplace(std::string(name), FieldValues()).first;
+      auto &field = entry->second;
+      if (!field.enabled || value.size() > kMaxPairValueLength)
+        continue;
+
+      foldInto(value, m_token);
+      auto found = field.values.find(m_token);
+      if (found == field.values.end())
+      {
+        if (field.values.size() == kMaxPairValues)
+        {
+          field.enabled = false;
+          std::unordered_map<std::string, Postings>().swap(field.values);
+          continue;
+        }
+        found = field.values.emplace(m_token, Postings()).first;
+      }
+      found->second.Append(row);
+    }
+  }
+
+  void TokenIndex::addWords(std::string_view value, std::size_t row)
+  {
+    forEachWord(value, [this, row](std::string_view word)
+                {
+                  if (word.size() > kMaxWordLength)
+                    return;
+                  foldInto(word, m_token);
+                  auto found = m_words.find(m_token);
+                  if (found == m_words.end())
+                    found = m_words.emplace(m_token, Postings()).first;
+                  found->second.Append(row); });
+  }
+
+  void TokenIndex::Clear()
+  {
+    std::unique_lock lock(m_mutex);
+    std::unordered_map<std::string, Postings>().swap(m_words);
+    decltype(m_fields)().swap(m_fields);
+    m_size = 0;
+    m_buildTime = {};
+  }
+
+  const TokenIndex::Postings *TokenIndex::findWord(const std::string &word) const
+  {
+    auto found = m_words.find(word);
+    return found == m_words.end() ? nullptr : &found->second;
+  }
+
+  std::optional<std::vector<std::size_t>> TokenIndex::Find(std::string_view query) const
+  {
+    std::shared_lock lock(m_mutex);
+
+    std::vector<const Postings *> terms;
+    bool missing = false;
+    std::string folded;
+
+    std::size_t position = 0;
+    while (position < query.size())
+    {
+      while (position < query.size() && (query[position] == ' ' || query[position] == '\t'))
+        ++position;
+      const std::size_t begin = position;
+      while (position < query.size() && query[position] != ' ' && query[position] != '\t')
+        ++position;
+      if (position == begin)
+        break;
+      auto term = query.substr(begin, position - begin);
+
+      if (auto equals = term.find('='); equals != std::string_view::npos && equals > 0)
+      {
+        auto value = term.substr(equals + 1);
+        if (value.size() > kMaxPairValueLength)
+          return std::nullopt;
+        auto field = m_fields.find(term.substr(0, equals));
+        if (field == m_fields.end())
+        {
+          missing = true;
+          continue;
+        }
+        if (!field->second.enabled || field->second.values.empty())
+          return std::nullopt;
+        foldInto(value, folded);
+        auto found = field->second.values.find(folded);
+        if (found == field->second.values.end())
+          missing = true;
+        else
+          terms.push_back(&found->second);
+        continue;
+      }
+
+      bool indexed = true;
+      forEachWord(term, [&](std::string_view word)
+                  {
+                    if (word.size() > kMaxWordLength)
+                    {
+                      indexed = false;
+                      return;
+                    }
+                    foldInto(word, folded);
+                    if (const auto *postings = findWord(folded))
+                      terms.push_back(postings);
+                    else
+                      missing = true; });
+      if (!indexed)
+        return std::nullopt;
+    }
+
+    if (terms.empty() && !missing)
+      return std::nullopt;
+    if (missing)
+      return std::vector<std::size_t>();
+
+    // intersect starting from the rarest term
+    std::ranges::sort(terms, {}, &Postings::count);
+    auto rows = terms.front()->Decode();
+    for (std::size_t i = 1; i < terms.size() && !rows.empty(); ++i)
+    {
+      auto other = terms[i]->Decode();
+      std::vector<std::size_t> both;
+      std::ranges::set_intersection(rows, other, std::back_inserter(both));
+      rows = std::move(both);
+    }
+    return rows;
+  }
+
+  std::size_t TokenIndex::Size() const
+  {
+    std::shared_lock lock(m_mutex);
+    return m_size;
+  }
+
+  std::size_t TokenIndex::MemoryUsage() const
+  {
+    std::shared_lock lock(m_mutex);
+    auto postingsUsage = [](const std::unordered_map<std::string, Postings> &map)
+    {
+      std::size_t total = mapUsage(map);
+      for (const auto &[token, postings] : map)
+        total += (token.capacity() > 15 ? token.capacity() : 0) + postings.deltas.capacity();
+      return total;
+    };
+
+    std::size_t total = postingsUsage(m_words) + mapUsage(m_fields);
+    for (const auto &[name, field] : m_fields)
+      total += postingsUsage(field.values);
+    return total;
+  }
+
+  std::chrono::nanoseconds TokenIndex::GetBuildTime() const
+  {
+    std::shared_lock lock(m_mutex);
+    return m_buildTime;
+  }
+
+} // namespace search
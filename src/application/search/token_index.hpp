@@ -0,0 +1,96 @@
+#ifndef SEARCH_TOKENINDEX_HPP
+#define SEARCH_TOKENINDEX_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "db/event.hpp"
+
+namespace search
+{
+	// Inverted index from the tokens of field values to the rows of the
+	// events that contain them, in the order the events were added.
+	// Two kinds of tokens are indexed, case insensitively:
+	// - words, the runs of letters, digits, '_' and non ASCII bytes of a value
+	// - "field=value" pairs of short values of low cardinality fields
+	// Posting lists are delta encoded varints.
+	//
+	// It is fed the batches of a parser::ParserWorker as they are parsed.
+	// Adding happens on one thread while queries can run on any other.
+	class TokenIndex
+	{
+	public:
+		void Add(const db::Event &event);
+		// takes the lock once for the whole batch
+		void Add(std::span<const db::Event> events);
+		void Clear();
+
+		// Rows of the events that have every term of the query. A term is a
+		// word or a field=value pair, terms are separated by spaces. There is
+		// no answer for an empty query or a pair of a field whose values are
+		// not indexed.
+		std::optional<std::vector<std::size_t>> Find(std::string_view query) const;
+
+		// events indexed
+		std::size_t Size() const;
+		std::size_t MemoryUsage() const;
+		// time spent adding events
+		std::chrono::nanoseconds GetBuildTime() const;
+
+	private:
+		struct Postings
+		{
+			std::vector<uint8_t> deltas;
+			std::size_t count{0};
+			std::size_t last{0};
+
+			void Append(std::size_t row);
+			std::vector<std::size_t> Decode() const;
+		};
+
+		struct FieldValues
+		{
+			// empty while the field had only values too long for pairs
+			std::unordered_map<std::string, Postings> values;
+			bool enabled{true};
+		};
+
+		struct NameHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+		};
+
+		void addEvent(const db::Event &event);
+		void addWords(std::string_view value, std::size_t row);
+		const Postings *findWord(const std::string &word) const;
+
+	private:
+		// fields with more distinct values than this get no pair tokens
+		static constexpr std::size_t kMaxPairValues = 4096;
+		static constexpr std::size_t kMaxPairValueLength = 64;
+		// longer words are ids or payloads nobody searches for as a whole
+		static constexpr std::size_t kMaxWordLength = 64;
+
+		mutable std::shared_mutex m_mutex;
+		std::unordered_map<std::string, Postings> m_words;
+		// looked up with the names of the items as they are
+		std::unordered_map<std::string, FieldValues, NameHash, std::equal_to<>> m_fields;
+		std::size_t m_size{0};
+		std::chrono::nanoseconds m_buildTime{0};
+		// scratch buffer of the writer for folding tokens
+		std::string m_token;
+	};
+
+} // namespace search
+
+#endif // SEARCH_TOKENINDEX_HPP
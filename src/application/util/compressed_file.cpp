@@ -0,0 +1,446 @@
+#include "util/compressed_file.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include <zlib.h>
+#ifdef LOGVIEWER_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace util
+{
+  namespace
+  {
+    constexpr unsigned char kGzipMagic[] = {0x1F, 0x8B};
+    constexpr unsigned char kZstdMagic[] = {0x28, 0xB5, 0x2F, 0xFD};
+    // most zlib takes in one call
+    constexpr std::size_t kMaxInflateInput = std::size_t(1) << 30;
+
+    template <std::size_t N>
+    bool startsWith(std::string_view data, const unsigned char (&magic)[N])
+    {
+      return data.size() >= N && std::memcmp(data.data(), magic, N) == 0;
+    }
+
+    CompressedFile::Format formatOf(std::string_view data)
+    {
+      if (startsWith(data, kGzipMagic))
+        return CompressedFile::Format::Gzip;
+      if (startsWith(data, kZstdMagic))
+        return CompressedFile::Format::Zstd;
+      return CompressedFile::Format::None;
+    }
+
+    uint16_t readLittle16(const unsigned char *bytes)
+    {
+      return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    // size of the gzip member at `offset` from its BGZF extra field, none
+    // if the member does not record it
+    std::optional<std::size_t> bgzfMemberSize(std::string_view data, std::size_t offset)
+    {
+      constexpr std::size_t kHeader = 10;
+      constexpr unsigned char kExtraFlag = 0x04;
+      const auto *bytes = reinterpret_cast<const unsigned char *>(data.data()) + offset;
+      const std::size_t available = data.size() - offset;
+      if (available < kHeader + 2 || !startsWith(data.substr(offset), kGzipMagic) || (bytes[3] & kExtraFlag) == 0)
+        return std::nullopt;
+
+      const std::size_t extraLength = readLittle16(bytes + kHeader);
+      if (available < kHeader + 2 + extraLength)
+        return std::nullopt;
+      // subfields are SI1 SI2 LEN(2) and LEN bytes, BGZF's is 'B' 'C' 2 BSIZE
+      for (std::size_t field = kHeader + 2; field + 4 <= kHeader + 2 + extraLength;)
+      {
+        const std::size_t length = readLittle16(bytes + field + 2);
+        if (bytes[field] == 'B' && bytes[field + 1] == 'C' && length == 2 && field + 6 <= kHeader + 2 + extraLength)
+        {
+          const std::size_t size = readLittle16(bytes + field + 4) + std::size_t(1);
+          if (size > available)
+            return std::nullopt;
+          return size;
+        }
+        field += 4 + length;
+      }
+      return std::nullopt;
+    }
+
+    // Inflates gzip members back to back from `data`, calling `flush` with
+    // each full block of `blockSize` bytes and the input offset its data
+    // ends at, and with the rest at the end.
+    template <typename Flush>
+    void inflateMembers(std::string_view data, std::size_t blockSize, Flush &&flush)
+    {
+      struct Inflater
+      {
+        z_stream stream{};
+        ~Inflater() { inflateEnd(&stream); }
+      } inflater;
+      auto &stream = inflater.stream;
+      // 32 detects the gzip header, 15 is the largest window
+      if (inflateInit2(&stream, 15 + 32) != Z_OK)
+        throw std::runtime_error("Cannot initialize gzip decompression");
+
+      const auto *input = reinterpret_cast<const Bytef *>(data.data());
+      std::size_t offset = 0;
+      std::string block(blockSize, '\0');
+      std::size_t filled = 0;
+      // what was inflated before the damage is handed over first
+      auto fail = [&](const char *what)
+      {
+        block.resize(filled);
+        flush(std::move(block), offset);
+        throw std::runtime_error(what);
+      };
+
+      stream.next_in = const_cast<Bytef *>(input);
+      stream.avail_in = static_cast<uInt>(std::min(data.size(), kMaxInflateInput));
+      while (true)
+      {
+        stream.next_out = reinterpret_cast<Bytef *>(block.data() + filled);
+        stream.avail_out = static_cast<uInt>(blockSize - filled);
+        const int result = inflate(&stream, Z_NO_FLUSH);
+        filled = blockSize - stream.avail_out;
+        offset = static_cast<std::size_t>(stream.next_in - input);
+
+        if (result == Z_STREAM_END)
+        {
+          // further members follow, anything else after the last is ignored
+          if (!startsWith(data.substr(offset), kGzipMagic))
+            break;
+          inflateReset(&stream);
+        }
+        else if (result != Z_OK)
+        {
+          fail(result == Z_BUF_ERROR ? "Truncated gzip data" : "Corrupt gzip data");
+        }
+
+        if (stream.avail_in == 0)
+        {
+          if (offset == data.size())
+            fail("Truncated gzip data");
+          stream.avail_in = static_cast<uInt>(std::min(data.size() - offset, kMaxInflateInput));
+        }
+        if (filled == blockSize)
+        {
+          flush(std::move(block), offset);
+          block.assign(blockSize, '\0');
+          filled = 0;
+        }
+      }
+      block.resize(filled);
+      flush(std::move(block), offset);
+    }
+
+#ifdef LOGVIEWER_WITH_ZSTD
+    // same for zstd frames
+    template <typename Flush>
+    void decompressFrames(std::string_view data, std::size_t blockSize, Flush &&flush)
+    {
+      struct ContextDeleter
+      {
+        void operator()(ZSTD_DCtx *context) const { ZSTD_freeDCtx(context); }
+      };
+      std::unique_ptr<ZSTD_DCtx, ContextDeleter> context(ZSTD_createDCtx());
+      if (!context)
+        throw std::runtime_error("Cannot initialize zstd decompression");
+
+      ZSTD_inBuffer input{data.data(), data.size(), 0};
+      std::string block(blockSize, '\0');
+      ZSTD_outBuffer output{block.data(), blockSize, 0};
+      // what the last call that got anywhere says is left of the frame
+      std::size_t pending = 0;
+      while (true)
+      {
+        const auto read = input.pos;
+        const auto written = output.pos;
+        const auto result = ZSTD_decompressStream(context.get(), &output, &input);
+        // a call between frames without input asks for the next header
+        if (ZSTD_isError(result) || input.pos != read || output.pos != written)
+          pending = result;
+        if (ZSTD_isError(result))
+          break;
+        // a full block may leave output behind in the context
+        if (output.pos == output.size)
+        {
+          flush(std::move(block), input.pos);
+          block.assign(blockSize, '\0');
+          output = {block.data(), blockSize, 0};
+          continue;
+        }
+        if (input.pos == input.size)
+          break;
+      }
+      // what was decompressed before the damage is handed over first
+      block.resize(output.pos);
+      flush(std::move(block), input.pos);
+      if (ZSTD_isError(pending))
+        throw std::runtime_error(std::string("Corrupt zstd data: ") + ZSTD_getErrorName(pending));
+      // a frame still waiting for input
+      if (pending != 0)
+        throw std::runtime_error("Truncated zstd data");
+    }
+#endif
+  } // namespace
+
+  CompressedFile::Format CompressedFile::Detect(const std::filesystem::path &file)
+  {
+    std::ifstream input(file, std::ios::binary);
+    char magic[sizeof(kZstdMagic)] = {};
+    input.read(magic, sizeof(magic));
+    return formatOf(std::string_view(magic, static_cast<std::size_t>(input.gcount())));
+  }
+
+  CompressedFile::CompressedFile(const std::filesystem::path &file, ThreadPool &pool)
+      : m_file(file), m_format(formatOf(m_file.View())), m_pool(pool)
+  {
+    if (m_format == Format::None)
+      throw std::runtime_error(file.string() + " is not gzip or zstd compressed");
+#ifndef LOGVIEWER_WITH_ZSTD
+    if (m_format == Format::Zstd)
+      throw std::runtime_error(file.string() + " is zstd compressed, this build reads gzip only");
+#endif
+    m_file.AdviseSequential();
+    if (m_pool.Size() > 1)
+      m_parts = findParts();
+    m_thread = std::thread(&CompressedFile::run, this);
+  }
+
+  CompressedFile::~CompressedFile()
+  {
+    m_stop = true;
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  CompressedFile::Format CompressedFile::GetFormat() const
+  {
+    return m_format;
+  }
+
+  bool CompressedFile::IsParallel() const
+  {
+    return m_parts.size() > 1;
+  }
+
+  uint64_t CompressedFile::GetCompressedSize() const
+  {
+    return m_file.Size();
+  }
+
+  uint64_t CompressedFile::GetCompressedConsumed() const
+  {
+    return m_consumed.load(std::memory_order_relaxed);
+  }
+
+  void CompressedFile::Check() const
+  {
+    if (m_done.load(std::memory_order_acquire) && m_error)
+      std::rethrow_exception(m_error);
+  }
+
+  CompressedFile::int_type CompressedFile::underflow()
+  {
+    if (gptr() < egptr())
+      return traits_type::to_int_type(*gptr());
+
+    // the block before is read to its end
+    m_consumed.store(m_current.compressedEnd, std::memory_order_relaxed);
+    while (true)
+    {
+      // read before popping: every block is queued before m_done is set
+      const bool done = m_done.load(std::memory_order_acquire);
+      if (m_queue.TryPop(m_current))
+      {
+        if (m_current.data.empty())
+        {
+          m_consumed.store(m_current.compressedEnd, std::memory_order_relaxed);
+          continue;
+        }
+        char *begin = m_current.data.data();
+        setg(begin, begin, begin + m_current.data.size());
+        return traits_type::to_int_type(*gptr());
+      }
+      if (done)
+        return traits_type::eof();
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+
+  void CompressedFile::run()
+  {
+    try
+    {
+      if (IsParallel())
+        decompressParts(m_parts);
+      else if (m_format == Format::Gzip)
+        inflateAll();
+#ifdef LOGVIEWER_WITH_ZSTD
+      else
+        decompressZstdStream();
+#endif
+    }
+    catch (...)
+    {
+      m_error = std::current_exception();
+    }
+    m_done.store(true, std::memory_order_release);
+  }
+
+  void CompressedFile::inflateAll()
+  {
+    // a stop request surfaces as an exception to leave the inflate loop
+    struct Stopped
+    {
+    };
+    try
+    {
+      inflateMembers(m_file.View(), kBlockSize, [this](std::string &&data, std::size_t end)
+                     {
+                       if (!put({std::move(data), end}))
+                         throw Stopped(); });
+    }
+    catch (const Stopped &)
+    {
+    }
+  }
+
+#ifdef LOGVIEWER_WITH_ZSTD
+  void CompressedFile::decompressZstdStream()
+  {
+    struct Stopped
+    {
+    };
+    try
+    {
+      decompressFrames(m_file.View(), kBlockSize, [this](std::string &&data, std::size_t end)
+                       {
+                         if (!put({std::move(data), end}))
+                           throw Stopped(); });
+    }
+    catch (const Stopped &)
+    {
+    }
+  }
+#endif
+
+  void CompressedFile::decompressParts(const std::vector<Part> &parts)
+  {
+    // bounds the memory held by decompressed blocks not yet queued
+    const std::size_t maxInFlight = 2 * m_pool.Size();
+    std::deque<std::future<Block>> inFlight;
+    auto waitAll = [&inFlight]
+    {
+      for (auto &future : inFlight)
+        future.wait();
+      inFlight.clear();
+    };
+
+    try
+    {
+      std::size_t next = 0;
+      while (next < parts.size() || !inFlight.empty())
+      {
+        while (next < parts.size() && inFlight.size() < maxInFlight)
+        {
+          inFlight.push_back(m_pool.Submit([this, part = parts[next]]
+                                           { return decompressPart(part); }));
+          ++next;
+        }
+        auto block = inFlight.front().get();
+        inFlight.pop_front();
+        if (!put(std::move(block)))
+          break;
+      }
+    }
+    catch (...)
+    {
+      // the tasks read the mapping, none may outlive this call
+      waitAll();
+      throw;
+    }
+    waitAll();
+  }
+
+  CompressedFile::Block CompressedFile::decompressPart(const Part &part) const
+  {
+    const auto data = m_file.View().substr(part.begin, part.end - part.begin);
+    Block block;
+    block.compressedEnd = part.end;
+    auto append = [&block](std::string &&data, std::size_t)
+    {
+      if (block.data.empty())
+        block.data = std::move(data);
+      else
+        block.data += data;
+    };
+#ifdef LOGVIEWER_WITH_ZSTD
+    if (m_format == Format::Zstd)
+    {
+      decompressFrames(data, kBlockSize, append);
+      return block;
+    }
+#endif
+    inflateMembers(data, kBlockSize, append);
+    return block;
+  }
+
+  std::vector<CompressedFile::Part> CompressedFile::findParts() const
+  {
+    const auto data = m_file.View();
+    std::vector<Part> parts;
+    std::size_t offset = 0;
+    while (offset < data.size())
+    {
+      std::size_t size = 0;
+      if (m_format == Format::Gzip)
+      {
+        auto member = bgzfMemberSize(data, offset);
+        if (!member)
+          return {};
+        size = *member;
+      }
+#ifdef LOGVIEWER_WITH_ZSTD
+      else
+      {
+        size = ZSTD_findFrameCompressedSize(data.data() + offset, data.size() - offset);
+        if (ZSTD_isError(size))
+          return {};
+      }
+#endif
+      if (size == 0)
+        return {};
+
+      // small members are grouped into parts worth a task
+      if (!parts.empty() && parts.back().end - parts.back().begin < kPartSize)
+        parts.back().end = offset + size;
+      else
+        parts.push_back({offset, offset + size});
+      offset += size;
+    }
+    return parts;
+  }
+
+  bool CompressedFile::put(Block &&block)
+  {
+    // the queue is bounded, so a slow reader throttles decompression
+    while (!m_queue.TryPush(std::move(block)))
+    {
+      if (m_stop.load(std::memory_order_relaxed))
+        return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+} // namespace util
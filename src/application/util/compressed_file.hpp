@@ -0,0 +1,111 @@
+#ifndef UTIL_COMPRESSEDFILE_HPP
+#define UTIL_COMPRESSEDFILE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/mapped_file.hpp"
+#include "util/spsc_queue.hpp"
+#include "util/thread_pool.hpp"
+
+namespace util
+{
+	// Stream buffer that reads a gzip or zstd compressed file as its
+	// decompressed bytes, for a std::istream in front of a parser. The file
+	// is mapped and decompressed on a thread of its own, a few blocks ahead
+	// of the reader.
+	//
+	// Files of independent parts are decompressed in parallel on the pool:
+	// gzip members that record their size (BGZF, as bgzip writes them) and
+	// zstd files of several frames (zstd -B, the seekable format). Other
+	// files are inflated front to back. zstd needs LOGVIEWER_WITH_ZSTD.
+	class CompressedFile : public std::streambuf
+	{
+	public:
+		enum class Format
+		{
+			None,
+			Gzip,
+			Zstd
+		};
+
+		// by the magic bytes of the file, None if it cannot be read
+		static Format Detect(const std::filesystem::path &file);
+
+		// throws std::runtime_error if the file is not compressed by a
+		// supported format
+		explicit CompressedFile(const std::filesystem::path &file, ThreadPool &pool = ThreadPool::Shared());
+		~CompressedFile();
+
+		CompressedFile(const CompressedFile &) = delete;
+		CompressedFile &operator=(const CompressedFile &) = delete;
+
+		Format GetFormat() const;
+		// whether the parts of the file are decompressed in parallel
+		bool IsParallel() const;
+		uint64_t GetCompressedSize() const;
+		// compressed bytes of the data handed to the reader so far
+		uint64_t GetCompressedConsumed() const;
+		// Throws the error that ended decompression early, a reader sees
+		// it as the end of the data. Call it once the end was reached.
+		void Check() const;
+
+	protected:
+		int_type underflow() override;
+
+	private:
+		struct Block
+		{
+			std::string data;
+			// offset in the file where the compressed data of the block ends
+			uint64_t compressedEnd{0};
+		};
+
+		// compressed parts that are decompressed on their own
+		struct Part
+		{
+			std::size_t begin;
+			std::size_t end;
+		};
+
+		void run();
+		void inflateAll();
+		void decompressParts(const std::vector<Part> &parts);
+		Block decompressPart(const Part &part) const;
+		// parts of about kPartSize, none if the file cannot be split
+		std::vector<Part> findParts() const;
+#ifdef LOGVIEWER_WITH_ZSTD
+		void decompressZstdStream();
+#endif
+		// false if the reader went away
+		bool put(Block &&block);
+
+	private:
+		static constexpr std::size_t kBlockSize = 1 << 20;
+		// compressed bytes per task, logs compress about tenfold so a part
+		// decompresses to around a block
+		static constexpr std::size_t kPartSize = 128 << 10;
+		static constexpr std::size_t kQueuedBlocks = 16;
+
+		MappedFile m_file;
+		Format m_format;
+		ThreadPool &m_pool;
+		std::vector<Part> m_parts;
+		SpscQueue<Block> m_queue{kQueuedBlocks};
+		Block m_current;
+		std::atomic<uint64_t> m_consumed{0};
+		std::atomic<bool> m_stop{false};
+		std::atomic<bool> m_done{false};
+		std::exception_ptr m_error;
+		std::thread m_thread;
+	};
+
+} // namespace util
+
+#endif // UTIL_COMPRESSEDFILE_HPP
@@ -0,0 +1,176 @@
+#include "util/file_watcher.hpp"
+
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#define UTIL_FILEWATCHER_KQUEUE
+#include <fcntl.h>
+#include <sys/event.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace util
+{
+  std::optional<FileWatcher::FileId> FileWatcher::identify(const std::filesystem::path &path)
+  {
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      return std::nullopt;
+    BY_HANDLE_FILE_INFORMATION info;
+    const bool known = GetFileInformationByHandle(file, &info);
+    CloseHandle(file);
+    if (!known)
+      return std::nullopt;
+    return FileId{info.dwVolumeSerialNumber, (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow};
+#else
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0)
+      return std::nullopt;
+    return FileId{static_cast<uint64_t>(info.st_dev), static_cast<uint64_t>(info.st_ino)};
+#endif
+  }
+
+  bool FileWatcher::IsReplaced() const
+  {
+    return identify(m_path) != m_id;
+  }
+
+#if defined(_WIN32)
+  FileWatcher::FileWatcher(const std::filesystem::path &path) : m_path(path), m_id(identify(path))
+  {
+    // Windows notifies about directories only, any write in it wakes us up
+    auto directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(L".");
+    HANDLE handle = FindFirstChangeNotificationW(directory.c_str(), FALSE,
+                                                 FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE |
+                                                     FILE_NOTIFY_CHANGE_FILE_NAME);
+    if (handle != INVALID_HANDLE_VALUE)
+      m_handle = handle;
+  }
+
+  FileWatcher::~FileWatcher()
+  {
+    if (m_handle != nullptr)
+      FindCloseChangeNotification(m_handle);
+  }
+
+  bool FileWatcher::Wait(std::chrono::milliseconds timeout)
+  {
+    if (m_handle == nullptr)
+    {
+      std::this_thread::sleep_for(timeout);
+      return true;
+    }
+    if (WaitForSingleObject(m_handle, static_cast<DWORD>(timeout.count())) != WAIT_OBJECT_0)
+      return false;
+    FindNextChangeNotification(m_handle);
+    return true;
+  }
+#elif defined(__linux__)
+  FileWatcher::FileWatcher(const std::filesystem::path &path) : m_path(path), m_id(identify(path))
+  {
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+      return;
+    m_watch = inotify_add_watch(m_fd, path.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+    if (m_watch < 0)
+    {
+      ::close(m_fd);
+      m_fd = -1;
+    }
+  }
+
+  FileWatcher::~FileWatcher()
+  {
+    if (m_fd >= 0)
+      ::close(m_fd);
+  }
+
+  bool FileWatcher::Wait(std::chrono::milliseconds timeout)
+  {
+    if (m_fd < 0)
+    {
+      std::this_thread::sleep_for(timeout);
+      return true;
+    }
+
+    pollfd request{m_fd, POLLIN, 0};
+    if (::poll(&request, 1, static_cast<int>(timeout.count())) <= 0)
+      return false;
+    // drain the queued events, one wake up covers all of them
+    alignas(inotify_event) char buffer[4096];
+    while (::read(m_fd, buffer, sizeof(buffer)) > 0)
+    {
+    }
+    return true;
+  }
+#elif defined(UTIL_FILEWATCHER_KQUEUE)
+  FileWatcher::FileWatcher(const std::filesystem::path &path) : m_path(path), m_id(identify(path))
+  {
+    m_watch = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_watch < 0)
+      return;
+    m_fd = kqueue();
+    if (m_fd < 0)
+      return;
+    struct kevent change;
+    EV_SET(&change, m_watch, EVFILT_VNODE, EV_ADD | EV_CLEAR, NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_RENAME | NOTE_DELETE, 0, nullptr);
+    if (kevent(m_fd, &change, 1, nullptr, 0, nullptr) < 0)
+    {
+      ::close(m_fd);
+      m_fd = -1;
+    }
+  }
+
+  FileWatcher::~FileWatcher()
+  {
+    if (m_fd >= 0)
+      ::close(m_fd);
+    if (m_watch >= 0)
+      ::close(m_watch);
+  }
+
+  bool FileWatcher::Wait(std::chrono::milliseconds timeout)
+  {
+    if (m_fd < 0)
+    {
+      std::this_thread::sleep_for(timeout);
+      return true;
+    }
+
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec wait{static_cast<time_t>(seconds.count()),
+                  static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count())};
+    struct kevent event;
+    return kevent(m_fd, nullptr, 0, &event, 1, &wait) > 0;
+  }
+#else
+  FileWatcher::FileWatcher(const std::filesystem::path &path) : m_path(path), m_id(identify(path))
+  {
+  }
+
+  FileWatcher::~FileWatcher()
+  {
+  }
+
+  bool FileWatcher::Wait(std::chrono::milliseconds timeout)
+  {
+    std::this_thread::sleep_for(timeout);
+    return true;
+  }
+#endif
+
+} // namespace util
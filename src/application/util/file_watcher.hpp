@@ -0,0 +1,56 @@
+#ifndef UTIL_FILEWATCHER_HPP
+#define UTIL_FILEWATCHER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace util
+{
+	// Waits for writes to one file with the notification mechanism of the
+	// platform: inotify on Linux, kqueue on BSD and macOS, change
+	// notifications of the directory on Windows. Where none is available it
+	// sleeps for the timeout and reports a possible change, the caller
+	// checks the file size either way. Renaming or deleting the file wakes
+	// the watcher too; the watch stays on the file, not the path, so the
+	// caller asks IsReplaced whether the path names another file now.
+	class FileWatcher
+	{
+	public:
+		explicit FileWatcher(const std::filesystem::path &path);
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher &) = delete;
+		FileWatcher &operator=(const FileWatcher &) = delete;
+
+		// true if the file may have changed, false after an idle timeout
+		bool Wait(std::chrono::milliseconds timeout);
+		// the path names another file than the watched one, or none
+		bool IsReplaced() const;
+
+	private:
+		struct FileId
+		{
+			uint64_t device{0};
+			uint64_t index{0};
+
+			bool operator==(const FileId &other) const = default;
+		};
+
+		static std::optional<FileId> identify(const std::filesystem::path &path);
+
+	private:
+		std::filesystem::path m_path;
+		std::optional<FileId> m_id;
+#ifdef _WIN32
+		void *m_handle{nullptr};
+#else
+		int m_fd{-1};
+		int m_watch{-1};
+#endif
+	};
+
+} // namespace util
+
+#endif // UTIL_FILEWATCHER_HPP
@@ -0,0 +1,91 @@
+#ifndef UTIL_LRUCACHE_HPP
+#define UTIL_LRUCACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace util
+{
+	// Bounded map that drops the least recently used entry when it is full.
+	// Pointers and references to values stay valid until the entry is
+	// dropped.
+	template <typename Key, typename Value, typename Hash = std::hash<Key>>
+	class LruCache
+	{
+	public:
+		explicit LruCache(std::size_t capacity) : m_capacity(capacity > 0 ? capacity : 1)
+		{
+			m_index.reserve(m_capacity);
+		}
+
+		// marks the entry as most recently used, null if there is none
+		Value *Find(const Key &key)
+		{
+			auto found = m_index.find(key);
+			if (found == m_index.end())
+				return nullptr;
+			m_entries.splice(m_entries.begin(), m_entries, found->second);
+			return &found->second->second;
+		}
+
+		bool Contains(const Key &key) const
+		{
+			return m_index.find(key) != m_index.end();
+		}
+
+		Value &Put(const Key &key, Value value)
+		{
+			if (auto *existing = Find(key))
+			{
+				*existing = std::move(value);
+				return *existing;
+			}
+
+			if (m_entries.size() == m_capacity)
+			{
+				// reuse the node of the oldest entry
+				auto oldest = std::prev(m_entries.end());
+				m_index.erase(oldest->first);
+				oldest->first = key;
+				oldest->second = std::move(value);
+				m_entries.splice(m_entries.begin(), m_entries, oldest);
+			}
+			else
+			{
+				m_entries.emplace_front(key, std::move(value));
+			}
+			m_index.emplace(key, m_entries.begin());
+			return m_entries.front().second;
+		}
+
+		void Clear()
+		{
+			m_index.clear();
+			m_entries.clear();
+		}
+
+		std::size_t Size() const
+		{
+			return m_entries.size();
+		}
+
+		std::size_t Capacity() const
+		{
+			return m_capacity;
+		}
+
+	private:
+		using Entries = std::list<std::pair<Key, Value>>;
+
+		std::size_t m_capacity;
+		// most recently used first
+		Entries m_entries;
+		std::unordered_map<Key, typename Entries::iterator, Hash> m_index;
+	};
+
+} // namespace util
+
+#endif // UTIL_LRUCACHE_HPP
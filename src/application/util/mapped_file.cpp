@@ -0,0 +1,183 @@
+#include "util/mapped_file.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace util
+{
+  namespace
+  {
+    std::size_t pageSize()
+    {
+#ifdef _WIN32
+      SYSTEM_INFO info;
+      GetSystemInfo(&info);
+      return info.dwPageSize;
+#else
+      return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+  } // namespace
+
+  MappedFile::MappedFile(const std::filesystem::path &path)
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error("Cannot open " + path.string());
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+      close();
+      throw std::runtime_error("Cannot stat " + path.string());
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if (m_size == 0)
+      return;
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr)
+    {
+      close();
+      throw std::runtime_error("Cannot map " + path.string());
+    }
+    m_data = static_cast<const char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+    {
+      close();
+      throw std::runtime_error("Cannot map " + path.string());
+    }
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0)
+      throw std::runtime_error("Cannot open " + path.string());
+
+    struct stat st;
+    if (::fstat(m_fd, &st) != 0)
+    {
+      close();
+      throw std::runtime_error("Cannot stat " + path.string());
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size == 0)
+      return;
+
+    void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED)
+    {
+      close();
+      throw std::runtime_error("Cannot map " + path.string());
+    }
+    m_data = static_cast<const char *>(data);
+#endif
+  }
+
+  MappedFile::~MappedFile()
+  {
+    close();
+  }
+
+  MappedFile::MappedFile(MappedFile &&other) noexcept
+  {
+    *this = std::move(other);
+  }
+
+  MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+  {
+    if (this != &other)
+    {
+      close();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+      m_file = std::exchange(other.m_file, nullptr);
+      m_mapping = std::exchange(other.m_mapping, nullptr);
+#else
+      m_fd = std::exchange(other.m_fd, -1);
+#endif
+    }
+    return *this;
+  }
+
+  const char *MappedFile::Data() const
+  {
+    return m_data;
+  }
+
+  std::size_t MappedFile::Size() const
+  {
+    return m_size;
+  }
+
+  std::string_view MappedFile::View() const
+  {
+    return {m_data, m_size};
+  }
+
+  void MappedFile::AdviseSequential() const
+  {
+#ifndef _WIN32
+    if (m_data != nullptr)
+      ::madvise(const_cast<char *>(m_data), m_size, MADV_SEQUENTIAL);
+#endif
+  }
+
+  void MappedFile::ReleaseRange(std::size_t offset, std::size_t length) const
+  {
+    if (m_data == nullptr || offset >= m_size)
+      return;
+
+    // only whole pages inside the range can be dropped
+    const std::size_t page = pageSize();
+    std::size_t begin = (offset + page - 1) / page * page;
+    std::size_t end = std::min(offset + length, m_size) / page * page;
+    if (begin >= end)
+      return;
+
+    void *address = const_cast<char *>(m_data + begin);
+#ifdef _WIN32
+    // unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(address, end - begin);
+#else
+    ::madvise(address, end - begin, MADV_DONTNEED);
+#endif
+  }
+
+  void MappedFile::close()
+  {
+#ifdef _WIN32
+    if (m_data != nullptr)
+      UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+      CloseHandle(m_mapping);
+    if (m_file != nullptr)
+      CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data != nullptr)
+      ::munmap(const_cast<char *>(m_data), m_size);
+    if (m_fd >= 0)
+      ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+  }
+
+} // namespace util
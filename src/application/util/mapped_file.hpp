@@ -0,0 +1,48 @@
+#ifndef UTIL_MAPPEDFILE_HPP
+#define UTIL_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace util
+{
+	// Read-only memory mapping of a whole file.
+	class MappedFile
+	{
+	public:
+		explicit MappedFile(const std::filesystem::path &path);
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+		MappedFile(MappedFile &&other) noexcept;
+		MappedFile &operator=(MappedFile &&other) noexcept;
+
+		const char *Data() const;
+		std::size_t Size() const;
+		std::string_view View() const;
+
+		// Hint that the mapping will be read front to back.
+		void AdviseSequential() const;
+		// Drop the pages of [offset, offset + length) from the resident set.
+		// The range stays readable and is paged in again on the next access.
+		void ReleaseRange(std::size_t offset, std::size_t length) const;
+
+	private:
+		void close();
+
+	private:
+		const char *m_data{nullptr};
+		std::size_t m_size{0};
+#ifdef _WIN32
+		void *m_file{nullptr};
+		void *m_mapping{nullptr};
+#else
+		int m_fd{-1};
+#endif
+	};
+
+} // namespace util
+
+#endif // UTIL_MAPPEDFILE_HPP
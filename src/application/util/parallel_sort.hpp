@@ -0,0 +1,81 @@
+#ifndef UTIL_PARALLELSORT_HPP
+#define UTIL_PARALLELSORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <vector>
+
+#include "util/thread_pool.hpp"
+
+namespace util
+{
+	// Sorts runs of the values on the pool, then merges neighbouring runs
+	// pairwise, every merge of a round in parallel, through a buffer of the
+	// same size. Small inputs are sorted on the calling thread. Not stable.
+	//
+	// Must not be called from a worker of the pool, it waits for its tasks.
+	template <typename T, typename Compare = std::less<>>
+	void ParallelSort(std::vector<T> &values, Compare less = {}, ThreadPool &pool = ThreadPool::Shared())
+	{
+		// below this a run is not worth a task
+		constexpr std::size_t kMinRun = 32768;
+
+		const std::size_t size = values.size();
+		const std::size_t runs = std::min(pool.Size(), size / kMinRun);
+		if (runs < 2)
+		{
+			std::sort(values.begin(), values.end(), less);
+			return;
+		}
+
+		auto wait = [](std::vector<std::future<void>> &tasks)
+		{
+			for (auto &task : tasks)
+				task.wait();
+			for (auto &task : tasks)
+				task.get();
+			tasks.clear();
+		};
+
+		std::vector<std::size_t> bounds;
+		for (std::size_t run = 0; run <= runs; ++run)
+			bounds.push_back(size * run / runs);
+
+		std::vector<std::future<void>> tasks;
+		for (std::size_t run = 0; run < runs; ++run)
+		{
+			tasks.push_back(pool.Submit([&values, &less, begin = bounds[run], end = bounds[run + 1]]
+										{ std::sort(values.begin() + begin, values.begin() + end, less); }));
+		}
+		wait(tasks);
+
+		std::vector<T> buffer(size);
+		auto *from = &values;
+		auto *to = &buffer;
+		while (bounds.size() > 2)
+		{
+			std::vector<std::size_t> merged;
+			for (std::size_t run = 0; run + 1 < bounds.size(); run += 2)
+			{
+				merged.push_back(bounds[run]);
+				const auto begin = bounds[run];
+				const auto middle = bounds[run + 1];
+				const auto end = run + 2 < bounds.size() ? bounds[run + 2] : middle;
+				tasks.push_back(pool.Submit([from, to, &less, begin, middle, end]
+											{ std::merge(from->begin() + begin, from->begin() + middle, from->begin() + middle,
+														 from->begin() + end, to->begin() + begin, less); }));
+			}
+			merged.push_back(size);
+			wait(tasks);
+			bounds = std::move(merged);
+			std::swap(from, to);
+		}
+		if (from != &values)
+			values.swap(buffer);
+	}
+
+} // namespace util
+
+#endif // UTIL_PARALLELSORT_HPP
@@ -0,0 +1,231 @@
+#include "util/profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <utility>
+
+namespace util
+{
+  namespace
+  {
+    Profiler::Clock::duration bucketBound(std::size_t bucket)
+    {
+      return std::chrono::nanoseconds(uint64_t(1) << (bucket + 1));
+    }
+
+    std::string formatDuration(Profiler::Clock::duration duration)
+    {
+      const double ms = std::chrono::duration<double, std::milli>(duration).count();
+      char text[32];
+      if (ms >= 1000)
+        std::snprintf(text, sizeof(text), "%.2f s", ms / 1000);
+      else if (ms >= 1)
+        std::snprintf(text, sizeof(text), "%.1f ms", ms);
+      else
+        std::snprintf(text, sizeof(text), "%.0f us", ms * 1000);
+      return text;
+    }
+
+    void writeJsonString(std::ostream &out, std::string_view text)
+    {
+      out << '"';
+      for (char c : text)
+      {
+        if (c == '"' || c == '\\')
+          out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+          out << ' ';
+        else
+          out << c;
+      }
+      out << '"';
+    }
+  } // namespace
+
+  Profiler::Site::Site(std::string name) : m_name(std::move(name))
+  {
+  }
+
+  const std::string &Profiler::Site::Name() const
+  {
+    return m_name;
+  }
+
+  void Profiler::Site::Record(Clock::duration duration)
+  {
+    const auto ns = static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0));
+    m_totalNs.fetch_add(ns, std::memory_order_relaxed);
+    auto max = m_maxNs.load(std::memory_order_relaxed);
+    while (ns > max && !m_maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+    {
+    }
+    const auto bucket = std::min<std::size_t>(ns == 0 ? 0 : std::bit_width(ns) - 1, kBuckets - 1);
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Profiler &Profiler::Instance()
+  {
+    // never destroyed, threads may still record while the program exits
+    static Profiler *profiler = new Profiler();
+    return *profiler;
+  }
+
+  Profiler::Site &Profiler::GetSite(std::string_view name)
+  {
+    std::lock_guard lock(m_mutex);
+    for (const auto &site : m_sites)
+    {
+      if (site->Name() == name)
+        return *site;
+    }
+    m_sites.push_back(std::make_unique<Site>(std::string(name)));
+    return *m_sites.back();
+  }
+
+  std::vector<Profiler::Summary> Profiler::GetSummaries() const
+  {
+    std::vector<Summary> summaries;
+    std::lock_guard lock(m_mutex);
+    for (const auto &site : m_sites)
+    {
+      Summary summary;
+      summary.name = site->Name();
+      std::array<uint64_t, kBuckets> buckets;
+      for (std::size_t b = 0; b < kBuckets; ++b)
+      {
+        buckets[b] = site->m_buckets[b].load(std::memory_order_relaxed);
+        summary.count += buckets[b];
+      }
+      if (summary.count == 0)
+        continue;
+      summary.total = std::chrono::nanoseconds(site->m_totalNs.load(std::memory_order_relaxed));
+      summary.max = std::chrono::nanoseconds(site->m_maxNs.load(std::memory_order_relaxed));
+
+      uint64_t seen = 0;
+      bool p50 = false;
+      for (std::size_t b = 0; b < kBuckets; ++b)
+      {
+        seen += buckets[b];
+        if (!p50 && seen * 2 >= summary.count)
+        {
+          summary.p50 = bucketBound(b);
+          p50 = true;
+        }
+        if (seen * 100 >= summary.count * 99)
+        {
+          summary.p99 = bucketBound(b);
+          break;
+        }
+      }
+      summaries.push_back(std::move(summary));
+    }
+    std::ranges::sort(summaries, [](const Summary &left, const Summary &right)
+                      { return left.total > right.total; });
+    return summaries;
+  }
+
+  std::string Profiler::FormatSummary(std::size_t sites) const
+  {
+    std::string text;
+    for (const auto &summary : GetSummaries())
+    {
+      if (sites-- == 0)
+        break;
+      if (!text.empty())
+        text += " | ";
+      text += summary.name + " " + std::to_string(summary.count) + "x " + formatDuration(summary.total) +
+              " p50 " + formatDuration(summary.p50) + " p99 " + formatDuration(summary.p99);
+    }
+    return text;
+  }
+
+  void Profiler::Reset()
+  {
+    std::lock_guard lock(m_mutex);
+    for (const auto &site : m_sites)
+    {
+      site->m_totalNs = 0;
+      site->m_maxNs = 0;
+      for (auto &bucket : site->m_buckets)
+        bucket = 0;
+    }
+    for (const auto &thread : m_threads)
+    {
+      std::lock_guard threadLock(thread->mutex);
+      thread->events.clear();
+    }
+  }
+
+  void Profiler::StartTrace()
+  {
+    {
+      std::lock_guard lock(m_mutex);
+      for (const auto &thread : m_threads)
+      {
+        std::lock_guard threadLock(thread->mutex);
+        thread->events.clear();
+      }
+      m_traceStart = Clock::now();
+    }
+    m_tracing.store(true, std::memory_order_release);
+  }
+
+  void Profiler::StopTrace()
+  {
+    m_tracing.store(false, std::memory_order_release);
+  }
+
+  bool Profiler::IsTracing() const
+  {
+    return m_tracing.load(std::memory_order_acquire);
+  }
+
+  void Profiler::WriteChromeTrace(std::ostream &out) const
+  {
+    std::lock_guard lock(m_mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto &thread : m_threads)
+    {
+      std::lock_guard threadLock(thread->mutex);
+      for (const auto &event : thread->events)
+      {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":";
+        writeJsonString(out, event.site->Name());
+        out << ",\"cat\":\"logviewer\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id
+            << ",\"ts\":" << std::chrono::duration<double, std::micro>(event.start - m_traceStart).count()
+            << ",\"dur\":" << std::chrono::duration<double, std::micro>(event.duration).count() << "}";
+      }
+    }
+    out << "\n]}\n";
+  }
+
+  void Profiler::Record(Site &site, Clock::time_point start, Clock::time_point end)
+  {
+    site.Record(end - start);
+    if (!m_tracing.load(std::memory_order_relaxed))
+      return;
+
+    auto &trace = threadTrace();
+    std::lock_guard lock(trace.mutex);
+    if (trace.events.size() < kMaxTraceEvents)
+      trace.events.push_back({&site, start, end - start});
+  }
+
+  Profiler::ThreadTrace &Profiler::threadTrace()
+  {
+    // the profiler is a never destroyed singleton, the pointer stays valid
+    thread_local ThreadTrace *trace = nullptr;
+    if (trace == nullptr)
+    {
+      std::lock_guard lock(m_mutex);
+      trace = m_threads.emplace_back(std::make_unique<ThreadTrace>()).get();
+      trace->id = static_cast<uint32_t>(m_threads.size());
+    }
+    return *trace;
+  }
+
+} // namespace util
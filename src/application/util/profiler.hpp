@@ -0,0 +1,139 @@
+#ifndef UTIL_PROFILER_HPP
+#define UTIL_PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace util
+{
+	// Latency statistics of named code sites and, while a trace is recorded,
+	// every single run of them for chrome://tracing or Perfetto. Sites are
+	// entered through LOGVIEWER_PROFILE_SCOPE, which compiles to nothing
+	// unless the build defines LOGVIEWER_PROFILING.
+	class Profiler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		// bucket b counts the runs that took [2^b, 2^(b+1)) ns
+		static constexpr std::size_t kBuckets = 40;
+		// per thread, a trace stops growing once a thread recorded this many runs
+		static constexpr std::size_t kMaxTraceEvents = 1 << 20;
+
+		// Statistics of one site, updated from any thread without a lock.
+		class Site
+		{
+		public:
+			explicit Site(std::string name);
+
+			const std::string &Name() const;
+			void Record(Clock::duration duration);
+
+		private:
+			friend class Profiler;
+
+			const std::string m_name;
+			std::atomic<uint64_t> m_totalNs{0};
+			std::atomic<uint64_t> m_maxNs{0};
+			std::array<std::atomic<uint64_t>, kBuckets> m_buckets{};
+		};
+
+		struct Summary
+		{
+			std::string name;
+			uint64_t count{0};
+			Clock::duration total{};
+			Clock::duration max{};
+			// upper bounds of the histogram bucket the percentile falls into
+			Clock::duration p50{};
+			Clock::duration p99{};
+		};
+
+		static Profiler &Instance();
+
+		// the site of this name, created on first use, it lives as long as the profiler
+		Site &GetSite(std::string_view name);
+		// sites that ran, the most total time first
+		std::vector<Summary> GetSummaries() const;
+		// one line for a status bar of the `sites` that took the most time
+		std::string FormatSummary(std::size_t sites = 3) const;
+		// forgets the statistics and the trace, the sites stay
+		void Reset();
+
+		void StartTrace();
+		void StopTrace();
+		bool IsTracing() const;
+		// the recorded runs as Chrome trace event JSON
+		void WriteChromeTrace(std::ostream &out) const;
+
+		void Record(Site &site, Clock::time_point start, Clock::time_point end);
+
+	private:
+		struct TraceEvent
+		{
+			const Site *site;
+			Clock::time_point start;
+			Clock::duration duration;
+		};
+
+		struct ThreadTrace
+		{
+			uint32_t id{0};
+			std::mutex mutex;
+			std::vector<TraceEvent> events;
+		};
+
+		Profiler() = default;
+		ThreadTrace &threadTrace();
+
+	private:
+		mutable std::mutex m_mutex;
+		std::vector<std::unique_ptr<Site>> m_sites;
+		// kept after their threads ended, their runs are part of the trace
+		std::vector<std::unique_ptr<ThreadTrace>> m_threads;
+		std::atomic<bool> m_tracing{false};
+		Clock::time_point m_traceStart{};
+	};
+
+	// Records the time from its construction to its destruction on a site.
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(Profiler::Site &site) : m_site(site), m_start(Profiler::Clock::now()) {}
+
+		~ProfileScope()
+		{
+			Profiler::Instance().Record(m_site, m_start, Profiler::Clock::now());
+		}
+
+		ProfileScope(const ProfileScope &) = delete;
+		ProfileScope &operator=(const ProfileScope &) = delete;
+
+	private:
+		Profiler::Site &m_site;
+		const Profiler::Clock::time_point m_start;
+	};
+
+} // namespace util
+
+#define LOGVIEWER_PROFILE_CONCAT_(a, b) a##b
+#define LOGVIEWER_PROFILE_CONCAT(a, b) LOGVIEWER_PROFILE_CONCAT_(a, b)
+
+#ifdef LOGVIEWER_PROFILING
+// times the rest of the enclosing scope as the site `name`
+#define LOGVIEWER_PROFILE_SCOPE(name)                                                                                  \
+	static util::Profiler::Site &LOGVIEWER_PROFILE_CONCAT(profileSite, __LINE__) = util::Profiler::Instance().GetSite(name); \
+	const util::ProfileScope LOGVIEWER_PROFILE_CONCAT(profileScope, __LINE__)(LOGVIEWER_PROFILE_CONCAT(profileSite, __LINE__))
+#else
+#define LOGVIEWER_PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif // UTIL_PROFILER_HPP
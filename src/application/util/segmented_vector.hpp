@@ -0,0 +1,240 @@
+#ifndef UTIL_SEGMENTEDVECTOR_HPP
+#define UTIL_SEGMENTEDVECTOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace util
+{
+	namespace segments
+	{
+		// segment s holds kFirst << s elements and starts at kFirst * (2^s - 1)
+		inline constexpr std::size_t kFirst = 16;
+		inline constexpr std::size_t kMax = 40;
+		inline constexpr int kFirstShift = std::countr_zero(kFirst);
+
+		constexpr std::size_t Index(std::size_t i)
+		{
+			return static_cast<std::size_t>(std::bit_width(i + kFirst) - 1 - kFirstShift);
+		}
+
+		constexpr std::size_t Start(std::size_t segment)
+		{
+			return kFirst * ((std::size_t(1) << segment) - 1);
+		}
+
+		constexpr std::size_t Capacity(std::size_t segment)
+		{
+			return kFirst << segment;
+		}
+	} // namespace segments
+
+	// Element range of a SegmentedVector as of the size it had when the span
+	// was taken, or of a flat array. It stays valid while the vector grows.
+	template <typename T>
+	class SegmentedSpan
+	{
+	public:
+		SegmentedSpan() = default;
+		SegmentedSpan(std::span<T> flat) : m_flat(flat.data()), m_size(flat.size()) {}
+		SegmentedSpan(T *const *segments, std::size_t size) : m_segments(segments), m_size(size) {}
+
+		std::size_t size() const
+		{
+			return m_size;
+		}
+
+		bool empty() const
+		{
+			return m_size == 0;
+		}
+
+		T &operator[](std::size_t i) const
+		{
+			if (m_flat != nullptr)
+				return m_flat[i];
+			const auto segment = segments::Index(i);
+			return m_segments[segment][i - segments::Start(segment)];
+		}
+
+		// calls fn(run, first) for the contiguous runs that cover [first, last)
+		template <typename Fn>
+		void ForEachRun(std::size_t first, std::size_t last, Fn &&fn) const
+		{
+			last = std::min(last, m_size);
+			if (m_flat != nullptr)
+			{
+				if (first < last)
+					fn(std::span<T>(m_flat + first, last - first), first);
+				return;
+			}
+			while (first < last)
+			{
+				const auto segment = segments::Index(first);
+				const auto start = segments::Start(segment);
+				const auto end = std::min(last, start + segments::Capacity(segment));
+				fn(std::span<T>(m_segments[segment] + (first - start), end - first), first);
+				first = end;
+			}
+		}
+
+	private:
+		T *m_flat{nullptr};
+		T *const *m_segments{nullptr};
+		std::size_t m_size{0};
+	};
+
+	// Append-only sequence for one writer thread and any number of readers.
+	// Elements live in segments that double in size and never move, and the
+	// size is published after the elements it covers, so a reader may index
+	// anything below size() while the writer appends, without a lock.
+	// clear and assignment are not safe against concurrent readers.
+	template <typename T>
+	class SegmentedVector
+	{
+	public:
+		SegmentedVector() = default;
+		SegmentedVector(std::size_t count, const T &value)
+		{
+			resize(count, value);
+		}
+
+		SegmentedVector(const SegmentedVector &) = delete;
+		SegmentedVector &operator=(const SegmentedVector &) = delete;
+
+		~SegmentedVector()
+		{
+			release();
+		}
+
+		std::size_t size() const
+		{
+			return m_size.load(std::memory_order_acquire);
+		}
+
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		T &operator[](std::size_t i)
+		{
+			const auto segment = segments::Index(i);
+			return m_segments[segment][i - segments::Start(segment)];
+		}
+
+		const T &operator[](std::size_t i) const
+		{
+			const auto segment = segments::Index(i);
+			return m_segments[segment][i - segments::Start(segment)];
+		}
+
+		// writer side
+		T &back()
+		{
+			return (*this)[m_size.load(std::memory_order_relaxed) - 1];
+		}
+
+		const T &back() const
+		{
+			return (*this)[size() - 1];
+		}
+
+		void push_back(T value)
+		{
+			const auto count = m_size.load(std::memory_order_relaxed);
+			T &slot = grow(count);
+			slot = std::move(value);
+			m_size.store(count + 1, std::memory_order_release);
+		}
+
+		// grows to `count` elements, the new ones are value initialized
+		void resize(std::size_t count)
+		{
+			if (count <= m_size.load(std::memory_order_relaxed))
+				return;
+			// slots past the size have not been written since their segment was allocated
+			allocate(segments::Index(count - 1));
+			m_size.store(count, std::memory_order_release);
+		}
+
+		// grows to `count` elements, the new ones are copies of `value`
+		void resize(std::size_t count, const T &value)
+		{
+			auto current = m_size.load(std::memory_order_relaxed);
+			if (count <= current)
+				return;
+			for (; current < count; ++current)
+				grow(current) = value;
+			m_size.store(count, std::memory_order_release);
+		}
+
+		// allocates the segments for this many elements up front
+		void reserve(std::size_t count)
+		{
+			if (count > 0)
+				allocate(segments::Index(count - 1));
+		}
+
+		std::size_t capacity() const
+		{
+			std::size_t total = 0;
+			for (std::size_t segment = 0; segment < segments::kMax && m_segments[segment] != nullptr; ++segment)
+				total += segments::Capacity(segment);
+			return total;
+		}
+
+		void clear()
+		{
+			release();
+			m_size.store(0, std::memory_order_release);
+		}
+
+		SegmentedSpan<const T> View() const
+		{
+			return {m_segments.data(), size()};
+		}
+
+		template <typename Fn>
+		void ForEachRun(std::size_t first, std::size_t last, Fn &&fn) const
+		{
+			View().ForEachRun(first, last, std::forward<Fn>(fn));
+		}
+
+	private:
+		T &grow(std::size_t index)
+		{
+			const auto segment = segments::Index(index);
+			if (m_segments[segment] == nullptr)
+				allocate(segment);
+			return m_segments[segment][index - segments::Start(segment)];
+		}
+
+		void allocate(std::size_t last)
+		{
+			for (std::size_t segment = 0; segment <= last; ++segment)
+			{
+				if (m_segments[segment] == nullptr)
+					m_segments[segment] = new T[segments::Capacity(segment)]();
+			}
+		}
+
+		void release()
+		{
+			for (auto &segment : m_segments)
+				delete[] std::exchange(segment, nullptr);
+		}
+
+	private:
+		std::array<T *, segments::kMax> m_segments{};
+		std::atomic<std::size_t> m_size{0};
+	};
+
+} // namespace util
+
+#endif // UTIL_SEGMENTEDVECTOR_HPP
@@ -0,0 +1,203 @@
+#include "util/spill_file.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace util
+{
+  namespace
+  {
+    // regions start at multiples of it, mappings must
+    std::size_t granularity()
+    {
+#ifdef _WIN32
+      SYSTEM_INFO info;
+      GetSystemInfo(&info);
+      return info.dwAllocationGranularity;
+#else
+      return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+  } // namespace
+
+  SpillFile::SpillFile(const std::filesystem::path &directory)
+  {
+    const auto folder = directory.empty() ? std::filesystem::temp_directory_path() : directory;
+#ifdef _WIN32
+    static std::atomic<unsigned> created{0};
+    m_path = folder / ("logviewer-spill-" + std::to_string(GetCurrentProcessId()) + "-" +
+                       std::to_string(created++) + ".tmp");
+    HANDLE file = CreateFileW(m_path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_NEW,
+                              FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error("Cannot create a spill file in " + folder.string());
+    m_file = file;
+#else
+    std::string name = (folder / "logviewer-spill-XXXXXX").string();
+    m_fd = ::mkstemp(name.data());
+    if (m_fd < 0)
+      throw std::runtime_error("Cannot create a spill file in " + folder.string());
+    m_path = name;
+    // the open descriptor keeps the file, it goes with it even on a crash
+    ::unlink(name.c_str());
+#endif
+  }
+
+  SpillFile::~SpillFile()
+  {
+    close();
+  }
+
+  char *SpillFile::Allocate(std::size_t size)
+  {
+    const std::size_t unit = granularity();
+    const std::size_t rounded = (std::max<std::size_t>(size, 1) + unit - 1) / unit * unit;
+
+    if (m_mappings.empty() || m_mappings.back().size - m_mappings.back().used < rounded)
+    {
+      const std::size_t offset = m_fileSize;
+      const std::size_t length = std::max(kMappingSize, rounded);
+#ifdef _WIN32
+      LARGE_INTEGER end;
+      end.QuadPart = static_cast<LONGLONG>(offset + length);
+      if (!SetFilePointerEx(m_file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file))
+        return nullptr;
+      HANDLE handle = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(end.QuadPart >> 32),
+                                         static_cast<DWORD>(end.QuadPart), nullptr);
+      if (handle == nullptr)
+        return nullptr;
+      void *data = MapViewOfFile(handle, FILE_MAP_WRITE, static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32),
+                                 static_cast<DWORD>(offset), length);
+      if (data == nullptr)
+      {
+        CloseHandle(handle);
+        return nullptr;
+      }
+      m_mappings.push_back({static_cast<char *>(data), length, offset, 0, handle});
+#else
+      // the blocks are reserved up front, a write to a mapping of a full
+      // disk would raise SIGBUS
+#ifdef __linux__
+      if (::posix_fallocate(m_fd, static_cast<off_t>(offset), static_cast<off_t>(length)) != 0)
+        return nullptr;
+#else
+      if (::ftruncate(m_fd, static_cast<off_t>(offset + length)) != 0)
+        return nullptr;
+#endif
+      void *data = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, static_cast<off_t>(offset));
+      if (data == MAP_FAILED)
+        return nullptr;
+      m_mappings.push_back({static_cast<char *>(data), length, offset, 0});
+#endif
+      m_fileSize += length;
+    }
+
+    auto &mapping = m_mappings.back();
+    char *region = mapping.data + mapping.used;
+    mapping.used += rounded;
+    m_size += rounded;
+    return region;
+  }
+
+  void SpillFile::Release(char *data, std::size_t size) const
+  {
+    const auto *mapping = find(data);
+    if (mapping == nullptr || size == 0)
+      return;
+    size = std::min(size, static_cast<std::size_t>(mapping->data + mapping->size - data));
+#ifdef _WIN32
+    FlushViewOfFile(data, size);
+    // unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(data, size);
+#else
+    // the caller does not wait for the disk, the dirty pages stay in the
+    // page cache until they are written back
+    ::msync(data, size, MS_ASYNC);
+    ::madvise(data, size, MADV_DONTNEED);
+#ifdef POSIX_FADV_DONTNEED
+    // starts the write back, the pages leave the page cache once clean
+    ::posix_fadvise(m_fd, static_cast<off_t>(mapping->offset + (data - mapping->data)), static_cast<off_t>(size),
+                    POSIX_FADV_DONTNEED);
+#endif
+#endif
+  }
+
+  void SpillFile::Clear()
+  {
+    unmap();
+    m_size = 0;
+    // a file that cannot be emptied keeps its size, new mappings go after it
+#ifdef _WIN32
+    LARGE_INTEGER start;
+    start.QuadPart = 0;
+    if (SetFilePointerEx(m_file, start, nullptr, FILE_BEGIN) && SetEndOfFile(m_file))
+      m_fileSize = 0;
+#else
+    if (::ftruncate(m_fd, 0) == 0)
+      m_fileSize = 0;
+#endif
+  }
+
+  std::size_t SpillFile::Size() const
+  {
+    return m_size;
+  }
+
+  const std::filesystem::path &SpillFile::GetPath() const
+  {
+    return m_path;
+  }
+
+  const SpillFile::Mapping *SpillFile::find(const char *data) const
+  {
+    // regions are mostly released soon after they were handed out
+    for (auto mapping = m_mappings.rbegin(); mapping != m_mappings.rend(); ++mapping)
+    {
+      if (data >= mapping->data && data < mapping->data + mapping->size)
+        return &*mapping;
+    }
+    return nullptr;
+  }
+
+  void SpillFile::unmap()
+  {
+    for (const auto &mapping : m_mappings)
+    {
+#ifdef _WIN32
+      UnmapViewOfFile(mapping.data);
+      CloseHandle(mapping.handle);
+#else
+      ::munmap(mapping.data, mapping.size);
+#endif
+    }
+    m_mappings.clear();
+  }
+
+  void SpillFile::close()
+  {
+    unmap();
+#ifdef _WIN32
+    if (m_file != nullptr)
+      CloseHandle(m_file);
+    m_file = nullptr;
+#else
+    if (m_fd >= 0)
+      ::close(m_fd);
+    m_fd = -1;
+#endif
+  }
+
+} // namespace util
@@ -0,0 +1,78 @@
+#ifndef UTIL_SPILLFILE_HPP
+#define UTIL_SPILLFILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace util
+{
+	// Scratch file handing out writable memory that is backed by it rather
+	// than by RAM or swap. Regions are cut from large mappings of the file,
+	// so a file of many gigabytes takes a few hundred mappings, and never
+	// move. A released region keeps its contents: they are written to the
+	// file and its pages leave memory, to be read back in when they are
+	// touched, so what is spilled costs disk space, not memory. The file is
+	// deleted when the SpillFile goes, on POSIX already when it is created.
+	class SpillFile
+	{
+	public:
+		// Creates the file in the directory, the temp directory if empty.
+		// Throws std::runtime_error if it cannot be created.
+		explicit SpillFile(const std::filesystem::path &directory = {});
+		~SpillFile();
+
+		SpillFile(const SpillFile &) = delete;
+		SpillFile &operator=(const SpillFile &) = delete;
+
+		// Region of at least `size` bytes at the end of the file, null if the
+		// file cannot grow, e.g. because the disk is full.
+		char *Allocate(std::size_t size);
+		// starts writing a region out and drops its pages without waiting for
+		// the disk, it stays readable and writable
+		void Release(char *data, std::size_t size) const;
+		// Unmaps every region and empties the file. The regions handed out
+		// are gone.
+		void Clear();
+
+		// bytes handed out
+		std::size_t Size() const;
+		const std::filesystem::path &GetPath() const;
+
+		// the file grows by mappings of this size, or of a larger region
+		static constexpr std::size_t kMappingSize = 64 << 20;
+
+	private:
+		struct Mapping
+		{
+			char *data;
+			std::size_t size;
+			// of the mapping in the file
+			std::size_t offset;
+			// bytes of it handed out
+			std::size_t used;
+#ifdef _WIN32
+			void *handle;
+#endif
+		};
+
+		// the mapping that holds `data`, null if none does
+		const Mapping *find(const char *data) const;
+		void unmap();
+		void close();
+
+	private:
+		std::filesystem::path m_path;
+		std::vector<Mapping> m_mappings;
+		std::size_t m_fileSize{0};
+		std::size_t m_size{0};
+#ifdef _WIN32
+		void *m_file{nullptr};
+#else
+		int m_fd{-1};
+#endif
+	};
+
+} // namespace util
+
+#endif // UTIL_SPILLFILE_HPP
@@ -0,0 +1,61 @@
+#ifndef UTIL_SPSCQUEUE_HPP
+#define UTIL_SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+	// Bounded lock-free queue for exactly one producer and one consumer thread.
+	template <typename T>
+	class SpscQueue
+	{
+	public:
+		explicit SpscQueue(std::size_t capacity)
+		{
+			std::size_t size = 1;
+			while (size < capacity)
+				size <<= 1;
+			m_slots.resize(size);
+			m_mask = size - 1;
+		}
+
+		// producer side; `value` is left untouched if the queue is full
+		bool TryPush(T &&value)
+		{
+			auto tail = m_tail.load(std::memory_order_relaxed);
+			if (tail - m_head.load(std::memory_order_acquire) == m_slots.size())
+				return false;
+			m_slots[tail & m_mask] = std::move(value);
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// consumer side
+		bool TryPop(T &value)
+		{
+			auto head = m_head.load(std::memory_order_relaxed);
+			if (head == m_tail.load(std::memory_order_acquire))
+				return false;
+			value = std::move(m_slots[head & m_mask]);
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool Empty() const
+		{
+			return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+		}
+
+	private:
+		std::vector<T> m_slots;
+		std::size_t m_mask{0};
+		alignas(64) std::atomic<std::size_t> m_head{0};
+		alignas(64) std::atomic<std::size_t> m_tail{0};
+	};
+
+} // namespace util
+
+#endif // UTIL_SPSCQUEUE_HPP
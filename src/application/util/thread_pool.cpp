@@ -0,0 +1,109 @@
+#include "util/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace util
+{
+  namespace
+  {
+    thread_local const ThreadPool *t_pool = nullptr;
+    thread_local std::size_t t_workerIndex = 0;
+  } // namespace
+
+  ThreadPool::ThreadPool(std::size_t threads)
+  {
+    threads = std::max<std::size_t>(threads, 1);
+    for (std::size_t i = 0; i < threads; ++i)
+      m_workers.push_back(std::make_unique<Worker>());
+    for (std::size_t i = 0; i < threads; ++i)
+      m_threads.emplace_back(&ThreadPool::run, this, i);
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard lock(m_wakeMutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &thread : m_threads)
+      thread.join();
+  }
+
+  ThreadPool &ThreadPool::Shared()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  std::size_t ThreadPool::Size() const
+  {
+    return m_workers.size();
+  }
+
+  void ThreadPool::push(Task task)
+  {
+    auto index = t_pool == this ? t_workerIndex : m_nextWorker++ % m_workers.size();
+    {
+      // counted first so a sleeping worker never misses the task
+      std::lock_guard lock(m_wakeMutex);
+      ++m_pending;
+    }
+    {
+      std::lock_guard lock(m_workers[index]->mutex);
+      m_workers[index]->tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+  }
+
+  bool ThreadPool::tryPop(std::size_t index, Task &task)
+  {
+    auto &worker = *m_workers[index];
+    std::lock_guard lock(worker.mutex);
+    if (worker.tasks.empty())
+      return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+  }
+
+  bool ThreadPool::trySteal(std::size_t index, Task &task)
+  {
+    for (std::size_t i = 1; i < m_workers.size(); ++i)
+    {
+      auto &victim = *m_workers[(index + i) % m_workers.size()];
+      std::lock_guard lock(victim.mutex);
+      if (!victim.tasks.empty())
+      {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void ThreadPool::run(std::size_t index)
+  {
+    t_pool = this;
+    t_workerIndex = index;
+
+    while (true)
+    {
+      Task task;
+      if (tryPop(index, task) || trySteal(index, task))
+      {
+        --m_pending;
+        task();
+        continue;
+      }
+
+      std::unique_lock lock(m_wakeMutex);
+      m_wake.wait(lock, [this]
+                  { return m_stop || m_pending > 0; });
+      if (m_stop && m_pending == 0)
+        return;
+    }
+  }
+
+} // namespace util
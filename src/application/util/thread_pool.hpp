@@ -0,0 +1,72 @@
+#ifndef UTIL_THREADPOOL_HPP
+#define UTIL_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace util
+{
+	// Work stealing thread pool. Every worker owns a task deque; it pops its
+	// own tasks LIFO and steals from the other workers FIFO when it runs dry.
+	// Tasks submitted from a worker go to that worker's deque.
+	class ThreadPool
+	{
+	public:
+		explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		// pool shared by the whole application, one worker per core
+		static ThreadPool &Shared();
+
+		std::size_t Size() const;
+
+		template <typename F>
+		auto Submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+		{
+			using Result = std::invoke_result_t<std::decay_t<F>>;
+			auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+			auto future = packaged->get_future();
+			push([packaged]
+				 { (*packaged)(); });
+			return future;
+		}
+
+	private:
+		using Task = std::function<void()>;
+
+		struct Worker
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		void push(Task task);
+		bool tryPop(std::size_t index, Task &task);
+		bool trySteal(std::size_t index, Task &task);
+		void run(std::size_t index);
+
+	private:
+		std::vector<std::unique_ptr<Worker>> m_workers;
+		std::vector<std::thread> m_threads;
+		std::atomic<std::size_t> m_nextWorker{0};
+		std::atomic<std::size_t> m_pending{0};
+		std::mutex m_wakeMutex;
+		std::condition_variable m_wake;
+		bool m_stop{false};
+	};
+
+} // namespace util
+
+#endif // UTIL_THREADPOOL_HPP
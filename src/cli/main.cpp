@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <csignal>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "cli/batch_run.hpp"
+#include "cli/event_writer.hpp"
+#include "db/event_cache.hpp"
+#include "search/event_filter.hpp"
+#include "search/matcher.hpp"
+#include "util/thread_pool.hpp"
+
+DEFINE_string(output, "-", "file to write to, - for stdout or, for cache, the sidecar of the log");
+DEFINE_string(format, "csv", "csv, jsonl or cache (the sidecar the viewer reopens one whole log from, "
+                             "holds every event in memory until the end)");
+DEFINE_string(filter, "", "field conditions, e.g. \"type=ERROR,WARN timestamp>=2024-01-01\"");
+DEFINE_string(query, "", "text an event has to contain in one of its values");
+DEFINE_bool(regex, false, "the query is a regex");
+DEFINE_bool(case_sensitive, false, "match the query case sensitively");
+DEFINE_string(columns, "", "comma separated CSV columns, the fields of the log if empty");
+DEFINE_string(event_element, "event", "XML element of an event");
+DEFINE_uint32(threads, 0, "worker threads, all cores if 0");
+DEFINE_uint64(block_rows, 65536, "events filtered and written at a time, bounds the memory held");
+
+namespace
+{
+  cli::BatchRun *g_run = nullptr;
+
+  void onInterrupt(int)
+  {
+    if (g_run != nullptr)
+      g_run->Stop();
+  }
+
+  std::vector<std::string> splitColumns(const std::string &text)
+  {
+    std::vector<std::string> columns;
+    std::istringstream stream(text);
+    for (std::string column; std::getline(stream, column, ',');)
+    {
+      if (!column.empty())
+        columns.push_back(column);
+    }
+    return columns;
+  }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  gflags::SetUsageMessage("parses logs, filters them and writes the events that pass\n"
+                          "usage: LogViewer_cli [flags] <log> [<log>...]");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc < 2)
+  {
+    gflags::ShowUsageWithFlags(argv[0]);
+    return 2;
+  }
+
+  try
+  {
+    std::vector<std::filesystem::path> files(argv + 1, argv + argc);
+
+    cli::BatchRun::Options options;
+    options.filter = search::EventFilter::Parse(FLAGS_filter);
+    if (!FLAGS_query.empty())
+    {
+      search::SearchOptions searchOptions;
+      searchOptions.mode = FLAGS_regex ? search::SearchOptions::Mode::Regex : search::SearchOptions::Mode::Literal;
+      searchOptions.caseSensitive = FLAGS_case_sensitive;
+      options.query = std::make_shared<search::Matcher>(FLAGS_query, searchOptions);
+    }
+    options.eventElement = FLAGS_event_element;
+    options.blockRows = std::max<uint64_t>(FLAGS_block_rows, 1);
+
+    const auto format = cli::EventWriter::ParseFormat(FLAGS_format);
+    std::string output = FLAGS_output;
+    if (format == cli::EventWriter::Format::Cache)
+    {
+      // the sidecar stands for the whole log as the viewer parses it
+      if (files.size() != 1 || !FLAGS_filter.empty() || !FLAGS_query.empty())
+        throw std::runtime_error("cache output takes one log and no filter or query");
+      if (output == "-")
+        output = db::EventCache::SidecarPath(files.front()).string();
+    }
+    std::ofstream file;
+    if (output != "-")
+    {
+      file.open(output, std::ios::binary | std::ios::trunc);
+      if (!file)
+        throw std::runtime_error("cannot open " + output);
+    }
+    std::ostream &out = file.is_open() ? static_cast<std::ostream &>(file) : std::cout;
+    std::ios::sync_with_stdio(false);
+
+    util::ThreadPool pool(FLAGS_threads > 0 ? FLAGS_threads : std::thread::hardware_concurrency());
+    cli::EventWriter writer(out, format, splitColumns(FLAGS_columns), pool);
+    if (format == cli::EventWriter::Format::Cache)
+      writer.SetCacheLog(files.front());
+    cli::BatchRun run(std::move(options), writer, pool);
+
+    g_run = &run;
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+    cli::BatchRun::Stats stats;
+    try
+    {
+      stats = run.Run(files);
+    }
+    catch (const std::runtime_error &)
+    {
+      // the events of the logs that did not fail are written regardless
+      g_run = nullptr;
+      writer.Finish();
+      throw;
+    }
+    g_run = nullptr;
+    writer.Finish();
+
+    std::cerr << "parsed " << stats.parsed << " events, wrote " << stats.written << "\n";
+  }
+  catch (const std::exception &e)
+  {
+    g_run = nullptr;
+    std::cerr << "LogViewer_cli: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/application/cli/batch_run.hpp"
+#include "tests/test_logs.hpp"
+
+namespace cli
+{
+  namespace
+  {
+    // every third event is an error, every tenth mentions a timeout
+    std::filesystem::path writeLog(const std::string &name, int first, int count)
+    {
+      auto event = [](int i)
+      {
+        const int second = i / 1000 % 60;
+        return "<timestamp>2024-01-01 10:00:" + std::string(second < 10 ? "0" : "") + std::to_string(second) + "." +
+               std::to_string(i % 1000) + "</timestamp><type>" + (i % 3 ? "INFO" : "ERROR") + "</type><info>" +
+               (i % 10 ? "done " : "timeout ") + std::to_string(i) + "</info>";
+      };
+      return tests::WriteLog(name + ".xml", tests::EventsLog(first, count, event));
+    }
+
+    std::vector<std::string> lines(const std::string &text)
+    {
+      std::vector<std::string> result;
+      std::istringstream stream(text);
+      for (std::string line; std::getline(stream, line);)
+        result.push_back(line);
+      return result;
+    }
+  } // namespace
+
+  TEST(BatchRunTest, WritesEveryEventWithoutConditions)
+  {
+    auto log = writeLog("all", 0, 1000);
+    std::ostringstream out;
+    EventWriter writer(out, EventWriter::Format::Csv, {"type"});
+    BatchRun::Options options;
+    options.blockRows = 64;
+    BatchRun run(std::move(options), writer);
+
+    auto stats = run.Run({log});
+    writer.Finish();
+    EXPECT_EQ(stats.parsed, 1000);
+    EXPECT_EQ(stats.written, 1000);
+    auto written = lines(out.str());
+    ASSERT_EQ(written.size(), 1001);
+    EXPECT_EQ(written[0], "id,type");
+    EXPECT_EQ(written[1], "0,ERROR");
+    EXPECT_EQ(written[1000], "999,ERROR");
+    std::filesystem::remove(log);
+  }
+
+  TEST(BatchRunTest, AppliesTheFilterAndTheQueryInEveryBlock)
+  {
+    auto log = writeLog("filtered", 0, 3000);
+    std::ostringstream out;
+    EventWriter writer(out, EventWriter::Format::Csv, {"info"});
+    BatchRun::Options options;
+    options.filter = search::EventFilter::Parse("type=ERROR");
+    options.query = std::make_shared<search::Matcher>("TIMEOUT", search::SearchOptions{search::SearchOptions::Mode::Literal, false});
+    options.blockRows = 100;
+    BatchRun run(std::move(options), writer);
+
+    auto stats = run.Run({log});
+    writer.Finish();
+    EXPECT_EQ(stats.parsed, 3000);
+    // multiples of 30
+    EXPECT_EQ(stats.written, 100);
+    auto written = lines(out.str());
+    ASSERT_EQ(written.size(), 101);
+    EXPECT_EQ(written[1], "0,timeout 0");
+    EXPECT_EQ(written[2], "30,timeout 30");
+    EXPECT_EQ(written[100], "2970,timeout 2970");
+    std::filesystem::remove(log);
+  }
+
+  TEST(BatchRunTest, MergesSeveralLogsByTime)
+  {
+    auto early = writeLog("early", 0, 500);
+    auto late = writeLog("late", 500, 500);
+    std::ostringstream out;
+    EventWriter writer(out, EventWriter::Format::JsonLines);
+    BatchRun run({}, writer);
+
+    auto stats = run.Run({late, early});
+    writer.Finish();
+    EXPECT_EQ(stats.written, 1000);
+    auto written = lines(out.str());
+    ASSERT_EQ(written.size(), 1000);
+    EXPECT_NE(written.front().find("\"info\":\"timeout 0\""), std::string::npos);
+    EXPECT_NE(written.back().find("\"info\":\"done 999\""), std::string::npos);
+    std::filesystem::remove(early);
+    std::filesystem::remove(late);
+  }
+
+  TEST(BatchRunTest, ThrowsTheErrorOfALogThatFails)
+  {
+    std::ostringstream out;
+    EventWriter writer(out, EventWriter::Format::Csv);
+    BatchRun run({}, writer);
+    EXPECT_THROW(run.Run({tests::TempPath("missing.xml")}), std::runtime_error);
+  }
+}
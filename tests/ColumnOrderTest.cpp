@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/application/search/column_order.hpp"
+
+namespace
+{
+  // few distinct short values the store shares, and long ones that only
+  // differ after the first 8 bytes
+  std::string value(std::mt19937 &random, bool shared)
+  {
+    static const std::vector<std::string> types{"ERROR", "WARN", "INFO", "DEBUG", "TRACE", "INFO2", ""};
+    if (shared)
+      return types[random() % types.size()];
+    return "request " + std::to_string(random() % 5000) + " finished";
+  }
+
+  void expectOrdered(const db::EventStore &store, db::FieldId field, const search::ColumnOrder &order)
+  {
+    for (std::size_t position = 1; position < order.Size(); ++position)
+    {
+      const auto previous = order.Row(position - 1);
+      const auto row = order.Row(position);
+      ASSERT_LE(store.GetValue(previous, field), store.GetValue(row, field));
+      if (store.GetValue(previous, field) == store.GetValue(row, field))
+      {
+        ASSERT_LT(previous, row);
+      }
+    }
+  }
+} // namespace
+
+TEST(ColumnOrderTest, SortsByValueInParallel)
+{
+  db::EventStore store;
+  std::mt19937 random(7);
+  for (int i = 0; i < 200000; ++i)
+    store.push_back(db::Event(i, {{"type", value(random, true)}, {"info", value(random, false)}}));
+
+  util::ThreadPool pool(4);
+  for (const auto *name : {"type", "info"})
+  {
+    const auto field = *store.GetFields().Find(name);
+    search::ColumnOrder order(store, field, pool);
+    order.Assign();
+    ASSERT_EQ(order.Size(), store.size());
+    EXPECT_EQ(order.GetField(), field);
+    expectOrdered(store, field, order);
+
+    for (std::size_t row : {std::size_t(0), std::size_t(777), store.size() - 1})
+    {
+      auto position = order.Position(row);
+      ASSERT_TRUE(position);
+      EXPECT_EQ(order.Row(*position), row);
+    }
+  }
+}
+
+TEST(ColumnOrderTest, ComparesValuesBeyondTheirPrefix)
+{
+  db::EventStore store;
+  store.push_back(db::Event(0, {{"info", "connection reset"}}));
+  store.push_back(db::Event(1, {{"info", "connecti"}}));
+  store.push_back(db::Event(2, {{"info", "connection closed"}}));
+  store.push_back(db::Event(3, {{"info", std::string("connecti\0", 9)}}));
+  store.push_back(db::Event(4, {{"info", "connect"}}));
+  store.push_back(db::Event(5, {{"info", "connection reset by peer"}}));
+  store.push_back(db::Event(6, {{"info", "connection reset by"}}));
+  store.push_back(db::Event(7, {{"info", "connection reset by peeR"}}));
+  store.push_back(db::Event(8, {{"info", "connection reset"}}));
+
+  search::ColumnOrder order(store, *store.GetFields().Find("info"));
+  order.Assign();
+  EXPECT_EQ(order.GetRows(), std::vector<uint32_t>({4, 1, 3, 2, 0, 8, 6, 7, 5}));
+}
+
+TEST(ColumnOrderTest, ComparesLongValuesEqualUpToTheirEnd)
+{
+  // a level of refining per 8 tied bytes
+  const std::string common(1 << 20, 'a');
+  db::EventStore store;
+  store.push_back(db::Event(0, {{"info", common + "c"}}));
+  store.push_back(db::Event(1, {{"info", common + "b"}}));
+  store.push_back(db::Event(2, {{"info", common}}));
+  store.push_back(db::Event(3, {{"info", common + "b"}}));
+
+  util::ThreadPool pool(2);
+  search::ColumnOrder order(store, *store.GetFields().Find("info"), pool);
+  order.Assign();
+  EXPECT_EQ(order.GetRows(), std::vector<uint32_t>({2, 1, 3, 0}));
+}
+
+TEST(ColumnOrderTest, EventsWithoutTheFieldSortAsEmpty)
+{
+  db::EventStore store;
+  store.push_back(db::Event(0, {{"type", "WARN"}}));
+  store.push_back(db::Event(1, {{"info", "no type"}}));
+  store.push_back(db::Event(2, {{"type", ""}}));
+  store.push_back(db::Event(3, {{"type", "ERROR"}}));
+  store.push_back(db::Event(4, {{"info", "none either"}}));
+
+  search::ColumnOrder order(store, *store.GetFields().Find("type"));
+  order.Assign();
+  EXPECT_EQ(order.GetRows(), std::vector<uint32_t>({1, 2, 4, 3, 0}));
+}
+
+TEST(ColumnOrderTest, OrdersASubsetOfRows)
+{
+  db::EventStore store;
+  for (int i = 0; i < 10; ++i)
+    store.push_back(db::Event(i, {{"type", std::string(1, static_cast<char>('j' - i))}}));
+
+  search::ColumnOrder order(store, *store.GetFields().Find("type"));
+  const std::vector<uint32_t> even{0, 2, 4, 6, 8};
+  order.Assign(even);
+  EXPECT_EQ(order.GetRows(), std::vector<uint32_t>({8, 6, 4, 2, 0}));
+  EXPECT_FALSE(order.Position(3));
+}
+
+TEST(ColumnOrderTest, MergesAppendedRows)
+{
+  db::EventStore store;
+  for (const auto *type : {"A", "B", "C", "D"})
+    store.push_back(db::Event(static_cast<int>(store.size()), {{"type", type}}));
+  const auto field = *store.GetFields().Find("type");
+  search::ColumnOrder order(store, field);
+  order.Assign();
+
+  store.push_back(db::Event(4, {{"type", "E"}}));
+  EXPECT_TRUE(order.Add(4));
+  // ties go after the rows before them
+  store.push_back(db::Event(5, {{"type", "B"}}));
+  store.push_back(db::Event(6, {{"type", "A"}}));
+  EXPECT_FALSE(order.Add(5));
+
+  EXPECT_EQ(order.GetRows(), std::vector<uint32_t>({0, 6, 1, 5, 2, 3, 4}));
+  expectOrdered(store, field, order);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <zlib.h>
+#ifdef LOGVIEWER_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "src/application/util/compressed_file.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  // compresses about as well as a real log
+  std::string content(std::size_t bytes)
+  {
+    std::mt19937 random(3);
+    std::string text;
+    for (int i = 0; text.size() < bytes; ++i)
+      text += "<event><type>INFO</type><info>message " + std::to_string(i) + " " + std::to_string(random()) + "</info></event>\n";
+    return text;
+  }
+
+  // windowBits 15 + 16 writes a gzip member, -15 raw deflate data
+  std::string deflateWith(std::string_view data, int windowBits)
+  {
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&stream, data.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+  }
+
+  void appendLittle(std::string &out, uint32_t value, int bytes)
+  {
+    for (int i = 0; i < bytes; ++i)
+      out += static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+
+  // gzip member with the BGZF extra field that records its size
+  std::string bgzfMember(std::string_view data)
+  {
+    const auto deflated = deflateWith(data, -15);
+    std::string member("\x1f\x8b\x08\x04\0\0\0\0\0\xff", 10);
+    appendLittle(member, 6, 2);
+    member += "BC";
+    appendLittle(member, 2, 2);
+    appendLittle(member, static_cast<uint32_t>(12 + 6 + deflated.size() + 8 - 1), 2);
+    member += deflated;
+    appendLittle(member, static_cast<uint32_t>(crc32(0, reinterpret_cast<const Bytef *>(data.data()), static_cast<uInt>(data.size()))), 4);
+    appendLittle(member, static_cast<uint32_t>(data.size()), 4);
+    return member;
+  }
+
+  std::filesystem::path write(const std::string &name, const std::string &bytes)
+  {
+    auto path = tests::TempPath(name);
+    std::ofstream out(path, std::ios::binary);
+    out << bytes;
+    return path;
+  }
+
+  std::string readAll(util::CompressedFile &file)
+  {
+    std::istream input(&file);
+    return std::string(std::istreambuf_iterator<char>(input), {});
+  }
+} // namespace
+
+TEST(CompressedFileTest, DetectsFormats)
+{
+  auto gzip = write("detect.gz", deflateWith("x", 15 + 16));
+  auto zstd = write("detect.zst", std::string("\x28\xb5\x2f\xfd", 4));
+  auto plain = write("detect.xml", "<events/>");
+  EXPECT_EQ(util::CompressedFile::Detect(gzip), util::CompressedFile::Format::Gzip);
+  EXPECT_EQ(util::CompressedFile::Detect(zstd), util::CompressedFile::Format::Zstd);
+  EXPECT_EQ(util::CompressedFile::Detect(plain), util::CompressedFile::Format::None);
+  EXPECT_EQ(util::CompressedFile::Detect(tests::TempPath("nothing_here")),
+            util::CompressedFile::Format::None);
+  EXPECT_THROW(util::CompressedFile file(plain), std::runtime_error);
+  for (const auto &path : {gzip, zstd, plain})
+    std::filesystem::remove(path);
+}
+
+TEST(CompressedFileTest, InflatesGzipStream)
+{
+  const auto text = content(5 << 20);
+  auto path = write("stream.gz", deflateWith(text, 15 + 16));
+
+  util::CompressedFile file(path);
+  EXPECT_FALSE(file.IsParallel());
+  EXPECT_EQ(readAll(file), text);
+  EXPECT_NO_THROW(file.Check());
+  EXPECT_EQ(file.GetCompressedConsumed(), file.GetCompressedSize());
+  std::filesystem::remove(path);
+}
+
+TEST(CompressedFileTest, InflatesConcatenatedMembers)
+{
+  const auto first = content(100000);
+  const auto second = content(200000);
+  auto path = write("members.gz", deflateWith(first, 15 + 16) + deflateWith(second, 15 + 16));
+
+  util::CompressedFile file(path);
+  EXPECT_EQ(readAll(file), first + second);
+  std::filesystem::remove(path);
+}
+
+TEST(CompressedFileTest, InflatesBgzfMembersInParallel)
+{
+  const auto text = content(8 << 20);
+  std::string compressed;
+  for (std::size_t offset = 0; offset < text.size(); offset += 60000)
+    compressed += bgzfMember(std::string_view(text).substr(offset, 60000));
+  // the empty end of file member bgzip writes
+  compressed += bgzfMember("");
+  auto path = write("blocks.gz", compressed);
+
+  util::ThreadPool pool(4);
+  util::CompressedFile file(path, pool);
+  EXPECT_TRUE(file.IsParallel());
+  EXPECT_EQ(readAll(file), text);
+  EXPECT_NO_THROW(file.Check());
+  EXPECT_EQ(file.GetCompressedConsumed(), file.GetCompressedSize());
+  std::filesystem::remove(path);
+}
+
+TEST(CompressedFileTest, ReportsTruncatedData)
+{
+  const auto text = content(1 << 20);
+  auto compressed = deflateWith(text, 15 + 16);
+  auto path = write("truncated.gz", compressed.substr(0, compressed.size() / 2));
+
+  util::CompressedFile file(path);
+  auto read = readAll(file);
+  EXPECT_LT(read.size(), text.size());
+  EXPECT_EQ(read, text.substr(0, read.size()));
+  EXPECT_THROW(file.Check(), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(CompressedFileTest, StopsWhenTheReaderGoesAway)
+{
+  auto path = write("unread.gz", deflateWith(content(40 << 20), 15 + 16));
+  {
+    util::CompressedFile file(path);
+    std::istream input(&file);
+    char byte;
+    input.get(byte);
+    // the queue fills up, the destructor ends the decompression
+  }
+  std::filesystem::remove(path);
+}
+
+#ifdef LOGVIEWER_WITH_ZSTD
+TEST(CompressedFileTest, DecompressesZstdFramesInParallel)
+{
+  const auto text = content(8 << 20);
+  std::string compressed;
+  for (std::size_t offset = 0; offset < text.size(); offset += 1 << 20)
+  {
+    auto frame = std::string_view(text).substr(offset, 1 << 20);
+    std::string out(ZSTD_compressBound(frame.size()), '\0');
+    out.resize(ZSTD_compress(out.data(), out.size(), frame.data(), frame.size(), 3));
+    compressed += out;
+  }
+  auto path = write("frames.zst", compressed);
+
+  util::ThreadPool pool(4);
+  util::CompressedFile file(path, pool);
+  EXPECT_EQ(file.GetFormat(), util::CompressedFile::Format::Zstd);
+  EXPECT_TRUE(file.IsParallel());
+  EXPECT_EQ(readAll(file), text);
+  EXPECT_NO_THROW(file.Check());
+  std::filesystem::remove(path);
+}
+
+TEST(CompressedFileTest, DecompressesZstdStream)
+{
+  const auto text = content(3 << 20);
+  std::string compressed(ZSTD_compressBound(text.size()), '\0');
+  compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), text.data(), text.size(), 3));
+  auto path = write("stream.zst", compressed);
+
+  util::CompressedFile file(path);
+  EXPECT_FALSE(file.IsParallel());
+  EXPECT_EQ(readAll(file), text);
+  EXPECT_NO_THROW(file.Check());
+
+  auto truncated = write("truncated.zst", compressed.substr(0, compressed.size() - 10));
+  util::CompressedFile broken(truncated);
+  readAll(broken);
+  EXPECT_THROW(broken.Check(), std::runtime_error);
+  std::filesystem::remove(path);
+  std::filesystem::remove(truncated);
+}
+#endif
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "src/application/parser/compressed_log_parser.hpp"
+#include "src/application/parser/xml_parser.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  std::string log(int count)
+  {
+    auto event = [](int i)
+    {
+      return "<type>INFO</type><info>" + std::to_string(i) + "</info>";
+    };
+    return tests::EventsLog(0, count, event);
+  }
+
+  std::filesystem::path writeGzip(const std::string &name, const std::string &text)
+  {
+    auto path = tests::TempPath(name);
+    gzFile out = gzopen(path.string().c_str(), "wb");
+    gzwrite(out, text.data(), static_cast<unsigned>(text.size()));
+    gzclose(out);
+    return path;
+  }
+} // namespace
+
+TEST(CompressedLogParserTest, ParsesGzipLogs)
+{
+  auto path = writeGzip("log.xml.gz", log(20000));
+  parser::CompressedLogParser parser(std::make_unique<parser::XmlParser>());
+  tests::CollectingObserver observer;
+  parser.RegisterObserver(&observer);
+
+  parser.ParseData(path);
+  ASSERT_EQ(observer.events.size(), 20000);
+  EXPECT_EQ(observer.events.back().findByKey("info"), "19999");
+  // progress is in bytes of the compressed file
+  EXPECT_EQ(parser.GetTotalProgress(), std::filesystem::file_size(path));
+  EXPECT_EQ(parser.GetCurrentProgress(), parser.GetTotalProgress());
+  EXPECT_GT(observer.progressUpdates, 0);
+  std::filesystem::remove(path);
+}
+
+TEST(CompressedLogParserTest, PassesPlainLogsThrough)
+{
+  const auto text = log(100);
+  auto path = tests::WriteLog("plain.xml", text);
+
+  parser::CompressedLogParser parser(std::make_unique<parser::XmlParser>());
+  tests::CollectingObserver observer;
+  parser.RegisterObserver(&observer);
+  parser.ParseData(path);
+  EXPECT_EQ(observer.events.size(), 100);
+  EXPECT_EQ(parser.GetTotalProgress(), text.size());
+  std::filesystem::remove(path);
+}
+
+TEST(CompressedLogParserTest, FailsOnCorruptData)
+{
+  auto path = writeGzip("corrupt.xml.gz", log(20000));
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+  parser::CompressedLogParser parser(std::make_unique<parser::XmlParser>());
+  tests::CollectingObserver observer;
+  parser.RegisterObserver(&observer);
+  EXPECT_THROW(parser.ParseData(path), std::runtime_error);
+  // what was decompressed before the damage is parsed
+  EXPECT_GT(observer.events.size(), 0);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
+#include "src/application/search/container_search.hpp"
+
+namespace
+{
+  void append(db::EventStore &store, int first, int last)
+  {
+    for (int i = first; i < last; ++i)
+      store.push_back(db::Event(i, {{"type", i % 7 == 0 ? "error" : "info"}, {"info", "event " + std::to_string(i)}}));
+  }
+
+  std::vector<std::size_t> expected(int first, int last)
+  {
+    std::vector<std::size_t> rows;
+    for (int i = first; i < last; ++i)
+      if (i % 7 == 0)
+        rows.push_back(i);
+    return rows;
+  }
+} // namespace
+
+class ContainerSearchTest : public ::testing::Test
+{
+protected:
+  util::ThreadPool pool{4};
+  db::EventStore store;
+};
+
+TEST_F(ContainerSearchTest, FindsSortedMatches)
+{
+  append(store, 0, 100000);
+  search::ContainerSearch search(store, pool);
+
+  search.Start(std::make_shared<search::Matcher>("error"));
+  search.Wait();
+
+  EXPECT_FALSE(search.IsRunning());
+  EXPECT_EQ(search.GetResults(), expected(0, 100000));
+  EXPECT_EQ(search.GetSearchedRows(), 100000);
+}
+
+TEST_F(ContainerSearchTest, PollPublishesInOrder)
+{
+  append(store, 0, 100000);
+  search::ContainerSearch search(store, pool);
+  search.Start(std::make_shared<search::Matcher>("error"));
+
+  std::size_t seen = 0;
+  while (search.IsRunning())
+  {
+    auto count = search.Poll();
+    ASSERT_GE(count, seen);
+    seen = count;
+    const auto &results = search.GetResults();
+    ASSERT_TRUE(std::is_sorted(results.begin(), results.end()));
+    ASSERT_TRUE(results.empty() || results.back() < search.GetSearchedRows());
+  }
+  EXPECT_EQ(search.GetResults(), expected(0, 100000));
+}
+
+TEST_F(ContainerSearchTest, ResumeCoversAppendedRows)
+{
+  append(store, 0, 50000);
+  search::ContainerSearch search(store, pool);
+  search.Start(std::make_shared<search::Matcher>("error"));
+
+  search.Suspend();
+  append(store, 50000, 80000);
+  search.Resume();
+  search.Wait();
+
+  EXPECT_EQ(search.GetResults(), expected(0, 80000));
+}
+
+TEST_F(ContainerSearchTest, AppendsWhileScanning)
+{
+  append(store, 0, 50000);
+  search::ContainerSearch search(store, pool);
+  search.Start(std::make_shared<search::Matcher>("error"));
+
+  // the scan keeps reading the rows it started with
+  append(store, 50000, 80000);
+  search.Wait();
+  EXPECT_EQ(search.GetResults(), expected(0, 50000));
+
+  search.Resume();
+  search.Wait();
+  EXPECT_EQ(search.GetResults(), expected(0, 80000));
+}
+
+TEST_F(ContainerSearchTest, QueuesRowsAppendedWhileScanning)
+{
+  append(store, 0, 100000);
+  search::ContainerSearch search(store, pool);
+  search.Start(std::make_shared<search::Matcher>("error"));
+  search.Poll();
+  const auto searched = search.GetSearchedRows();
+
+  // the running scan goes on, the new rows are searched after it
+  append(store, 100000, 130000);
+  search.Resume();
+  EXPECT_GE(search.GetSearchedRows(), searched);
+  while (search.IsRunning())
+  {
+    search.Poll();
+    const auto &results = search.GetResults();
+    ASSERT_TRUE(std::is_sorted(results.begin(), results.end()));
+  }
+  EXPECT_EQ(search.GetResults(), expected(0, 130000));
+  EXPECT_EQ(search.GetSearchedRows(), 130000);
+}
+
+TEST_F(ContainerSearchTest, StartReplacesPreviousSearch)
+{
+  append(store, 0, 30000);
+  search::ContainerSearch search(store, pool);
+  search.Start(std::make_shared<search::Matcher>("info"));
+  search.Start(std::make_shared<search::Matcher>("event 2999\\d"));
+  search.Wait();
+
+  std::vector<std::size_t> rows;
+  for (std::size_t i = 29990; i < 30000; ++i)
+    rows.push_back(i);
+  EXPECT_EQ(search.GetResults(), rows);
+}
+
+TEST_F(ContainerSearchTest, CancelForgetsSearch)
+{
+  append(store, 0, 30000);
+  search::ContainerSearch search(store, pool);
+  search.Start(std::make_shared<search::Matcher>("error"));
+  search.Cancel();
+
+  EXPECT_FALSE(search.IsActive());
+  EXPECT_FALSE(search.IsRunning());
+  EXPECT_TRUE(search.GetResults().empty());
+
+  search.Resume();
+  EXPECT_FALSE(search.IsRunning());
+}
+
+TEST_F(ContainerSearchTest, EmptyStore)
+{
+  search::ContainerSearch search(store, pool);
+  search.Start(std::make_shared<search::Matcher>("error"));
+  search.Wait();
+
+  EXPECT_TRUE(search.IsActive());
+  EXPECT_FALSE(search.IsRunning());
+  EXPECT_TRUE(search.GetResults().empty());
+}
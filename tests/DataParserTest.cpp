@@ -14,8 +14,8 @@ class MockDataParser : public parser::DataParser
 {
 public:
   MOCK_METHOD(void, ParseData, (std::istream & input), (override));
-  MOCK_METHOD(uint32_t, GetCurrentProgress, (), (const, override));
-  MOCK_METHOD(uint32_t, GetTotalProgress, (), (const, override));
+  MOCK_METHOD(uint64_t, GetCurrentProgress, (), (const, override));
+  MOCK_METHOD(uint64_t, GetTotalProgress, (), (const, override));
   MOCK_METHOD(db::Event &, GetEvent, (), (const, override));
 };
 
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "src/application/db/event_cache.hpp"
+#include "src/application/db/events_container.hpp"
+#include "src/application/util/mapped_file.hpp"
+#include "tests/test_logs.hpp"
+
+namespace db
+{
+  namespace
+  {
+    void fill(EventStore &store)
+    {
+      store.push_back(Event(10, {{"timestamp", "t0"}, {"type", "INFO"}, {"info", "first"}}));
+      store.push_back(Event(11, {{"type", "ERROR"}, {"data", "a"}, {"data", "b"}, {"data", "c"}}));
+      store.push_back(Event(12, {{"timestamp", "t2"}, {"type", "INFO"}, {"info", std::string(3000, 'x')}}));
+    }
+
+    void expectFilled(const EventStore &store)
+    {
+      ASSERT_EQ(store.size(), 3);
+      EXPECT_EQ(store.at(0).getId(), 10);
+      EXPECT_EQ(store.at(2).getId(), 12);
+      EXPECT_EQ(store.at(0).findByKey("info"), "first");
+      EXPECT_EQ(store.at(1).findByKey("info"), "");
+      EXPECT_EQ(store.at(2).findByKey("info"), std::string(3000, 'x'));
+
+      auto items = store.at(1).getEventItems();
+      ASSERT_EQ(items.size(), 4);
+      EXPECT_EQ(items[0], EventView::Item("type", "ERROR"));
+      EXPECT_EQ(items[1], EventView::Item("data", "a"));
+      EXPECT_EQ(items[3], EventView::Item("data", "c"));
+
+      auto type = *store.GetFields().Find("type");
+      EXPECT_EQ(store.GetColumn(type).size(), 3);
+      EXPECT_EQ(store.GetString(store.GetColumn(type)[1]), "ERROR");
+    }
+  } // namespace
+
+  TEST(EventCacheTest, ImageServesTheSameEvents)
+  {
+    EventStore original;
+    fill(original);
+    auto path = tests::TempPath("store.image");
+    {
+      std::ofstream out(path, std::ios::binary);
+      original.Save(out);
+    }
+
+    EventStore mapped;
+    mapped.Map(std::make_shared<const util::MappedFile>(path));
+    EXPECT_TRUE(mapped.IsMapped());
+    expectFilled(mapped);
+    std::filesystem::remove(path);
+  }
+
+  TEST(EventCacheTest, ImageKeepsTimesAndSources)
+  {
+    EventStore original;
+    original.push_back(Event(1, {{"timestamp", "2024-01-01 00:00:01"}}));
+    Event merged(2, {{"timestamp", "2024-01-01 00:00:02"}});
+    merged.setSource(3);
+    original.push_back(merged);
+    auto path = tests::TempPath("store.times");
+    {
+      std::ofstream out(path, std::ios::binary);
+      original.Save(out);
+    }
+
+    EventStore mapped;
+    mapped.Map(std::make_shared<const util::MappedFile>(path));
+    ASSERT_EQ(mapped.GetTimes().size(), 2);
+    EXPECT_EQ(mapped.GetTime(1), *ParseTimestamp("2024-01-01 00:00:02"));
+    EXPECT_TRUE(mapped.IsTimeSorted());
+    EXPECT_EQ(mapped.GetSource(0), 0);
+    EXPECT_EQ(mapped.GetSource(1), 3);
+    std::filesystem::remove(path);
+  }
+
+  TEST(EventCacheTest, RejectsDamagedImage)
+  {
+    EventStore original;
+    fill(original);
+    std::ostringstream out;
+    original.Save(out);
+    auto image = out.str();
+
+    auto truncated = tests::WriteLog("store.truncated", image.substr(0, image.size() / 2));
+    EventStore store;
+    EXPECT_THROW(store.Map(std::make_shared<const util::MappedFile>(truncated)), std::runtime_error);
+
+    image[0] = 'X';
+    auto foreign = tests::WriteLog("store.foreign", image);
+    EXPECT_THROW(store.Map(std::make_shared<const util::MappedFile>(foreign)), std::runtime_error);
+    EXPECT_FALSE(store.IsMapped());
+
+    std::filesystem::remove(truncated);
+    std::filesystem::remove(foreign);
+
+    // ids and references out of bounds, the second value starts at offset
+    // 0x1234 of the first chunk
+    EventStore known;
+    known.push_back(Event(0x1111, {{"info", std::string(0x1232, 'a')}, {"type", "x"}}));
+    known.push_back(Event(0x2222, {{"type", "y"}}));
+    std::ostringstream knownOut;
+    known.Save(knownOut);
+    const auto knownImage = knownOut.str();
+
+    auto mapAfter = [&](auto damage)
+    {
+      auto damaged = knownImage;
+      damage(damaged);
+      auto path = tests::WriteLog("store.damaged", damaged);
+      EventStore mapped;
+      bool rejected = false;
+      try
+      {
+        mapped.Map(std::make_shared<const util::MappedFile>(path));
+      }
+      catch (const std::runtime_error &)
+      {
+        rejected = true;
+      }
+      EXPECT_NE(mapped.IsMapped(), rejected);
+      std::filesystem::remove(path);
+      return rejected;
+    };
+    auto find = [&](const std::string &bytes)
+    {
+      const auto at = knownImage.find(bytes);
+      EXPECT_NE(at, std::string::npos);
+      return at;
+    };
+    EXPECT_FALSE(mapAfter([](std::string &) {}));
+
+    // the row schemas follow the ids and the times, two of 8 bytes each
+    const auto schemas = find(std::string("\x11\x11\0\0\x22\x22\0\0", 8)) + 8 + 16;
+    for (uint16_t schema : {0x1234, 0xFFF0})
+    {
+      EXPECT_TRUE(mapAfter([&](std::string &damaged)
+                           { std::memcpy(damaged.data() + schemas, &schema, sizeof(schema)); }))
+          << schema;
+    }
+
+    const auto ref = find(std::string("\0\0\0\0\x34\x12\0\0", 8));
+    EXPECT_TRUE(mapAfter([&](std::string &damaged)
+                         { damaged[ref] = 7; }));
+    EXPECT_TRUE(mapAfter([&](std::string &damaged)
+                         { damaged[ref + 6] = 0x7F; }));
+
+    // an image size that leaves out the header
+    const uint64_t imageSize = knownImage.size();
+    const auto size = find(std::string(reinterpret_cast<const char *>(&imageSize), sizeof(imageSize)));
+    EXPECT_TRUE(mapAfter([&](std::string &damaged)
+                         { damaged[size] = 8; damaged[size + 1] = 0; }));
+
+    // a field name given twice
+    const auto names = find("infotype");
+    EXPECT_TRUE(mapAfter([&](std::string &damaged)
+                         { damaged.replace(names + 4, 4, "info"); }));
+  }
+
+  TEST(EventCacheTest, MappedStoreIsReadOnlyUntilCleared)
+  {
+    EventStore original;
+    fill(original);
+    auto log = tests::WriteLog("log.xml", "<events/>");
+    EventCache::Save(original, log);
+
+    EventStore store;
+    ASSERT_TRUE(EventCache::Open(store, log));
+    EXPECT_THROW(store.push_back(Event(13, {{"info", "more"}})), std::logic_error);
+
+    store.clear();
+    EXPECT_FALSE(store.IsMapped());
+    store.push_back(Event(13, {{"info", "more"}}));
+    ASSERT_EQ(store.size(), 1);
+    EXPECT_EQ(store.at(0).findByKey("info"), "more");
+
+    std::filesystem::remove(EventCache::SidecarPath(log));
+    std::filesystem::remove(log);
+  }
+
+  TEST(EventCacheTest, ContainerReopensFromCache)
+  {
+    auto log = tests::WriteLog("log.xml", "<events>...</events>");
+    std::filesystem::remove(EventCache::SidecarPath(log));
+
+    EventsContainer parsed;
+    parsed.AddEvent(Event(1, {{"info", "cached"}}));
+    EventsContainer reopened;
+    EXPECT_FALSE(reopened.OpenCache(log));
+
+    parsed.SaveCache(log);
+    ASSERT_TRUE(reopened.OpenCache(log));
+    ASSERT_EQ(reopened.Size(), 1);
+    EXPECT_EQ(reopened.GetEvent(0).findByKey("info"), "cached");
+
+    std::filesystem::remove(EventCache::SidecarPath(log));
+    std::filesystem::remove(log);
+  }
+
+  TEST(EventCacheTest, ChangedLogMissesTheCache)
+  {
+    EventStore original;
+    fill(original);
+    auto log = tests::WriteLog("log.xml", "<events>one</events>");
+    EventCache::Save(original, log);
+    const auto modified = std::filesystem::last_write_time(log);
+
+    // same size and modification time, only the content differs
+    tests::WriteLog("log.xml", "<events>two</events>");
+    std::filesystem::last_write_time(log, modified);
+    EventStore store;
+    EXPECT_FALSE(EventCache::Open(store, log));
+    EXPECT_FALSE(store.IsMapped());
+
+    std::filesystem::last_write_time(log, modified + std::chrono::seconds(1));
+    EXPECT_FALSE(EventCache::Open(store, log));
+
+    std::filesystem::remove(EventCache::SidecarPath(log));
+    std::filesystem::remove(log);
+  }
+
+} // namespace db
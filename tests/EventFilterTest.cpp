@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <regex>
+#include <stdexcept>
+
+#include "src/application/search/event_filter.hpp"
+
+using search::EventFilter;
+
+TEST(EventFilterTest, ParsesTerms)
+{
+  auto filter = EventFilter::Parse("type=ERROR,WARN  timestamp>=2024-01-01 timestamp<2024-01-02 info~timeout level!=DEBUG");
+  const auto &conditions = filter.GetConditions();
+  ASSERT_EQ(conditions.size(), 5);
+
+  EXPECT_EQ(conditions[0].field, "type");
+  EXPECT_EQ(conditions[0].op, EventFilter::Op::In);
+  EXPECT_EQ(conditions[0].values, (std::vector<std::string>{"ERROR", "WARN"}));
+  EXPECT_EQ(conditions[1].op, EventFilter::Op::GreaterEqual);
+  EXPECT_EQ(conditions[1].values.front(), "2024-01-01");
+  EXPECT_EQ(conditions[2].op, EventFilter::Op::Less);
+  EXPECT_EQ(conditions[3].op, EventFilter::Op::Matches);
+  ASSERT_NE(conditions[3].matcher, nullptr);
+  EXPECT_TRUE(conditions[3].matcher->Matches("read TIMEOUT"));
+  EXPECT_EQ(conditions[4].op, EventFilter::Op::NotIn);
+}
+
+TEST(EventFilterTest, QuotedValuesKeepSpacesAndCommas)
+{
+  auto filter = EventFilter::Parse("info=\"a b\",\"c,d\" timestamp>=\"2024-01-01 10:00\"");
+  const auto &conditions = filter.GetConditions();
+  ASSERT_EQ(conditions.size(), 2);
+  EXPECT_EQ(conditions[0].values, (std::vector<std::string>{"a b", "c,d"}));
+  EXPECT_EQ(conditions[1].values.front(), "2024-01-01 10:00");
+}
+
+TEST(EventFilterTest, RejectsMalformedTerms)
+{
+  EXPECT_THROW(EventFilter::Parse("type"), std::invalid_argument);
+  EXPECT_THROW(EventFilter::Parse("=ERROR"), std::invalid_argument);
+  EXPECT_THROW(EventFilter::Parse("type="), std::invalid_argument);
+  EXPECT_THROW(EventFilter::Parse("info=\"open"), std::invalid_argument);
+  EXPECT_THROW(EventFilter::Parse("info~(unbalanced"), std::regex_error);
+  EXPECT_TRUE(EventFilter::Parse("  ").Empty());
+}
+
+TEST(EventFilterTest, MissingFieldsOnlyPassNotIn)
+{
+  auto filter = EventFilter().In("type", {"ERROR"}).NotIn("type", {"DEBUG"}).Compare("t", EventFilter::Op::Less, "5");
+  const auto &conditions = filter.GetConditions();
+
+  EXPECT_FALSE(EventFilter::Passes(conditions[0], std::nullopt));
+  EXPECT_TRUE(EventFilter::Passes(conditions[1], std::nullopt));
+  EXPECT_FALSE(EventFilter::Passes(conditions[2], std::nullopt));
+  EXPECT_TRUE(EventFilter::Passes(conditions[0], "ERROR"));
+  EXPECT_FALSE(EventFilter::Passes(conditions[1], "DEBUG"));
+  EXPECT_TRUE(EventFilter::Passes(conditions[2], "4"));
+  EXPECT_FALSE(EventFilter::Passes(conditions[2], "5"));
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/application/search/event_histogram.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  // every bucket holds exactly the events of its time range
+  void expectBucketed(const db::EventStore &store, const search::EventHistogram &histogram)
+  {
+    ASSERT_TRUE(histogram.HasTimes());
+    std::vector<std::size_t> counts(search::EventHistogram::kBuckets, 0);
+    std::size_t untimed = 0;
+    for (std::size_t row = 0; row < store.size(); ++row)
+    {
+      const auto time = store.GetTime(row);
+      if (time == db::EventStore::kNoTime)
+      {
+        ++untimed;
+        continue;
+      }
+      const auto bucket = histogram.BucketOf(time);
+      ASSERT_TRUE(bucket);
+      ASSERT_LE(histogram.GetBucketStart(*bucket), time);
+      ASSERT_LT(time, histogram.GetBucketStart(*bucket) + histogram.GetBucketWidth());
+      ++counts[*bucket];
+    }
+    for (std::size_t bucket = 0; bucket < counts.size(); ++bucket)
+      ASSERT_EQ(histogram.GetBucketCount(bucket), counts[bucket]) << bucket;
+    EXPECT_EQ(histogram.GetUntimedCount(), untimed);
+  }
+} // namespace
+
+TEST(EventHistogramTest, CountsEventsByType)
+{
+  db::EventStore store;
+  store.push_back(db::Event(0, {{"type", "INFO"}}));
+  store.push_back(db::Event(1, {{"type", "ERROR"}}));
+  store.push_back(db::Event(2, {{"type", "INFO"}}));
+  store.push_back(db::Event(3, {{"info", "no type"}}));
+  store.push_back(db::Event(4, {{"type", "INFO"}}));
+
+  search::EventHistogram histogram(store);
+  histogram.Append(0, store.size());
+  EXPECT_EQ(histogram.GetCount(), 5);
+  EXPECT_EQ(histogram.GetTypes(), std::vector<std::string>({"INFO", "ERROR", ""}));
+  EXPECT_EQ(histogram.GetTypeCount(0), 3);
+  EXPECT_EQ(histogram.GetTypeCount(1), 1);
+  EXPECT_EQ(histogram.GetTypeCount(2), 1);
+  EXPECT_EQ(histogram.GetTypeCount(search::EventHistogram::kOtherTypes), 0);
+  EXPECT_FALSE(histogram.HasTimes());
+  EXPECT_EQ(histogram.GetUntimedCount(), 5);
+}
+
+TEST(EventHistogramTest, CountsTypesPastTheLimitTogether)
+{
+  db::EventStore store;
+  const int types = search::EventHistogram::kMaxTypes + 5;
+  for (int i = 0; i < types * 50; ++i)
+    store.push_back(db::Event(i, {{"type", "T" + std::to_string(i % types)}}));
+
+  search::EventHistogram histogram(store);
+  histogram.Append(0, store.size());
+  ASSERT_EQ(histogram.GetTypes().size(), search::EventHistogram::kMaxTypes);
+  std::size_t counted = histogram.GetTypeCount(search::EventHistogram::kOtherTypes);
+  for (std::size_t type = 0; type < histogram.GetTypes().size(); ++type)
+  {
+    EXPECT_EQ(histogram.GetTypes()[type], "T" + std::to_string(type));
+    counted += histogram.GetTypeCount(type);
+  }
+  EXPECT_EQ(counted, store.size());
+  EXPECT_EQ(histogram.GetTypeCount(search::EventHistogram::kOtherTypes), 5 * 50);
+}
+
+TEST(EventHistogramTest, BucketsEventsByTime)
+{
+  db::EventStore store;
+  for (int i = 0; i < 10000; ++i)
+    store.push_back(db::Event(i, {{"timestamp", tests::Timestamp(i * 7)}, {"type", i % 3 ? "INFO" : "WARN"}}));
+  store.push_back(db::Event(10000, {{"type", "INFO"}}));
+
+  search::EventHistogram histogram(store);
+  histogram.Append(0, store.size());
+  expectBucketed(store, histogram);
+  EXPECT_EQ(histogram.GetUntimedCount(), 1);
+  // the buckets are no wider than they need to be
+  EXPECT_LT(histogram.GetBucketWidth() * static_cast<int64_t>(search::EventHistogram::kBuckets),
+            4 * (store.GetTime(9999) - store.GetTime(0)));
+
+  const auto bucket = *histogram.BucketOf(store.GetTime(5000));
+  EXPECT_EQ(histogram.GetBucketCount(bucket), histogram.GetBucketCount(bucket, 0) + histogram.GetBucketCount(bucket, 1));
+  EXPECT_GE(histogram.GetMaxBucketCount(), histogram.GetBucketCount(bucket));
+  EXPECT_FALSE(histogram.BucketOf(*db::ParseTimestamp("2023-01-01")));
+}
+
+TEST(EventHistogramTest, WidensAsAppendedEventsGoBeyondTheBuckets)
+{
+  db::EventStore store;
+  search::EventHistogram histogram(store);
+  std::mt19937 random(3);
+  // a narrow range first, then ones reaching further back and forward
+  for (int64_t spread : {60, 3600, 86400, 13 * 86400})
+  {
+    const auto first = store.size();
+    for (int i = 0; i < 3000; ++i)
+    {
+      const auto second = 14 * 86400 + static_cast<int64_t>(random() % (2 * spread)) - spread;
+      store.push_back(db::Event(static_cast<int>(store.size()), {{"timestamp", tests::Timestamp(second)}}));
+    }
+    histogram.Append(first, store.size());
+    expectBucketed(store, histogram);
+  }
+  EXPECT_EQ(histogram.GetCount(), store.size());
+  EXPECT_EQ(histogram.GetUntimedCount(), 0);
+}
+
+TEST(EventHistogramTest, RebuildsForAReplacedStore)
+{
+  db::EventStore store;
+  for (int i = 0; i < 100; ++i)
+    store.push_back(db::Event(i, {{"timestamp", tests::Timestamp(i)}, {"type", "OLD"}}));
+  search::EventHistogram histogram(store);
+  histogram.Append(0, store.size());
+
+  store.clear();
+  for (int i = 0; i < 50; ++i)
+    store.push_back(db::Event(i, {{"timestamp", tests::Timestamp(86400 + i)}, {"type", "NEW"}}));
+  histogram.Rebuild();
+  EXPECT_EQ(histogram.GetCount(), 50);
+  EXPECT_EQ(histogram.GetTypes(), std::vector<std::string>({"NEW"}));
+  expectBucketed(store, histogram);
+}
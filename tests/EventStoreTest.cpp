@@ -0,0 +1,317 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "src/application/db/event_store.hpp"
+#include "src/application/util/mapped_file.hpp"
+#include "tests/test_logs.hpp"
+
+namespace db
+{
+  class EventStoreTest : public ::testing::Test
+  {
+  protected:
+    EventStore store;
+
+    void SetUp() override
+    {
+      store.push_back(Event(10, {{"timestamp", "t0"}, {"type", "INFO"}, {"info", "first"}}));
+      store.push_back(Event(11, {{"type", "ERROR"}, {"dummy", "d"}}));
+      store.push_back(Event(12, {{"timestamp", "t2"}, {"type", "INFO"}, {"info", "third"}}));
+    }
+  };
+
+  TEST_F(EventStoreTest, KeepsEventsInOrder)
+  {
+    ASSERT_EQ(store.size(), 3);
+    EXPECT_EQ(store.at(0).getId(), 10);
+    EXPECT_EQ(store.at(2).getId(), 12);
+    EXPECT_THROW(store.at(3), std::out_of_range);
+  }
+
+  TEST_F(EventStoreTest, FindByKey)
+  {
+    EXPECT_EQ(store.at(0).findByKey("info"), "first");
+    EXPECT_EQ(store.at(1).findByKey("type"), "ERROR");
+    EXPECT_EQ(store.at(1).findByKey("info"), "");
+    EXPECT_EQ(store.at(1).findByKey("unknown"), "");
+    EXPECT_EQ(store.at(2).findByKey("dummy"), "");
+  }
+
+  TEST_F(EventStoreTest, FindByResolvedField)
+  {
+    auto info = *store.GetFields().Find("info");
+    EXPECT_EQ(store.at(0).findByKey(info), "first");
+    EXPECT_EQ(store.at(1).findByKey(info), "");
+    EXPECT_EQ(store.at(2).findByKey(info), "third");
+    // ids the store has never handed out read as absent too
+    EXPECT_EQ(store.at(0).findByKey(db::FieldId(1000)), "");
+  }
+
+  TEST_F(EventStoreTest, ItemsKeepFieldOrder)
+  {
+    auto items = store.at(1).getEventItems();
+    ASSERT_EQ(items.size(), 2);
+    EXPECT_EQ(items[0], EventView::Item("type", "ERROR"));
+    EXPECT_EQ(items[1], EventView::Item("dummy", "d"));
+    EXPECT_THROW(items.at(2), std::out_of_range);
+
+    std::vector<EventView::Item> collected(items.begin(), items.end());
+    EXPECT_EQ(collected.size(), 2);
+  }
+
+  TEST_F(EventStoreTest, FieldNamesAreInterned)
+  {
+    EXPECT_EQ(store.GetFields().Size(), 4);
+    auto type = *store.GetFields().Find("type");
+    auto column = store.GetColumn(type);
+    ASSERT_EQ(column.size(), 3);
+    EXPECT_EQ(store.GetString(column[1]), "ERROR");
+    // the shared value is stored once
+    EXPECT_EQ(column[0], column[2]);
+  }
+
+  TEST_F(EventStoreTest, ColumnsOnlyGrowToLastEventWithTheField)
+  {
+    auto dummy = *store.GetFields().Find("dummy");
+    EXPECT_EQ(store.GetColumn(dummy).size(), 2);
+    EXPECT_TRUE(store.GetColumn(dummy)[0].IsNull());
+    EXPECT_TRUE(store.HasValue(1, dummy));
+    EXPECT_FALSE(store.HasValue(2, dummy));
+  }
+
+  TEST_F(EventStoreTest, RepeatedFieldsAreKept)
+  {
+    store.push_back(Event(13, {{"key1", "value1"}, {"key2", "x"}, {"key1", "value2"}, {"key1", "value3"}}));
+    auto items = store.at(3).getEventItems();
+    ASSERT_EQ(items.size(), 4);
+    EXPECT_EQ(items[0], EventView::Item("key1", "value1"));
+    EXPECT_EQ(items[2], EventView::Item("key1", "value2"));
+    EXPECT_EQ(items[3], EventView::Item("key1", "value3"));
+    EXPECT_EQ(store.at(3).findByKey("key1"), "value1");
+  }
+
+  TEST_F(EventStoreTest, ClearDropsEverything)
+  {
+    store.clear();
+    EXPECT_EQ(store.size(), 0);
+    EXPECT_EQ(store.GetFields().Size(), 0);
+    store.push_back(Event(1, {{"a", "b"}}));
+    EXPECT_EQ(store.at(0).findByKey("a"), "b");
+  }
+
+  TEST_F(EventStoreTest, ReserveKeepsColumnsInPlace)
+  {
+    store.reserve(1000);
+    const auto *column = &store.GetColumn(*store.GetFields().Find("timestamp"))[0];
+    for (int i = 3; i < 1000; ++i)
+      store.push_back(Event(i, {{"timestamp", "t"}, {"type", "info"}}));
+
+    EXPECT_EQ(&store.GetColumn(*store.GetFields().Find("timestamp"))[0], column);
+    EXPECT_EQ(store.size(), 1000);
+    EXPECT_EQ(store.at(999).findByKey("type"), "info");
+    // asking for less than is stored changes nothing
+    store.reserve(10);
+    EXPECT_EQ(store.size(), 1000);
+  }
+
+  TEST_F(EventStoreTest, ParsesTimestampsIntoTheTimeColumn)
+  {
+    // "t0" is no timestamp
+    EXPECT_EQ(store.GetTime(0), EventStore::kNoTime);
+    EXPECT_FALSE(store.IsTimeSorted());
+
+    EventStore timed;
+    timed.push_back(Event(1, {{"type", "INFO"}, {"timestamp", "2024-01-01 10:00:00"}}));
+    timed.push_back(Event(2, {{"timestamp", "2024-01-01 10:00:00.5"}, {"timestamp", "2000-01-01"}}));
+    ASSERT_EQ(timed.GetTimes().size(), 2);
+    EXPECT_EQ(timed.GetTime(0), *ParseTimestamp("2024-01-01 10:00:00"));
+    // the first occurrence counts
+    EXPECT_EQ(timed.GetTime(1) - timed.GetTime(0), 500000);
+    EXPECT_TRUE(timed.IsTimeSorted());
+
+    timed.push_back(Event(3, {{"timestamp", "2024-01-01 09:00:00"}}));
+    EXPECT_FALSE(timed.IsTimeSorted());
+    timed.clear();
+    EXPECT_TRUE(timed.GetTimes().empty());
+    EXPECT_TRUE(timed.IsTimeSorted());
+  }
+
+  TEST_F(EventStoreTest, KeepsSourcesOfMergedEvents)
+  {
+    // a single log needs no source column
+    EXPECT_EQ(store.GetSource(2), 0);
+    const auto before = store.MemoryUsage();
+
+    Event merged(13, {{"type", "INFO"}});
+    merged.setSource(4);
+    store.push_back(merged);
+    store.push_back(Event(14, {{"type", "INFO"}}));
+    EXPECT_EQ(store.GetSource(0), 0);
+    EXPECT_EQ(store.GetSource(3), 4);
+    EXPECT_EQ(store.at(3).getSource(), 4);
+    EXPECT_EQ(store.GetSource(4), 0);
+    EXPECT_GT(store.MemoryUsage(), before);
+  }
+
+  TEST_F(EventStoreTest, StoresRecurringLayoutsOnce)
+  {
+    // the first and the third event share their layout
+    EXPECT_EQ(store.GetSchemaCount(), 2);
+    for (int i = 3; i < 100; ++i)
+      store.push_back(Event(i, {{"type", "ERROR"}, {"dummy", "d"}}));
+    store.push_back(Event(100, {{"key", "a"}, {"key", "b"}}));
+    store.push_back(Event(101, {{"type", "INFO"}}));
+    EXPECT_EQ(store.GetSchemaCount(), 4);
+
+    EXPECT_EQ(store.at(99).getEventItems()[1], EventView::Item("dummy", "d"));
+    EXPECT_EQ(store.at(100).getEventItems()[1], EventView::Item("key", "b"));
+    EXPECT_EQ(store.at(101).getEventItems().size(), 1);
+  }
+
+  TEST_F(EventStoreTest, KeepsLayoutsOfTheirOwnOnceTheSchemasRunOut)
+  {
+    // every event has another subset of 17 fields
+    const int count = 70000;
+    store.clear();
+    for (int i = 0; i < count; ++i)
+    {
+      Event::EventItems items;
+      for (int bit = 0; bit < 17; ++bit)
+      {
+        if ((i + 1) >> bit & 1)
+          items.emplace_back("f" + std::to_string(bit), std::to_string(i));
+      }
+      store.push_back(Event(i, std::move(items)));
+    }
+    EXPECT_EQ(store.GetSchemaCount(), UINT16_MAX);
+
+    auto path = tests::TempPath("store.image");
+    {
+      std::ofstream out(path, std::ios::binary);
+      store.Save(out);
+    }
+    EventStore mapped;
+    mapped.Map(std::make_shared<const util::MappedFile>(path));
+    for (const EventStore *events : {&store, &mapped})
+    {
+      ASSERT_EQ(events->size(), count);
+      // 69999 + 1 has bits 4, 5, 6, 8, 12 and 16 set
+      auto items = events->at(count - 1).getEventItems();
+      ASSERT_EQ(items.size(), 6);
+      EXPECT_EQ(items[0], EventView::Item("f4", "69999"));
+      EXPECT_EQ(items[5], EventView::Item("f16", "69999"));
+      EXPECT_EQ(events->at(2).getEventItems().size(), 2);
+    }
+    std::filesystem::remove(path);
+  }
+
+  TEST_F(EventStoreTest, ReadsRowsWhileAnotherThreadAppends)
+  {
+    const int count = 50000;
+    std::atomic<bool> consistent{true};
+
+    std::thread reader([&]
+                       {
+                         std::size_t seen = 3;
+                         while (seen < count + 3)
+                         {
+                           const std::size_t rows = store.size();
+                           for (std::size_t row = seen; row < rows; ++row)
+                           {
+                             const auto value = std::to_string(row);
+                             auto event = store.at(row);
+                             if (event.getId() != static_cast<int>(row) || event.findByKey("info") != value ||
+                                 store.GetTime(row) == EventStore::kNoTime || event.getEventItems().size() != 4)
+                               consistent = false;
+                           }
+                           seen = rows;
+                         } });
+    for (int i = 3; i < count + 3; ++i)
+    {
+      // a field every so often that the dictionary has not seen yet
+      const std::string extra = i % 1000 ? "data" : "field" + std::to_string(i);
+      store.push_back(Event(i, {{"timestamp", "2024-01-01 10:00:00"}, {"info", std::to_string(i)}, {extra, "x"}, {extra, "y"}}));
+    }
+    reader.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(store.at(count + 2).getEventItems()[3], EventView::Item("data", "y"));
+  }
+
+  TEST(EventStoreMemoryTest, SpillsValuesPastTheMemoryBudget)
+  {
+    const int count = 200000;
+    const std::size_t budget = 4 << 20;
+    EventStore store;
+    store.SetMemoryBudget(budget);
+    auto info = [](int i)
+    {
+      return "request " + std::to_string(i) + " served in " + std::to_string(i % 977) + " ms by worker " + std::to_string(i % 13) + std::string(100, '.');
+    };
+    for (int i = 0; i < count; ++i)
+      store.push_back(Event(i, {{"timestamp", "2024-01-01 10:00:00." + std::to_string(i % 1000)}, {"type", i % 3 ? "INFO" : "ERROR"}, {"info", info(i)}}));
+
+    EXPECT_GT(store.GetSpilledSize(), 20 << 20);
+    // the per event arrays stay in memory, the values past the budget do not
+    EXPECT_LT(store.MemoryUsage(), budget + count * 8 * sizeof(StringRef));
+    const auto field = *store.GetFields().Find("info");
+    for (int i = 0; i < count; i += 997)
+      ASSERT_EQ(store.GetValue(i, field), info(i));
+    EXPECT_EQ(store.at(count - 1).findByKey("type"), "INFO");
+
+    auto path = tests::TempPath("store.image");
+    {
+      std::ofstream out(path, std::ios::binary);
+      store.Save(out);
+    }
+    EventStore mapped;
+    mapped.Map(std::make_shared<const util::MappedFile>(path));
+    ASSERT_EQ(mapped.size(), count);
+    EXPECT_EQ(mapped.GetValue(count - 1, field), info(count - 1));
+    std::filesystem::remove(path);
+
+    store.clear();
+    EXPECT_EQ(store.GetSpilledSize(), 0);
+    EXPECT_EQ(store.GetMemoryBudget(), budget);
+  }
+
+  TEST(EventStoreMemoryTest, ReportsASpillFileThatCannotBeCreated)
+  {
+    const std::size_t budget = 64 << 10;
+    EventStore store;
+    store.SetMemoryBudget(budget, tests::TempPath("missing"));
+    for (int i = 0; i < 4096; ++i)
+      store.push_back(Event(i, {{"info", std::to_string(i) + std::string(100, '.')}}));
+
+    EXPECT_FALSE(store.GetSpillError().empty());
+    EXPECT_EQ(store.GetSpilledSize(), 0);
+    EXPECT_EQ(store.GetMemoryBudget(), budget);
+    EXPECT_EQ(store.at(4095).findByKey("info"), "4095" + std::string(100, '.'));
+
+    store.clear();
+    EXPECT_TRUE(store.GetSpillError().empty());
+  }
+
+  TEST(EventStoreMemoryTest, UsesFarLessMemoryThanEventVectors)
+  {
+    const int count = 100000;
+    EventStore store;
+    for (int i = 0; i < count; ++i)
+      store.push_back(Event(i, {{"timestamp", "2024-01-01 10:00:00." + std::to_string(i % 1000)}, {"type", i % 3 ? "INFO" : "ERROR"}, {"info", "dummyInfo"}, {"dummy", "dummy"}}));
+
+    // the same events as Event objects: the event, its four key/value string
+    // pairs and the heap buffer of the timestamp, without allocator overhead
+    const std::size_t eventBytes = sizeof(Event) + 4 * sizeof(Event::EventItems::value_type) + 32;
+    EXPECT_LT(store.MemoryUsage() * 5, eventBytes * count);
+    // one layout, each event keeps a schema id instead of its field ids
+    EXPECT_EQ(store.GetSchemaCount(), 1);
+    EXPECT_EQ(store.at(count - 1).findByKey("timestamp"), "2024-01-01 10:00:00.999");
+  }
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <string>
 #include "src/application/db/event.hpp"
 
 namespace db
@@ -112,4 +113,31 @@ namespace db
     EXPECT_EQ(it, event.getEventItems().end());
   }
 
+  TEST(EventCopyTest, CopiesAndMovesInlineAndHeapItems)
+  {
+    const std::string longValue(2 * Event::kInlineSize, 'x');
+    for (const std::string &value : {std::string("short"), longValue})
+    {
+      Event original(1, {{"type", "INFO"}, {"info", value}});
+      Event copy(original);
+      EXPECT_EQ(copy.getEventItems(), original.getEventItems());
+      EXPECT_EQ(copy.findByKey("info"), value);
+
+      Event moved(std::move(copy));
+      EXPECT_EQ(moved.findByKey("info"), value);
+      EXPECT_TRUE(copy.getEventItems().empty());
+
+      Event assigned(2, {{"other", longValue}});
+      assigned = original;
+      EXPECT_EQ(assigned.getEventItems(), original.getEventItems());
+      assigned = std::move(moved);
+      EXPECT_EQ(assigned.findByKey("type"), "INFO");
+      EXPECT_EQ(assigned.getEventItems().size(), 2);
+
+      // items added after moving to the heap are kept with the others
+      assigned.addItem("more", longValue);
+      EXPECT_EQ(assigned.findByKey("info"), value);
+      EXPECT_EQ(assigned.findByKey("more"), longValue);
+    }
+  }
 }
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/application/cli/event_writer.hpp"
+#include "src/application/db/event_cache.hpp"
+#include "tests/test_logs.hpp"
+
+namespace cli
+{
+  class EventWriterTest : public ::testing::Test
+  {
+  protected:
+    db::EventStore store;
+    std::ostringstream out;
+
+    void SetUp() override
+    {
+      store.push_back(db::Event(1, {{"type", "INFO"}, {"info", "plain"}}));
+      store.push_back(db::Event(2, {{"type", "ERROR"}, {"info", "a, \"quoted\"\nline"}}));
+      store.push_back(db::Event(3, {{"type", "INFO"}, {"key", "x"}, {"key", "y"}}));
+    }
+  };
+
+  TEST_F(EventWriterTest, ParsesFormatNames)
+  {
+    EXPECT_EQ(EventWriter::ParseFormat("csv"), EventWriter::Format::Csv);
+    EXPECT_EQ(EventWriter::ParseFormat("jsonl"), EventWriter::Format::JsonLines);
+    EXPECT_EQ(EventWriter::ParseFormat("cache"), EventWriter::Format::Cache);
+    EXPECT_THROW(EventWriter::ParseFormat("xml"), std::invalid_argument);
+  }
+
+  TEST_F(EventWriterTest, WritesCsvWithTheFieldsOfTheFirstStore)
+  {
+    EventWriter writer(out, EventWriter::Format::Csv);
+    const std::vector<uint32_t> rows{0, 1, 2};
+    writer.Write(store, rows);
+    writer.Finish();
+
+    EXPECT_EQ(out.str(), "id,type,info,key\n"
+                         "1,INFO,plain,\n"
+                         "2,ERROR,\"a, \"\"quoted\"\"\nline\",\n"
+                         "3,INFO,,x\n");
+    EXPECT_EQ(writer.GetWritten(), 3);
+  }
+
+  TEST_F(EventWriterTest, WritesTheColumnsGivenInTheirOrder)
+  {
+    EventWriter writer(out, EventWriter::Format::Csv, {"info", "missing", "type"});
+    const std::vector<uint32_t> rows{2, 0};
+    writer.Write(store, rows);
+    writer.Finish();
+
+    EXPECT_EQ(out.str(), "id,info,missing,type\n"
+                         "3,,,INFO\n"
+                         "1,plain,,INFO\n");
+  }
+
+  TEST_F(EventWriterTest, WritesAnEscapedJsonObjectPerLine)
+  {
+    EventWriter writer(out, EventWriter::Format::JsonLines);
+    const std::vector<uint32_t> rows{1, 2};
+    writer.Write(store, rows);
+    writer.Finish();
+
+    EXPECT_EQ(out.str(), "{\"id\":2,\"type\":\"ERROR\",\"info\":\"a, \\\"quoted\\\"\\nline\"}\n"
+                         "{\"id\":3,\"type\":\"INFO\",\"key\":\"x\",\"key\":\"y\"}\n");
+  }
+
+  TEST_F(EventWriterTest, KeepsTheOrderAcrossPartitions)
+  {
+    db::EventStore large;
+    std::vector<uint32_t> rows;
+    for (int i = 0; i < 40000; ++i)
+    {
+      large.push_back(db::Event(i, {{"n", std::to_string(i)}}));
+      rows.push_back(i);
+    }
+    EventWriter writer(out, EventWriter::Format::Csv);
+    writer.Write(large, rows);
+    writer.Finish();
+
+    std::istringstream lines(out.str());
+    std::string line;
+    std::getline(lines, line);
+    for (int i = 0; i < 40000 && std::getline(lines, line); ++i)
+      ASSERT_EQ(line, std::to_string(i) + "," + std::to_string(i));
+    EXPECT_EQ(writer.GetWritten(), 40000);
+  }
+
+  TEST_F(EventWriterTest, WritesTheSidecarOfTheLog)
+  {
+    auto log = tests::WriteLog("log.xml", "<events>...</events>");
+    EventWriter writer(out, EventWriter::Format::Cache);
+    writer.SetCacheLog(log);
+    const std::vector<uint32_t> first{1};
+    const std::vector<uint32_t> second{2};
+    writer.Write(store, first);
+    writer.Write(store, second);
+    writer.Finish();
+
+    const auto sidecar = db::EventCache::SidecarPath(log);
+    {
+      std::ofstream file(sidecar, std::ios::binary);
+      file << out.str();
+    }
+    db::EventStore image;
+    ASSERT_TRUE(db::EventCache::Open(image, log));
+    ASSERT_EQ(image.size(), 2);
+    EXPECT_EQ(image.at(0).getId(), 2);
+    EXPECT_EQ(image.at(0).findByKey("info"), "a, \"quoted\"\nline");
+    EXPECT_EQ(image.at(1).getEventItems()[2], db::EventView::Item("key", "y"));
+    image.clear();
+    std::filesystem::remove(sidecar);
+    std::filesystem::remove(log);
+  }
+
+  TEST_F(EventWriterTest, CacheNeedsItsLog)
+  {
+    EventWriter writer(out, EventWriter::Format::Cache);
+    EXPECT_THROW(writer.Finish(), std::logic_error);
+  }
+}
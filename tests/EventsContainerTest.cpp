@@ -16,3 +16,101 @@ TEST(EventsContainerTest, GetEvent)
     container.AddEvent({2, {{"key3", "value3"}, {"key4", "value4"}}});
     ASSERT_EQ(container.GetEvent(1), db::Event(2, {{"key3", "value3"}, {"key4", "value4"}}));
 }
+
+TEST(EventsContainerTest, AddEvents)
+{
+    db::EventsContainer container;
+    std::vector<db::Event> batch;
+    batch.emplace_back(1, db::Event::EventItems{{"key1", "value1"}});
+    batch.emplace_back(2, db::Event::EventItems{{"key2", "value2"}});
+    container.AddEvents(std::move(batch));
+    ASSERT_EQ(container.Size(), 2);
+    ASSERT_EQ(container.GetEvent(1), db::Event(2, {{"key2", "value2"}}));
+}
+
+namespace
+{
+    // builds "info" = "event <i>" and counts how often it is asked to
+    class CountingSource : public db::EventSource
+    {
+    public:
+        explicit CountingSource(std::size_t size, std::size_t &loads) : m_size(size), m_loads(loads) {}
+
+        std::size_t Size() const override { return m_size; }
+
+        db::Event Load(std::size_t index) const override
+        {
+            ++m_loads;
+            db::Event::EventItems items{{"info", "event " + std::to_string(index)}};
+            if (index % 1000 == 999)
+                items.emplace_back("rare", "yes");
+            return db::Event(static_cast<int>(index), std::move(items));
+        }
+
+    private:
+        std::size_t m_size;
+        std::size_t &m_loads;
+    };
+}
+
+TEST(EventsContainerTest, LazyEventsAreLoadedWhenAskedFor)
+{
+    std::size_t loads = 0;
+    db::EventsContainer container;
+    container.OpenLazy(std::make_unique<CountingSource>(1000000, loads));
+
+    ASSERT_TRUE(container.IsLazy());
+    ASSERT_EQ(container.Size(), 1000000);
+    // only the first page, for the fields of the columns
+    EXPECT_EQ(loads, db::EventsContainer::kLazyPageSize);
+
+    EXPECT_EQ(container.GetEvent(999999).findByKey("info"), "event 999999");
+    EXPECT_EQ(container.GetEvent(999999).getId(), 999999);
+    EXPECT_EQ(container.GetEvent(0).findByKey("info"), "event 0");
+    EXPECT_LE(loads, 2 * db::EventsContainer::kLazyPageSize);
+    EXPECT_THROW(container.GetEvent(1000000), std::out_of_range);
+}
+
+TEST(EventsContainerTest, LazyEventsShareFieldIds)
+{
+    std::size_t loads = 0;
+    db::EventsContainer container;
+    container.OpenLazy(std::make_unique<CountingSource>(10000, loads));
+
+    container.Prefetch(9990, 10000);
+    auto rare = container.GetStore().GetFields().Find("rare");
+    ASSERT_TRUE(rare.has_value());
+    EXPECT_EQ(container.GetEvent(9999).findByKey(*rare), "yes");
+    EXPECT_EQ(container.GetEvent(999).findByKey(*rare), "yes");
+    EXPECT_EQ(container.GetEvent(998).findByKey(*rare), "");
+}
+
+TEST(EventsContainerTest, LazyViewOutlivesItsPage)
+{
+    std::size_t loads = 0;
+    db::EventsContainer container;
+    container.OpenLazy(std::make_unique<CountingSource>(1000000, loads));
+
+    auto view = container.GetEvent(500000);
+    // push the page of the view out of the cache
+    for (std::size_t page = 0; page <= db::EventsContainer::kLazyPages; ++page)
+        container.GetEvent(static_cast<int>(page * db::EventsContainer::kLazyPageSize));
+
+    EXPECT_EQ(view.findByKey("info"), "event 500000");
+    const auto before = loads;
+    container.GetEvent(500001);
+    EXPECT_EQ(loads, before + db::EventsContainer::kLazyPageSize);
+}
+
+TEST(EventsContainerTest, ClearLeavesLazyMode)
+{
+    std::size_t loads = 0;
+    db::EventsContainer container;
+    container.OpenLazy(std::make_unique<CountingSource>(100, loads));
+    container.Clear();
+
+    EXPECT_FALSE(container.IsLazy());
+    EXPECT_EQ(container.Size(), 0);
+    container.AddEvent(db::Event(1, {{"info", "stored"}}));
+    EXPECT_EQ(container.GetEvent(0).findByKey("info"), "stored");
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include "src/application/db/field_dictionary.hpp"
+
+TEST(FieldDictionaryTest, InternsNamesOnce)
+{
+  db::FieldDictionary fields;
+  auto timestamp = fields.Intern("timestamp");
+  auto type = fields.Intern("type");
+
+  EXPECT_NE(timestamp, type);
+  EXPECT_EQ(fields.Intern(std::string("timestamp")), timestamp);
+  EXPECT_EQ(fields.Size(), 2);
+  EXPECT_EQ(fields.Name(type), "type");
+}
+
+TEST(FieldDictionaryTest, FindDoesNotIntern)
+{
+  db::FieldDictionary fields;
+  auto info = fields.Intern("info");
+
+  EXPECT_EQ(fields.Find("info"), info);
+  EXPECT_FALSE(fields.Find("missing").has_value());
+  EXPECT_EQ(fields.Size(), 1);
+}
+
+TEST(FieldDictionaryTest, NamesSurviveGrowth)
+{
+  db::FieldDictionary fields;
+  auto first = fields.Intern("first");
+  auto name = fields.Name(first);
+  for (int i = 0; i < 10000; ++i)
+    fields.Intern("field" + std::to_string(i));
+
+  EXPECT_EQ(fields.Name(first).data(), name.data());
+  EXPECT_EQ(fields.Find("field9999"), 10000);
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "src/application/util/file_watcher.hpp"
+#include "tests/test_logs.hpp"
+
+TEST(FileWatcherTest, WakesUpOnWrites)
+{
+  auto path = tests::TempPath("watched.log");
+  std::ofstream(path) << "first\n";
+  util::FileWatcher watcher(path);
+
+  std::ofstream(path, std::ios::app) << "second\n";
+  EXPECT_TRUE(watcher.Wait(std::chrono::seconds(5)));
+#if defined(__linux__) || defined(__APPLE__)
+  // an idle file times out instead of waking the caller up
+  EXPECT_FALSE(watcher.Wait(std::chrono::milliseconds(20)));
+#endif
+  std::filesystem::remove(path);
+}
+
+TEST(FileWatcherTest, NoticesReplacedPath)
+{
+  auto path = tests::TempPath("watched.log");
+  auto moved = tests::TempPath("watched.log.1");
+  std::ofstream(path) << "first\n";
+  util::FileWatcher watcher(path);
+  EXPECT_FALSE(watcher.IsReplaced());
+
+  std::filesystem::rename(path, moved);
+  EXPECT_TRUE(watcher.Wait(std::chrono::seconds(5)));
+  EXPECT_TRUE(watcher.IsReplaced());
+  std::ofstream(path) << "second\n";
+  EXPECT_TRUE(watcher.IsReplaced());
+  std::filesystem::remove(path);
+  std::filesystem::remove(moved);
+}
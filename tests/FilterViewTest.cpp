@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "src/application/search/filter_view.hpp"
+
+namespace
+{
+  const char *level(int i)
+  {
+    return i % 10 == 0 ? "ERROR" : (i % 10 == 1 ? "WARN" : "INFO");
+  }
+
+  void fill(db::EventStore &store, int first, int last)
+  {
+    for (int i = first; i < last; ++i)
+    {
+      char timestamp[32];
+      std::snprintf(timestamp, sizeof(timestamp), "2024-01-01 %02d:%02d:%02d", i / 3600 % 24, i / 60 % 60, i % 60);
+      store.push_back(db::Event(i, {{"timestamp", timestamp}, {"type", level(i)}, {"info", "message " + std::to_string(i)}}));
+    }
+  }
+
+  std::vector<uint32_t> expected(int count)
+  {
+    std::vector<uint32_t> rows;
+    for (int i = 0; i < count; ++i)
+      if ((i % 10 == 0 || i % 10 == 1) && i >= 3600 && i < 7200)
+        rows.push_back(i);
+    return rows;
+  }
+
+  const auto kFilter = "type=ERROR,WARN timestamp>=\"2024-01-01 01:00:00\" timestamp<\"2024-01-01 02:00:00\"";
+}
+
+TEST(FilterViewTest, FiltersInParallel)
+{
+  db::EventStore store;
+  fill(store, 0, 50000);
+  util::ThreadPool pool(4);
+  search::FilterView view(store, pool);
+
+  view.Apply(search::EventFilter::Parse(kFilter));
+  EXPECT_TRUE(view.IsActive());
+  EXPECT_EQ(view.GetRows(), expected(50000));
+  EXPECT_EQ(view.Row(0), 3600);
+  EXPECT_EQ(view.Position(3601), 1);
+  EXPECT_FALSE(view.Position(3602).has_value());
+}
+
+TEST(FilterViewTest, EvaluatesOnlyAppendedRows)
+{
+  db::EventStore store;
+  fill(store, 0, 4000);
+  search::FilterView view(store);
+  view.Apply(search::EventFilter::Parse(kFilter));
+  const auto before = view.Size();
+
+  fill(store, 4000, 8000);
+  view.Append(8000);
+  EXPECT_GT(view.Size(), before);
+  EXPECT_EQ(view.GetRows(), expected(8000));
+
+  // a repeated notification does not add rows twice
+  view.Append(8000);
+  EXPECT_EQ(view.GetRows(), expected(8000));
+}
+
+TEST(FilterViewTest, FindsFieldsFirstSeenInAppendedRows)
+{
+  db::EventStore store;
+  store.push_back(db::Event(0, {{"info", "a"}}));
+  search::FilterView view(store);
+  view.Apply(search::EventFilter::Parse("code=42"));
+  EXPECT_EQ(view.Size(), 0);
+
+  store.push_back(db::Event(1, {{"info", "b"}, {"code", "42"}}));
+  view.Append(2);
+  ASSERT_EQ(view.Size(), 1);
+  EXPECT_EQ(view.Row(0), 1);
+}
+
+TEST(FilterViewTest, ClearAndReapply)
+{
+  db::EventStore store;
+  fill(store, 0, 100);
+  search::FilterView view(store);
+  view.Apply(search::EventFilter::Parse("type=ERROR"));
+  EXPECT_EQ(view.Size(), 10);
+
+  store.clear();
+  fill(store, 0, 20);
+  view.Reapply();
+  EXPECT_EQ(view.Size(), 2);
+
+  view.Clear();
+  EXPECT_FALSE(view.IsActive());
+  EXPECT_EQ(view.Size(), 0);
+}
+
+TEST(FilterViewTest, ComparesTimesNotStrings)
+{
+  db::EventStore store;
+  store.push_back(db::Event(0, {{"timestamp", "2024-01-01T10:00:00+02:00"}}));
+  store.push_back(db::Event(1, {{"timestamp", "2024-01-01 09:00:00"}}));
+  store.push_back(db::Event(2, {{"timestamp", "not a time"}}));
+  store.push_back(db::Event(3, {{"type", "INFO"}}));
+  store.push_back(db::Event(4, {{"timestamp", "2024-01-01 07:30:00Z"}, {"type", "INFO"}}));
+
+  search::FilterView view(store);
+  // 10:00 at +02:00 is 08:00 UTC
+  view.Apply(search::EventFilter::Parse("timestamp>=\"2024-01-01 08:00\" timestamp<=\"2024-01-01 09:00\""));
+  EXPECT_EQ(view.GetRows(), std::vector<uint32_t>({0, 1}));
+
+  view.Apply(search::EventFilter::Parse("timestamp<2024-01-01T08:00:00 type=INFO"));
+  EXPECT_EQ(view.GetRows(), std::vector<uint32_t>({4}));
+
+  // a bound that is no timestamp compares strings as before
+  view.Apply(search::EventFilter::Parse("timestamp>m"));
+  EXPECT_EQ(view.GetRows(), std::vector<uint32_t>({2}));
+}
@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "src/application/db/events_container.hpp"
+#include "src/application/parser/data_parser.hpp"
+#include "src/application/parser/xml_scanner.hpp"
+
+// Counts the allocations of this test binary while a test asks for it.
+namespace
+{
+  std::atomic<bool> counting{false};
+  std::atomic<std::size_t> allocations{0};
+
+  void *allocate(std::size_t size)
+  {
+    if (counting.load(std::memory_order_relaxed))
+      allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+      return memory;
+    throw std::bad_alloc();
+  }
+
+  // allocations made by `run`
+  template <typename F>
+  std::size_t countAllocations(F &&run)
+  {
+    allocations = 0;
+    counting = true;
+    run();
+    counting = false;
+    return allocations;
+  }
+
+  db::Event::EventItems makeItems(int i)
+  {
+    // every value is its own allocation and too long to be shared by the store
+    const std::string padding(70, 'x');
+    return {{"timestamp", "2024-01-01 00:00:00." + std::to_string(i) + padding},
+            {"type", "information" + padding},
+            {"info", "message number " + std::to_string(i) + padding}};
+  }
+
+  class KeepingObserver : public parser::DataParserObserver
+  {
+  public:
+    void ProgressUpdated() const override {}
+    void NewEventFound(db::Event &&event) override
+    {
+      events.push_back(std::move(event));
+    }
+
+    std::vector<db::Event> events;
+  };
+
+  class EmittingParser : public parser::DataParser
+  {
+  public:
+    void ParseData(std::istream &) override {}
+    uint64_t GetCurrentProgress() const override { return 0; }
+    uint64_t GetTotalProgress() const override { return 0; }
+    db::Event &GetEvent() const override { throw std::logic_error("not used"); }
+  };
+} // namespace
+
+void *operator new(std::size_t size)
+{
+  return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+  return allocate(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+  std::free(memory);
+}
+
+TEST(IngestionAllocationTest, EventPacksItsItemsIntoOneBuffer)
+{
+  const auto items = makeItems(1);
+  const std::string type = "information" + std::string(70, 'x');
+
+  auto count = countAllocations([&]
+                                { db::Event event(1, items);
+                                  EXPECT_EQ(event.findByKey("type"), type);
+                                  EXPECT_EQ(event.getEventItems().size(), 3); });
+  EXPECT_EQ(count, 1);
+}
+
+TEST(IngestionAllocationTest, ShortEventsKeepTheirItemsInline)
+{
+  const std::string element = "<event id=\"7\"><timestamp>2024-01-01 00:00:00</timestamp><type>INFO</type><info>started</info></event>";
+  parser::XmlEventScanner scanner;
+
+  auto count = countAllocations([&]
+                                { db::Event event(1);
+                                  scanner.ParseEvent(element, event);
+                                  db::Event moved(std::move(event));
+                                  EXPECT_EQ(moved.getEventItems().size(), 4);
+                                  EXPECT_EQ(moved.findByKey("info"), "started"); });
+  EXPECT_EQ(count, 0);
+}
+
+TEST(IngestionAllocationTest, ScannerTakesValuesFromTheElement)
+{
+  const std::string padding(70, 'x');
+  const std::string element = "<event id=\"7\"><timestamp>2024-01-01 00:00:00</timestamp><type>INFO</type><info> message " +
+                              padding + " </info></event>";
+  const std::string info = "message " + padding;
+  parser::XmlEventScanner scanner;
+
+  // the buffer of the event, nothing per item
+  auto count = countAllocations([&]
+                                { db::Event event(1);
+                                  scanner.ParseEvent(element, event);
+                                  EXPECT_EQ(event.getEventItems().size(), 4);
+                                  EXPECT_EQ(event.findByKey("info"), info); });
+  EXPECT_EQ(count, 1);
+}
+
+TEST(IngestionAllocationTest, NotificationMovesIntoSingleObserver)
+{
+  EmittingParser parser;
+  KeepingObserver observer;
+  observer.events.reserve(1);
+  parser.RegisterObserver(&observer);
+  db::Event event(1, makeItems(1));
+
+  auto count = countAllocations([&]
+                                { parser.NewEventNotification(std::move(event)); });
+  EXPECT_EQ(count, 0);
+  ASSERT_EQ(observer.events.size(), 1);
+  EXPECT_EQ(observer.events[0].getEventItems().size(), 3);
+}
+
+TEST(IngestionAllocationTest, EveryObserverGetsTheWholeEvent)
+{
+  EmittingParser parser;
+  KeepingObserver first, second;
+  parser.RegisterObserver(&first);
+  parser.RegisterObserver(&second);
+
+  parser.NewEventNotification(db::Event(1, makeItems(1)));
+
+  ASSERT_EQ(first.events.size(), 1);
+  ASSERT_EQ(second.events.size(), 1);
+  EXPECT_EQ(first.events[0].getEventItems(), second.events[0].getEventItems());
+  EXPECT_EQ(first.events[0].getEventItems().size(), 3);
+}
+
+TEST(IngestionAllocationTest, ModelMovesItems)
+{
+  mvc::Model<std::vector<db::Event>> model;
+  std::vector<db::Event> batch;
+  for (int i = 0; i < 100; ++i)
+    batch.emplace_back(i, makeItems(i));
+  db::Event last(100, makeItems(100));
+
+  // only the model's own vector grows to 128 slots, no event is copied
+  auto count = countAllocations([&]
+                                { model.AddItems(std::move(batch));
+                                  model.AddItem(std::move(last)); });
+  EXPECT_LE(count, 8);
+  EXPECT_EQ(model.Size(), 101);
+}
+
+TEST(IngestionAllocationTest, ContainerStoresWithoutCopyingEvents)
+{
+  db::EventsContainer container;
+  for (int i = 0; i < 1000; ++i)
+    container.AddEvent(db::Event(i, makeItems(i)));
+
+  std::vector<db::Event> batch;
+  for (int i = 1000; i < 2000; ++i)
+    batch.emplace_back(i, makeItems(i));
+
+  // copying the events would take at least 4 allocations each, storing
+  // them only grows the columns now and then
+  auto count = countAllocations([&]
+                                { container.AddEvents(std::move(batch)); });
+  EXPECT_LT(count, 100);
+  EXPECT_EQ(container.Size(), 2000);
+  EXPECT_EQ(container.GetEvent(1999).findByKey("info"), "message number 1999" + std::string(70, 'x'));
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/application/util/lru_cache.hpp"
+
+TEST(LruCacheTest, FindsWhatWasPut)
+{
+  util::LruCache<int, std::string> cache(4);
+  cache.Put(1, "one");
+  cache.Put(2, "two");
+
+  ASSERT_NE(cache.Find(1), nullptr);
+  EXPECT_EQ(*cache.Find(1), "one");
+  EXPECT_EQ(cache.Find(3), nullptr);
+  EXPECT_EQ(cache.Size(), 2);
+}
+
+TEST(LruCacheTest, DropsLeastRecentlyUsed)
+{
+  util::LruCache<int, int> cache(3);
+  cache.Put(1, 10);
+  cache.Put(2, 20);
+  cache.Put(3, 30);
+
+  // 1 becomes the most recent, 2 is the oldest now
+  cache.Find(1);
+  cache.Put(4, 40);
+
+  EXPECT_TRUE(cache.Contains(1));
+  EXPECT_FALSE(cache.Contains(2));
+  EXPECT_TRUE(cache.Contains(3));
+  EXPECT_TRUE(cache.Contains(4));
+  EXPECT_EQ(cache.Size(), 3);
+}
+
+TEST(LruCacheTest, PutReplacesValue)
+{
+  util::LruCache<int, int> cache(2);
+  cache.Put(1, 10);
+  EXPECT_EQ(cache.Put(1, 11), 11);
+
+  EXPECT_EQ(*cache.Find(1), 11);
+  EXPECT_EQ(cache.Size(), 1);
+}
+
+TEST(LruCacheTest, ClearEmpties)
+{
+  util::LruCache<int, int> cache(2);
+  cache.Put(1, 10);
+  cache.Clear();
+
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_EQ(cache.Find(1), nullptr);
+  cache.Put(2, 20);
+  EXPECT_EQ(*cache.Find(2), 20);
+}
+
+TEST(LruCacheTest, StaysBounded)
+{
+  util::LruCache<int, int> cache(100);
+  for (int i = 0; i < 10000; ++i)
+    cache.Put(i, i);
+
+  EXPECT_EQ(cache.Size(), 100);
+  EXPECT_TRUE(cache.Contains(9999));
+  EXPECT_FALSE(cache.Contains(9899));
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <regex>
+
+#include "src/application/db/event_store.hpp"
+#include "src/application/search/matcher.hpp"
+
+using search::Matcher;
+using search::SearchOptions;
+
+TEST(MatcherTest, PlainTextIsLiteral)
+{
+  Matcher matcher("timeout");
+
+  EXPECT_EQ(matcher.GetKind(), Matcher::Kind::Literal);
+  EXPECT_TRUE(matcher.Matches("connection timeout after 5s"));
+  EXPECT_TRUE(matcher.Matches("timeout"));
+  EXPECT_FALSE(matcher.Matches("timeou"));
+  EXPECT_FALSE(matcher.Matches("Timeout"));
+}
+
+TEST(MatcherTest, RegexLookalikesAreReducedToLiterals)
+{
+  Matcher escaped("1\\.2\\.3");
+  EXPECT_EQ(escaped.GetKind(), Matcher::Kind::Literal);
+  EXPECT_EQ(escaped.GetLiteral(), "1.2.3");
+  EXPECT_TRUE(escaped.Matches("version 1.2.3"));
+  EXPECT_FALSE(escaped.Matches("version 1x2x3"));
+
+  Matcher wildcard("another.*");
+  EXPECT_EQ(wildcard.GetKind(), Matcher::Kind::Literal);
+  EXPECT_TRUE(wildcard.Matches("anotherValue"));
+}
+
+TEST(MatcherTest, RegexSyntaxIsRegex)
+{
+  Matcher matcher("value[0-9]");
+
+  EXPECT_EQ(matcher.GetKind(), Matcher::Kind::Regex);
+  EXPECT_TRUE(matcher.Matches("value1"));
+  EXPECT_FALSE(matcher.Matches("valueX"));
+  EXPECT_EQ(Matcher("\\d+").GetKind(), Matcher::Kind::Regex);
+}
+
+TEST(MatcherTest, LiteralModeDoesNotInterpret)
+{
+  Matcher matcher("a.b", {SearchOptions::Mode::Literal});
+
+  EXPECT_EQ(matcher.GetKind(), Matcher::Kind::Literal);
+  EXPECT_TRUE(matcher.Matches("xa.by"));
+  EXPECT_FALSE(matcher.Matches("axb"));
+}
+
+TEST(MatcherTest, RegexModeAlwaysCompiles)
+{
+  Matcher matcher("abc", {SearchOptions::Mode::Regex});
+
+  EXPECT_EQ(matcher.GetKind(), Matcher::Kind::Regex);
+  EXPECT_TRUE(matcher.Matches("xabc"));
+  EXPECT_THROW(Matcher("[", {SearchOptions::Mode::Regex}), std::regex_error);
+}
+
+TEST(MatcherTest, CaseInsensitive)
+{
+  Matcher literal("ErRor", {SearchOptions::Mode::Auto, false});
+  EXPECT_EQ(literal.GetKind(), Matcher::Kind::CaseInsensitiveLiteral);
+  EXPECT_TRUE(literal.Matches("fatal ERROR"));
+  EXPECT_TRUE(literal.Matches("error"));
+  EXPECT_FALSE(literal.Matches("err or"));
+
+  // nothing to fold
+  EXPECT_EQ(Matcher("404", {SearchOptions::Mode::Auto, false}).GetKind(), Matcher::Kind::Literal);
+
+  Matcher regex("warn(ing)?", {SearchOptions::Mode::Auto, false});
+  EXPECT_EQ(regex.GetKind(), Matcher::Kind::Regex);
+  EXPECT_TRUE(regex.Matches("WARNING"));
+}
+
+TEST(MatcherTest, EmptyPatternMatchesEverything)
+{
+  Matcher matcher("");
+
+  EXPECT_TRUE(matcher.Matches(""));
+  EXPECT_TRUE(matcher.Matches("anything"));
+}
+
+TEST(MatcherTest, LiteralsAgreeWithRegex)
+{
+  std::mt19937 random(7);
+  auto text = [&random](std::size_t length)
+  {
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i)
+      result.push_back("abAB. "[random() % 6]);
+    return result;
+  };
+
+  for (int round = 0; round < 2000; ++round)
+  {
+    const std::string needle = text(1 + random() % 4);
+    const std::string haystack = text(random() % 24);
+    for (bool caseSensitive : {true, false})
+    {
+      Matcher matcher(needle, {SearchOptions::Mode::Literal, caseSensitive});
+      std::string escaped;
+      for (char c : needle)
+        escaped += c == '.' ? std::string("\\.") : std::string(1, c);
+      auto flags = caseSensitive ? std::regex::ECMAScript : std::regex::ECMAScript | std::regex::icase;
+
+      EXPECT_EQ(matcher.Matches(haystack), std::regex_search(haystack, std::regex(escaped, flags)))
+          << "needle '" << needle << "' text '" << haystack << "' case " << caseSensitive;
+    }
+  }
+}
+
+TEST(MatcherTest, CachedReusesCompiledPattern)
+{
+  const Matcher &first = Matcher::Cached("value[0-9]");
+  const Matcher &second = Matcher::Cached("value[0-9]");
+
+  EXPECT_EQ(&first, &second);
+  EXPECT_NE(&Matcher::Cached("value[0-9]", {SearchOptions::Mode::Auto, false}), &first);
+  EXPECT_THROW(Matcher::Cached("("), std::regex_error);
+}
+
+TEST(MatcherTest, FindInEventView)
+{
+  db::EventStore store;
+  store.push_back(db::Event(1, {{"type", "info"}, {"info", "disk full"}}));
+
+  Matcher matcher("full");
+  EXPECT_EQ(store.at(0).findInEvent(matcher), 1);
+  EXPECT_FALSE(store.at(0).findInEvent(Matcher("empty")).has_value());
+}
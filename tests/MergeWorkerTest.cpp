@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/application/db/timestamp.hpp"
+#include "src/application/parser/merge_worker.hpp"
+#include "src/application/parser/xml_parser.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  // events at first, first + step, ... seconds
+  std::filesystem::path writeLog(const std::string &name, int first, int step, int count)
+  {
+    auto event = [&](int i)
+    {
+      return "<timestamp>" + tests::Timestamp(first + i * step) + "</timestamp><info>" + name + std::to_string(i) + "</info>";
+    };
+    return tests::WriteLog(name + ".xml", tests::EventsLog(0, count, event));
+  }
+
+  std::vector<std::unique_ptr<parser::DataParser>> parsers(std::size_t count)
+  {
+    std::vector<std::unique_ptr<parser::DataParser>> result;
+    for (std::size_t i = 0; i < count; ++i)
+      result.push_back(std::make_unique<parser::XmlParser>());
+    return result;
+  }
+
+  std::vector<db::Event> drain(parser::MergeWorker &worker)
+  {
+    std::vector<db::Event> events;
+    parser::BatchProducer::Batch batch;
+    while (!worker.IsFinished())
+    {
+      if (!worker.TryPopBatch(batch))
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      std::ranges::move(batch, std::back_inserter(events));
+    }
+    return events;
+  }
+
+  db::Timestamp timeOf(const db::Event &event)
+  {
+    return db::ParseTimestamp(event.findByKey("timestamp")).value_or(INT64_MIN);
+  }
+} // namespace
+
+TEST(MergeWorkerTest, MergesLogsByTimestamp)
+{
+  // interleaved logs of different pace and length
+  std::vector<std::filesystem::path> files{writeLog("a", 0, 3, 3000), writeLog("b", 1, 3, 2000), writeLog("c", 2, 7, 500)};
+  std::atomic<bool> stop{false};
+  parser::MergeWorker worker(parsers(files.size()), stop, 64, 4);
+
+  worker.Start(files);
+  auto events = drain(worker);
+  worker.Join();
+  for (const auto &file : files)
+    std::filesystem::remove(file);
+
+  ASSERT_EQ(events.size(), 5500);
+  std::vector<int> perSource(3);
+  for (std::size_t i = 0; i < events.size(); ++i)
+  {
+    if (i > 0)
+    {
+      ASSERT_LE(timeOf(events[i - 1]), timeOf(events[i])) << i;
+    }
+    const auto source = events[i].getSource();
+    ASSERT_LT(source, 3);
+    // every log keeps its own order
+    EXPECT_EQ(events[i].getId(), perSource[source]++);
+  }
+  EXPECT_EQ(perSource, std::vector<int>({3000, 2000, 500}));
+  EXPECT_TRUE(worker.GetError().empty());
+  EXPECT_EQ(worker.GetCurrentProgress(), worker.GetTotalProgress());
+}
+
+TEST(MergeWorkerTest, TiesKeepTheOrderOfTheLogs)
+{
+  std::vector<std::filesystem::path> files{writeLog("x", 5, 0, 2), writeLog("y", 5, 0, 2)};
+  std::atomic<bool> stop{false};
+  parser::MergeWorker worker(parsers(files.size()), stop);
+
+  worker.Start(files);
+  auto events = drain(worker);
+  worker.Join();
+  for (const auto &file : files)
+    std::filesystem::remove(file);
+
+  ASSERT_EQ(events.size(), 4);
+  EXPECT_EQ(events[0].getSource(), 0);
+  EXPECT_EQ(events[1].getSource(), 0);
+  EXPECT_EQ(events[2].getSource(), 1);
+  EXPECT_EQ(events[3].getSource(), 1);
+}
+
+TEST(MergeWorkerTest, KeepsMergingWhenALogFails)
+{
+  std::vector<std::filesystem::path> files{writeLog("ok", 0, 1, 100),
+                                           tests::TempPath("missing.xml")};
+  std::atomic<bool> stop{false};
+  parser::MergeWorker worker(parsers(files.size()), stop);
+
+  worker.Start(files);
+  auto events = drain(worker);
+  worker.Join();
+  std::filesystem::remove(files[0]);
+
+  EXPECT_EQ(events.size(), 100);
+  EXPECT_NE(worker.GetError().find("missing.xml"), std::string::npos);
+}
+
+TEST(MergeWorkerTest, StopsWhenRequested)
+{
+  std::vector<std::filesystem::path> files{writeLog("s", 0, 1, 50000), writeLog("t", 0, 1, 50000)};
+  std::atomic<bool> stop{false};
+  parser::MergeWorker worker(parsers(files.size()), stop, 64, 2);
+
+  worker.Start(files);
+  // nobody consumes, the queues fill up and the workers wait
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  stop = true;
+  worker.Join();
+  for (const auto &file : files)
+    std::filesystem::remove(file);
+
+  std::size_t events = 0;
+  parser::BatchProducer::Batch batch;
+  while (worker.TryPopBatch(batch))
+    events += batch.size();
+  EXPECT_TRUE(worker.IsFinished());
+  EXPECT_LT(events, 100000);
+}
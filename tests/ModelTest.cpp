@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+
+#include <chrono>
+#include <vector>
+
 #include "src/application/mvc/model.hpp"
 #include "src/application/mvc/view.hpp"
 
@@ -46,3 +50,163 @@ TEST_F(ModelTest, GetCurrentItemIndexTest)
   model.SetCurrentItem(0);
   EXPECT_EQ(model.GetCurrentItemIndex(), 0);
 }
+
+class MockRangeView : public mvc::View
+{
+public:
+  MOCK_METHOD(void, OnDataUpdated, (), (override));
+  MOCK_METHOD(void, OnCurrentIndexUpdated, (const int index), (override));
+  MOCK_METHOD(void, OnDataAppended, (const std::size_t first, const std::size_t last), (override));
+};
+
+class ModelUpdateTest : public ::testing::Test
+{
+protected:
+  mvc::Model<std::vector<int>> model;
+  testing::StrictMock<MockRangeView> mockView;
+
+  void SetUp() override
+  {
+    model.RegisterOndDataUpdated(&mockView);
+  }
+};
+
+TEST_F(ModelUpdateTest, AddItemReportsAppendedRange)
+{
+  EXPECT_CALL(mockView, OnDataAppended(0, 1)).Times(1);
+  model.AddItem(42);
+}
+
+TEST_F(ModelUpdateTest, AddItemsNotifiesOnce)
+{
+  EXPECT_CALL(mockView, OnDataAppended(0, 1)).Times(1);
+  EXPECT_CALL(mockView, OnDataAppended(1, 4)).Times(1);
+  model.AddItem(1);
+  model.AddItems(std::vector<int>{2, 3, 4});
+  EXPECT_EQ(model.Size(), 4);
+  EXPECT_EQ(model.GetItem(3), 4);
+}
+
+TEST_F(ModelUpdateTest, AddItemsWithEmptyRangeDoesNotNotify)
+{
+  model.AddItems(std::vector<int>{});
+  EXPECT_EQ(model.Size(), 0);
+}
+
+TEST_F(ModelUpdateTest, UpdateMergesAppends)
+{
+  EXPECT_CALL(mockView, OnDataAppended(0, 5)).Times(1);
+  model.BeginUpdate();
+  model.AddItem(1);
+  model.AddItem(2);
+  model.AddItems(std::vector<int>{3, 4, 5});
+  model.EndUpdate();
+}
+
+TEST_F(ModelUpdateTest, NestedUpdatesNotifyOnOutermostEnd)
+{
+  model.BeginUpdate();
+  model.BeginUpdate();
+  model.AddItem(1);
+  model.EndUpdate();
+  testing::Mock::VerifyAndClearExpectations(&mockView);
+
+  EXPECT_CALL(mockView, OnDataAppended(0, 2)).Times(1);
+  model.AddItem(2);
+  model.EndUpdate();
+}
+
+TEST_F(ModelUpdateTest, DataChangedInsideUpdateWins)
+{
+  EXPECT_CALL(mockView, OnDataUpdated()).Times(1);
+  model.BeginUpdate();
+  model.AddItem(1);
+  model.Clear();
+  model.AddItem(2);
+  model.EndUpdate();
+  EXPECT_EQ(model.Size(), 1);
+}
+
+TEST_F(ModelUpdateTest, DeferredNotificationsWaitForFlush)
+{
+  const auto start = mvc::Model<std::vector<int>>::Clock::time_point();
+  model.DeferNotifications(std::chrono::milliseconds(16));
+  model.AddItem(1);
+  model.AddItems(std::vector<int>{2, 3});
+  model.SetCurrentItem(0);
+  model.SetCurrentItem(2);
+  EXPECT_TRUE(model.HasPending());
+  testing::Mock::VerifyAndClearExpectations(&mockView);
+
+  {
+    testing::InSequence order;
+    EXPECT_CALL(mockView, OnDataAppended(0, 3)).Times(1);
+    EXPECT_CALL(mockView, OnCurrentIndexUpdated(2)).Times(1);
+  }
+  EXPECT_TRUE(model.Flush(start));
+  EXPECT_FALSE(model.HasPending());
+  EXPECT_FALSE(model.Flush(start + std::chrono::milliseconds(1)));
+}
+
+TEST_F(ModelUpdateTest, FlushIsRateLimited)
+{
+  const auto start = mvc::Model<std::vector<int>>::Clock::time_point();
+  model.DeferNotifications(std::chrono::milliseconds(16));
+  EXPECT_CALL(mockView, OnDataAppended(0, 1)).Times(1);
+  model.AddItem(1);
+  EXPECT_TRUE(model.Flush(start));
+  testing::Mock::VerifyAndClearExpectations(&mockView);
+
+  model.AddItem(2);
+  EXPECT_FALSE(model.Flush(start + std::chrono::milliseconds(10)));
+  testing::Mock::VerifyAndClearExpectations(&mockView);
+
+  EXPECT_CALL(mockView, OnDataAppended(1, 2)).Times(1);
+  EXPECT_TRUE(model.Flush(start + std::chrono::milliseconds(16)));
+}
+
+TEST_F(ModelUpdateTest, DeferredDataChangeIsDeliveredAtOnce)
+{
+  model.DeferNotifications(std::chrono::milliseconds(16));
+  model.AddItem(1);
+  // the pending append is dropped, the change covers it
+  EXPECT_CALL(mockView, OnDataUpdated()).Times(1);
+  model.Clear();
+  EXPECT_FALSE(model.HasPending());
+}
+
+TEST_F(ModelUpdateTest, DeferredDataChangeIsDeliveredAfterUpdate)
+{
+  model.DeferNotifications(std::chrono::milliseconds(16));
+  model.BeginUpdate();
+  model.Clear();
+  model.AddItem(1);
+  testing::Mock::VerifyAndClearExpectations(&mockView);
+
+  EXPECT_CALL(mockView, OnDataUpdated()).Times(1);
+  model.EndUpdate();
+  EXPECT_FALSE(model.HasPending());
+  testing::Mock::VerifyAndClearExpectations(&mockView);
+
+  // appends alone still wait for Flush
+  model.BeginUpdate();
+  model.AddItem(2);
+  model.EndUpdate();
+  EXPECT_TRUE(model.HasPending());
+}
+
+TEST(ModelSubscriptionTest, ViewsOnlyHearTheChangesTheySubscribed)
+{
+  mvc::Model<std::vector<int>> model;
+  testing::StrictMock<MockRangeView> detail;
+  testing::StrictMock<MockRangeView> list;
+  model.RegisterOndDataUpdated(&detail, mvc::Change::Data | mvc::Change::CurrentIndex);
+  model.RegisterOndDataUpdated(&list, mvc::Change::Appended);
+
+  EXPECT_CALL(list, OnDataAppended(0, 1)).Times(1);
+  model.AddItem(1);
+  EXPECT_CALL(detail, OnCurrentIndexUpdated(0)).Times(1);
+  model.SetCurrentItem(0);
+  EXPECT_CALL(detail, OnDataUpdated()).Times(1);
+  model.Clear();
+}
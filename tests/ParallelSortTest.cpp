@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "src/application/util/parallel_sort.hpp"
+
+namespace
+{
+  std::vector<int> randomValues(std::size_t count)
+  {
+    std::vector<int> values(count);
+    std::mt19937 random(11);
+    for (auto &value : values)
+      value = static_cast<int>(random() % 100000);
+    return values;
+  }
+} // namespace
+
+TEST(ParallelSortTest, SortsLikeStdSort)
+{
+  // an odd number of runs leaves one run without a partner in a round
+  for (std::size_t threads : {2, 3, 5, 8})
+  {
+    util::ThreadPool pool(threads);
+    auto values = randomValues(300001);
+    auto expected = values;
+    std::ranges::sort(expected);
+
+    util::ParallelSort(values, std::less<>(), pool);
+    EXPECT_EQ(values, expected) << threads << " threads";
+  }
+}
+
+TEST(ParallelSortTest, UsesTheComparison)
+{
+  util::ThreadPool pool(4);
+  auto values = randomValues(200000);
+  util::ParallelSort(values, std::greater<>(), pool);
+  EXPECT_TRUE(std::ranges::is_sorted(values, std::greater<>()));
+}
+
+TEST(ParallelSortTest, SortsSmallInputs)
+{
+  std::vector<int> empty;
+  util::ParallelSort(empty);
+  EXPECT_TRUE(empty.empty());
+
+  std::vector<int> few{3, 1, 2};
+  util::ParallelSort(few);
+  EXPECT_EQ(few, std::vector<int>({1, 2, 3}));
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "src/application/parser/parallel_xml_parser.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  std::vector<db::Event> parse(parser::XmlParser &xmlParser, const std::filesystem::path &path)
+  {
+    tests::CollectingObserver observer;
+    xmlParser.RegisterObserver(&observer);
+    xmlParser.ParseData(path);
+    return std::move(observer.events);
+  }
+}
+
+TEST(ParallelXmlParserTest, MatchesSequentialParser)
+{
+  auto path = tests::WriteLog("log.xml", tests::TrickyLog(3000));
+
+  parser::XmlParser sequential;
+  auto expected = parse(sequential, path);
+
+  for (std::size_t chunkSize : {64, 257, 4096})
+  {
+    util::ThreadPool pool(4);
+    parser::ParallelXmlParser parallel("event", chunkSize, pool);
+    auto events = parse(parallel, path);
+
+    ASSERT_EQ(events.size(), expected.size()) << "chunk size " << chunkSize;
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+      ASSERT_EQ(events[i].getId(), static_cast<int>(i));
+      ASSERT_EQ(events[i].getEventItems(), expected[i].getEventItems()) << "event " << i;
+    }
+    EXPECT_EQ(parallel.GetCurrentProgress(), parallel.GetTotalProgress());
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(ParallelXmlParserTest, SmallFilesFallBackToSequentialParsing)
+{
+  auto path = tests::WriteLog("log.xml", "<events><event><info>a</info></event></events>");
+
+  util::ThreadPool pool(4);
+  parser::ParallelXmlParser parallel("event", 1 << 20, pool);
+  auto events = parse(parallel, path);
+  std::filesystem::remove(path);
+
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_EQ(events[0].findByKey("info"), "a");
+}
+
+TEST(ParallelXmlParserTest, StopsWhenRequested)
+{
+  auto path = tests::WriteLog("log.xml", tests::TrickyLog(3000));
+  std::atomic<bool> stop{true};
+
+  util::ThreadPool pool(4);
+  parser::ParallelXmlParser parallel("event", 256, pool);
+  parallel.SetStopToken(&stop);
+  auto events = parse(parallel, path);
+  std::filesystem::remove(path);
+
+  EXPECT_TRUE(events.empty());
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#include "src/application/parser/parser_worker.hpp"
+#include "src/application/parser/xml_parser.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  std::filesystem::path writeLog(int count)
+  {
+    auto event = [](int i)
+    {
+      return "<type>INFO</type><info>" + std::to_string(i) + "</info>";
+    };
+    return tests::WriteLog("log.xml", tests::EventsLog(0, count, event));
+  }
+
+  std::vector<db::Event> drain(parser::ParserWorker &worker)
+  {
+    std::vector<db::Event> events;
+    parser::ParserWorker::Batch batch;
+    while (!worker.IsFinished())
+    {
+      if (!worker.TryPopBatch(batch))
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      EXPECT_FALSE(batch.empty());
+      std::ranges::move(batch, std::back_inserter(events));
+    }
+    return events;
+  }
+}
+
+TEST(ParserWorkerTest, DeliversAllEventsInBatches)
+{
+  auto path = writeLog(10000);
+  std::atomic<bool> stop{false};
+  parser::ParserWorker worker(std::make_unique<parser::XmlParser>(), stop, 256, 4);
+
+  worker.Start(path);
+  auto events = drain(worker);
+  worker.Join();
+  std::filesystem::remove(path);
+
+  ASSERT_EQ(events.size(), 10000);
+  for (int i = 0; i < 10000; ++i)
+    ASSERT_EQ(events[i].getId(), i);
+  EXPECT_TRUE(worker.GetError().empty());
+  EXPECT_EQ(worker.GetCurrentProgress(), worker.GetTotalProgress());
+}
+
+TEST(ParserWorkerTest, StopsWhenRequested)
+{
+  auto path = writeLog(100000);
+  std::atomic<bool> stop{false};
+  parser::ParserWorker worker(std::make_unique<parser::XmlParser>(), stop, 16, 2);
+
+  // nobody drains the queue, so the worker blocks until it is told to stop
+  worker.Start(path);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  stop = true;
+  auto events = drain(worker);
+  worker.Join();
+  std::filesystem::remove(path);
+
+  EXPECT_LT(events.size(), 100000);
+  EXPECT_LT(worker.GetCurrentProgress(), worker.GetTotalProgress());
+}
+
+TEST(ParserWorkerTest, ReportsParserErrors)
+{
+  std::atomic<bool> stop{false};
+  parser::ParserWorker worker(std::make_unique<parser::XmlParser>(), stop);
+
+  worker.Start("/nonexistent/LogViewer.xml");
+  auto events = drain(worker);
+  worker.Join();
+
+  EXPECT_TRUE(events.empty());
+  EXPECT_FALSE(worker.GetError().empty());
+}
+
+TEST(ParserWorkerTest, BatchObserverSeesEveryEvent)
+{
+  auto path = writeLog(1000);
+  std::atomic<bool> stop{false};
+  parser::ParserWorker worker(std::make_unique<parser::XmlParser>(), stop, 64, 4);
+  std::size_t observed = 0;
+  worker.SetBatchObserver([&observed](const parser::ParserWorker::Batch &batch)
+                          { observed += batch.size(); });
+
+  worker.Start(path);
+  auto events = drain(worker);
+  worker.Join();
+  std::filesystem::remove(path);
+
+  EXPECT_EQ(observed, 1000);
+  ASSERT_EQ(events.size(), 1000);
+  // the observer only looks, the consumer still gets whole events
+  EXPECT_EQ(events.back().findByKey("info"), "999");
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include "src/application/util/profiler.hpp"
+
+namespace
+{
+  using namespace std::chrono_literals;
+
+  class ProfilerTest : public ::testing::Test
+  {
+  protected:
+    util::Profiler &profiler = util::Profiler::Instance();
+
+    void SetUp() override
+    {
+      profiler.StopTrace();
+      profiler.Reset();
+    }
+
+    void TearDown() override
+    {
+      profiler.StopTrace();
+      profiler.Reset();
+    }
+
+    const util::Profiler::Summary *find(const std::vector<util::Profiler::Summary> &summaries, const std::string &name)
+    {
+      for (const auto &summary : summaries)
+        if (summary.name == name)
+          return &summary;
+      return nullptr;
+    }
+  };
+} // namespace
+
+TEST_F(ProfilerTest, SitesAreFoundByName)
+{
+  auto &site = profiler.GetSite("ProfilerTest::site");
+  EXPECT_EQ(&profiler.GetSite("ProfilerTest::site"), &site);
+  EXPECT_EQ(site.Name(), "ProfilerTest::site");
+  // sites that never ran are left out
+  EXPECT_EQ(find(profiler.GetSummaries(), "ProfilerTest::site"), nullptr);
+}
+
+TEST_F(ProfilerTest, SummarizesLatencies)
+{
+  auto &site = profiler.GetSite("ProfilerTest::latency");
+  for (int i = 0; i < 98; ++i)
+    site.Record(1us);
+  site.Record(1ms);
+  site.Record(1ms);
+
+  const auto summaries = profiler.GetSummaries();
+  const auto *summary = find(summaries, "ProfilerTest::latency");
+  ASSERT_NE(summary, nullptr);
+  EXPECT_EQ(summary->count, 100);
+  EXPECT_EQ(summary->total, 98us + 2ms);
+  EXPECT_EQ(summary->max, 1ms);
+  // bucket bounds, within a power of two of the real value
+  EXPECT_GE(summary->p50, 1us);
+  EXPECT_LT(summary->p50, 2 * 1us + 1ns);
+  EXPECT_GE(summary->p99, 1ms);
+  EXPECT_LT(summary->p99, 2ms + 1ns);
+  EXPECT_NE(profiler.FormatSummary().find("ProfilerTest::latency 100x"), std::string::npos);
+
+  profiler.Reset();
+  EXPECT_EQ(find(profiler.GetSummaries(), "ProfilerTest::latency"), nullptr);
+}
+
+TEST_F(ProfilerTest, ScopesRecordFromEveryThread)
+{
+  auto &site = profiler.GetSite("ProfilerTest::scope");
+  auto work = [&site]
+  {
+    for (int i = 0; i < 1000; ++i)
+      util::ProfileScope scope(site);
+  };
+  std::thread first(work), second(work);
+  first.join();
+  second.join();
+
+  const auto summaries = profiler.GetSummaries();
+  const auto *summary = find(summaries, "ProfilerTest::scope");
+  ASSERT_NE(summary, nullptr);
+  EXPECT_EQ(summary->count, 2000);
+}
+
+TEST_F(ProfilerTest, ExportsChromeTrace)
+{
+  auto &site = profiler.GetSite("ProfilerTest::\"traced\"");
+  {
+    util::ProfileScope untraced(site);
+  }
+  profiler.StartTrace();
+  EXPECT_TRUE(profiler.IsTracing());
+  {
+    util::ProfileScope traced(site);
+    std::this_thread::sleep_for(1ms);
+  }
+  std::thread([&site]
+              { util::ProfileScope other(site); })
+      .join();
+  profiler.StopTrace();
+  {
+    util::ProfileScope afterwards(site);
+  }
+
+  std::ostringstream out;
+  profiler.WriteChromeTrace(out);
+  const auto trace = out.str();
+  EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+  EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+  std::size_t events = 0;
+  for (auto at = trace.find("\"ph\":\"X\""); at != std::string::npos; at = trace.find("\"ph\":\"X\"", at + 1))
+    ++events;
+  EXPECT_EQ(events, 2);
+  EXPECT_NE(trace.find("\"name\":\"ProfilerTest::\\\"traced\\\"\""), std::string::npos);
+}
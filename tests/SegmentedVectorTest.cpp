@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/application/util/segmented_vector.hpp"
+
+TEST(SegmentedVectorTest, SegmentsDoubleAndTile)
+{
+  EXPECT_EQ(util::segments::Index(0), 0);
+  EXPECT_EQ(util::segments::Index(util::segments::kFirst - 1), 0);
+  EXPECT_EQ(util::segments::Index(util::segments::kFirst), 1);
+  for (std::size_t segment = 0; segment < 20; ++segment)
+  {
+    const auto start = util::segments::Start(segment);
+    EXPECT_EQ(util::segments::Index(start), segment);
+    EXPECT_EQ(util::segments::Index(start + util::segments::Capacity(segment) - 1), segment);
+    EXPECT_EQ(util::segments::Start(segment + 1), start + util::segments::Capacity(segment));
+  }
+}
+
+TEST(SegmentedVectorTest, IndexesAcrossSegments)
+{
+  util::SegmentedVector<int> values;
+  EXPECT_TRUE(values.empty());
+  for (int i = 0; i < 10000; ++i)
+    values.push_back(i);
+
+  ASSERT_EQ(values.size(), 10000);
+  EXPECT_EQ(values.back(), 9999);
+  for (int i = 0; i < 10000; ++i)
+    ASSERT_EQ(values[i], i);
+  EXPECT_GE(values.capacity(), values.size());
+}
+
+TEST(SegmentedVectorTest, ElementsNeverMove)
+{
+  util::SegmentedVector<std::string> values;
+  values.push_back("first");
+  const std::string *first = &values[0];
+  const char *text = values[0].data();
+  for (int i = 0; i < 5000; ++i)
+    values.push_back(std::to_string(i));
+
+  EXPECT_EQ(&values[0], first);
+  EXPECT_EQ(values[0].data(), text);
+  EXPECT_EQ(values[0], "first");
+}
+
+TEST(SegmentedVectorTest, ResizeFillsNewSlots)
+{
+  util::SegmentedVector<int> values(3, 7);
+  values.resize(100);
+  values.resize(200, 5);
+  values.resize(10);
+
+  ASSERT_EQ(values.size(), 200);
+  EXPECT_EQ(values[2], 7);
+  EXPECT_EQ(values[3], 0);
+  EXPECT_EQ(values[99], 0);
+  EXPECT_EQ(values[100], 5);
+  EXPECT_EQ(values[199], 5);
+
+  values.clear();
+  EXPECT_TRUE(values.empty());
+  values.resize(50);
+  EXPECT_EQ(values[3], 0);
+}
+
+TEST(SegmentedVectorTest, RunsCoverTheRange)
+{
+  util::SegmentedVector<int> values;
+  for (int i = 0; i < 1000; ++i)
+    values.push_back(i);
+
+  std::vector<int> seen;
+  std::size_t next = 5;
+  values.ForEachRun(5, 2000, [&](std::span<const int> run, std::size_t first)
+                    {
+                      EXPECT_EQ(first, next);
+                      next += run.size();
+                      seen.insert(seen.end(), run.begin(), run.end()); });
+  ASSERT_EQ(seen.size(), 995);
+  for (std::size_t i = 0; i < seen.size(); ++i)
+    ASSERT_EQ(seen[i], static_cast<int>(i + 5));
+
+  const std::vector<int> flat{1, 2, 3, 4};
+  util::SegmentedSpan<const int> span(flat);
+  int sum = 0;
+  span.ForEachRun(1, 3, [&](std::span<const int> run, std::size_t)
+                  {
+                    for (int value : run)
+                      sum += value; });
+  EXPECT_EQ(sum, 5);
+  EXPECT_EQ(span[3], 4);
+}
+
+TEST(SegmentedVectorTest, ReadsWhileOneThreadAppends)
+{
+  util::SegmentedVector<std::size_t> values;
+  const std::size_t count = 200000;
+  std::atomic<bool> consistent{true};
+
+  std::thread reader([&]
+                     {
+                       std::size_t seen = 0;
+                       while (seen < count)
+                       {
+                         const auto view = values.View();
+                         for (std::size_t i = seen; i < view.size(); ++i)
+                           if (view[i] != i * 3)
+                             consistent = false;
+                         seen = view.size();
+                       } });
+  for (std::size_t i = 0; i < count; ++i)
+    values.push_back(i * 3);
+  reader.join();
+
+  EXPECT_TRUE(consistent);
+}
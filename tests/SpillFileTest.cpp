@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "src/application/util/spill_file.hpp"
+#include "tests/test_logs.hpp"
+
+TEST(SpillFileTest, KeepsReleasedRegions)
+{
+  util::SpillFile file;
+  std::vector<char *> regions;
+  for (int i = 0; i < 100; ++i)
+  {
+    const std::string text = "region " + std::to_string(i);
+    char *region = file.Allocate(64 << 10);
+    ASSERT_NE(region, nullptr);
+    std::memcpy(region, text.c_str(), text.size() + 1);
+    file.Release(region, 64 << 10);
+    regions.push_back(region);
+  }
+
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(std::string(regions[i]), "region " + std::to_string(i));
+  EXPECT_GE(file.Size(), 100 * (64 << 10));
+}
+
+TEST(SpillFileTest, HandsOutRegionsLargerThanAMapping)
+{
+  util::SpillFile file;
+  char *small = file.Allocate(10);
+  char *large = file.Allocate(util::SpillFile::kMappingSize + 1);
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+  small[0] = 's';
+  large[0] = 'f';
+  large[util::SpillFile::kMappingSize] = 'l';
+  file.Release(large, util::SpillFile::kMappingSize + 1);
+
+  EXPECT_EQ(small[0], 's');
+  EXPECT_EQ(large[0], 'f');
+  EXPECT_EQ(large[util::SpillFile::kMappingSize], 'l');
+}
+
+TEST(SpillFileTest, ClearEmptiesTheFile)
+{
+  util::SpillFile file;
+  ASSERT_NE(file.Allocate(1000), nullptr);
+  EXPECT_GT(file.Size(), 0);
+  file.Clear();
+  EXPECT_EQ(file.Size(), 0);
+
+  char *region = file.Allocate(1000);
+  ASSERT_NE(region, nullptr);
+  region[999] = 'x';
+  EXPECT_EQ(region[999], 'x');
+}
+
+TEST(SpillFileTest, ThrowsForAMissingDirectory)
+{
+  EXPECT_THROW(util::SpillFile(tests::TempPath("missing")), std::runtime_error);
+}
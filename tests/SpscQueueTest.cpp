@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "src/application/util/spsc_queue.hpp"
+
+TEST(SpscQueueTest, PushPopInOrder)
+{
+  util::SpscQueue<int> queue(4);
+  EXPECT_TRUE(queue.Empty());
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(queue.TryPush(int(i)));
+
+  int value = -1;
+  for (int i = 0; i < 4; ++i)
+  {
+    ASSERT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(SpscQueueTest, RejectsPushWhenFull)
+{
+  util::SpscQueue<std::string> queue(2);
+  EXPECT_TRUE(queue.TryPush("a"));
+  EXPECT_TRUE(queue.TryPush("b"));
+
+  std::string value = "kept";
+  EXPECT_FALSE(queue.TryPush(std::move(value)));
+  EXPECT_EQ(value, "kept");
+}
+
+TEST(SpscQueueTest, TransfersAcrossThreads)
+{
+  util::SpscQueue<int> queue(16);
+  const int count = 100000;
+
+  std::thread producer([&queue]
+                       {
+    for (int i = 0; i < count; ++i)
+      while (!queue.TryPush(int(i)))
+        std::this_thread::yield(); });
+
+  long long sum = 0;
+  int received = 0;
+  int expected = 0;
+  bool ordered = true;
+  while (received < count)
+  {
+    int value;
+    if (!queue.TryPop(value))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    ordered = ordered && value == expected++;
+    sum += value;
+    ++received;
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(sum, static_cast<long long>(count) * (count - 1) / 2);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/application/db/string_arena.hpp"
+
+TEST(StringArenaTest, StoresAndReturnsStrings)
+{
+  db::StringArena arena;
+  auto a = arena.Store("alpha");
+  auto b = arena.Store("");
+  auto c = arena.Store("gamma");
+
+  EXPECT_EQ(arena.Get(a), "alpha");
+  EXPECT_EQ(arena.Get(b), "");
+  EXPECT_EQ(arena.Get(c), "gamma");
+  EXPECT_EQ(arena.Get(db::StringRef{}), "");
+  EXPECT_TRUE(db::StringRef{}.IsNull());
+  EXPECT_FALSE(a.IsNull());
+}
+
+TEST(StringArenaTest, KeepsStringsInPlaceWhenGrowing)
+{
+  db::StringArena arena;
+  auto first = arena.Store("first");
+  auto view = arena.Get(first);
+
+  for (int i = 0; i < 200000; ++i)
+    arena.Store("value " + std::to_string(i));
+
+  EXPECT_EQ(arena.Get(first).data(), view.data());
+  EXPECT_EQ(arena.Get(first), "first");
+}
+
+TEST(StringArenaTest, StoresLargeStrings)
+{
+  db::StringArena arena;
+  std::string medium(300, 'm');
+  std::string large(3 * db::StringArena::kChunkSize, 'l');
+
+  auto small = arena.Store("small");
+  auto m = arena.Store(medium);
+  auto l = arena.Store(large);
+  auto after = arena.Store("after");
+
+  EXPECT_EQ(arena.Get(small), "small");
+  EXPECT_EQ(arena.Get(m), medium);
+  EXPECT_EQ(arena.Get(l), large);
+  EXPECT_EQ(arena.Get(after), "after");
+  // small strings keep filling the shared chunk around large ones
+  EXPECT_EQ(after.chunk, small.chunk);
+}
+
+TEST(StringArenaTest, ClearReleasesMemory)
+{
+  db::StringArena arena;
+  arena.Store("value");
+  EXPECT_GT(arena.MemoryUsage(), 0);
+  arena.Clear();
+  EXPECT_EQ(arena.MemoryUsage(), 0);
+}
+
+TEST(StringArenaTest, SmallArenaStaysSmall)
+{
+  db::StringArena arena;
+  arena.Store("value");
+  EXPECT_LE(arena.MemoryUsage(), db::StringArena::kFirstChunkSize + 1024);
+
+  // chunks double up to the full size
+  for (int i = 0; i < 100000; ++i)
+    arena.Store("value " + std::to_string(i));
+  EXPECT_LT(arena.ChunkCount(), 10);
+}
+
+TEST(StringArenaTest, SpilledStringsStayReadableInPlace)
+{
+  db::StringArena arena;
+  auto before = arena.Store("before");
+  arena.SetSpillFile(std::make_unique<util::SpillFile>());
+  EXPECT_TRUE(arena.IsSpilling());
+  const auto resident = arena.MemoryUsage();
+
+  std::vector<db::StringRef> refs;
+  for (int i = 0; i < 200000; ++i)
+    refs.push_back(arena.Store("spilled value " + std::to_string(i)));
+  std::string large(3 * db::StringArena::kChunkSize, 'l');
+  auto l = arena.Store(large);
+  auto shared = arena.StoreResident("shared");
+  const auto view = arena.Get(refs.front());
+
+  for (int i = 0; i < 200000; ++i)
+    ASSERT_EQ(arena.Get(refs[i]), "spilled value " + std::to_string(i));
+  EXPECT_EQ(arena.Get(l), large);
+  EXPECT_EQ(arena.Get(before), "before");
+  EXPECT_EQ(arena.Get(shared), "shared");
+  EXPECT_EQ(arena.Get(refs.front()).data(), view.data());
+
+  // the values are in the file, only the chunk being filled and the resident one are in memory
+  EXPECT_GT(arena.SpilledSize(), large.size());
+  EXPECT_LE(arena.MemoryUsage(), resident + 2 * db::StringArena::kChunkSize + 64 * 1024);
+  EXPECT_THROW(arena.SetSpillFile(std::make_unique<util::SpillFile>()), std::logic_error);
+
+  arena.Clear();
+  EXPECT_FALSE(arena.IsSpilling());
+  EXPECT_EQ(arena.SpilledSize(), 0);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "src/application/parser/parser_worker.hpp"
+#include "src/application/parser/tail_xml_parser.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  void append(const std::filesystem::path &path, const std::string &text)
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out << text;
+  }
+
+  std::string event(int i)
+  {
+    return "<event><info>" + std::to_string(i) + "</info></event>\n";
+  }
+
+  // pops batches until `count` events arrived or a few seconds passed
+  void receive(parser::ParserWorker &worker, std::vector<db::Event> &events, std::size_t count)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    parser::ParserWorker::Batch batch;
+    while (events.size() < count && std::chrono::steady_clock::now() < deadline)
+    {
+      if (worker.TryPopBatch(batch))
+        std::ranges::move(batch, std::back_inserter(events));
+      else
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+
+TEST(TailXmlParserTest, ParsesAppendedEvents)
+{
+  auto path = tests::TempPath("log.xml");
+  std::filesystem::remove(path);
+  append(path, "<events>\n" + event(0) + event(1));
+
+  std::atomic<bool> stop{false};
+  parser::ParserWorker worker(std::make_unique<parser::TailXmlParser>("event", std::chrono::milliseconds(20)), stop);
+  worker.Start(path);
+
+  // the worker does not wait for a full batch while the file is idle
+  std::vector<db::Event> events;
+  receive(worker, events, 2);
+  ASSERT_EQ(events.size(), 2);
+
+  // half an event stays pending until the rest is written
+  append(path, event(2) + "<event><info>3</in");
+  receive(worker, events, 3);
+  ASSERT_EQ(events.size(), 3);
+  append(path, "fo></event>\n");
+  receive(worker, events, 4);
+  ASSERT_EQ(events.size(), 4);
+
+  stop = true;
+  worker.Join();
+  EXPECT_TRUE(worker.IsFinished());
+  EXPECT_TRUE(worker.GetError().empty());
+  for (int i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(events[i].getId(), i);
+    EXPECT_EQ(events[i].findByKey("info"), std::to_string(i));
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(TailXmlParserTest, FollowsRotatedFileFromItsStart)
+{
+  auto path = tests::TempPath("log.xml");
+  std::filesystem::remove(path);
+  append(path, event(0) + event(1) + event(2));
+
+  std::atomic<bool> stop{false};
+  parser::ParserWorker worker(std::make_unique<parser::TailXmlParser>("event", std::chrono::milliseconds(20)), stop);
+  worker.Start(path);
+  std::vector<db::Event> events;
+  receive(worker, events, 3);
+  ASSERT_EQ(events.size(), 3);
+
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << event(10);
+  receive(worker, events, 4);
+  stop = true;
+  worker.Join();
+
+  ASSERT_EQ(events.size(), 4);
+  EXPECT_EQ(events[3].findByKey("info"), "10");
+  std::filesystem::remove(path);
+}
+
+TEST(TailXmlParserTest, FollowsFileRotatedByRenaming)
+{
+  auto path = tests::TempPath("log.xml");
+  auto rotated = tests::TempPath("log.xml.1");
+  std::filesystem::remove(path);
+  std::filesystem::remove(rotated);
+  append(path, event(0) + event(1) + event(2));
+
+  std::atomic<bool> stop{false};
+  parser::ParserWorker worker(std::make_unique<parser::TailXmlParser>("event", std::chrono::milliseconds(20)), stop);
+  worker.Start(path);
+  std::vector<db::Event> events;
+  receive(worker, events, 3);
+  ASSERT_EQ(events.size(), 3);
+
+  // the last event of the old file may not have been read when it is renamed
+  append(path, event(3));
+  std::filesystem::rename(path, rotated);
+  append(path, event(10) + event(11));
+  receive(worker, events, 6);
+  append(path, event(12));
+  receive(worker, events, 7);
+  stop = true;
+  worker.Join();
+
+  ASSERT_EQ(events.size(), 7);
+  EXPECT_EQ(events[3].findByKey("info"), "3");
+  EXPECT_EQ(events[4].findByKey("info"), "10");
+  EXPECT_EQ(events[6].findByKey("info"), "12");
+  std::filesystem::remove(path);
+  std::filesystem::remove(rotated);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+
+#include "src/application/util/thread_pool.hpp"
+
+TEST(ThreadPoolTest, RunsSubmittedTasks)
+{
+  util::ThreadPool pool(4);
+  EXPECT_EQ(pool.Size(), 4);
+
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; ++i)
+    results.push_back(pool.Submit([i]
+                                  { return i * i; }));
+
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(results[i].get(), i * i);
+}
+
+TEST(ThreadPoolTest, TasksCanSubmitTasks)
+{
+  util::ThreadPool pool(2);
+  std::atomic<int> counter{0};
+
+  auto outer = pool.Submit([&pool, &counter]
+                           {
+    std::vector<std::future<void>> inner;
+    for (int i = 0; i < 10; ++i)
+      inner.push_back(pool.Submit([&counter] { ++counter; }));
+    return inner; });
+
+  for (auto &future : outer.get())
+    future.get();
+  EXPECT_EQ(counter, 10);
+}
+
+TEST(ThreadPoolTest, PropagatesExceptions)
+{
+  util::ThreadPool pool(1);
+  auto result = pool.Submit([]() -> int
+                            { throw std::runtime_error("failed"); });
+  EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, FinishesQueuedTasksOnDestruction)
+{
+  std::atomic<int> counter{0};
+  {
+    util::ThreadPool pool(2);
+    for (int i = 0; i < 1000; ++i)
+      pool.Submit([&counter]
+                  { ++counter; });
+  }
+  EXPECT_EQ(counter, 1000);
+}
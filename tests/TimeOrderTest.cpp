@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/application/search/time_order.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  // seconds of the events, shuffled with many ties
+  std::vector<int> shuffledSeconds(int count)
+  {
+    std::vector<int> seconds(count);
+    std::mt19937 random(7);
+    for (auto &second : seconds)
+      second = static_cast<int>(random() % 50000);
+    return seconds;
+  }
+
+  void expectOrdered(const db::EventStore &store, const search::TimeOrder &order)
+  {
+    for (std::size_t position = 1; position < order.Size(); ++position)
+    {
+      const auto previous = order.Row(position - 1);
+      const auto row = order.Row(position);
+      ASSERT_LE(store.GetTime(previous), store.GetTime(row));
+      if (store.GetTime(previous) == store.GetTime(row))
+      {
+        ASSERT_LT(previous, row);
+      }
+    }
+  }
+} // namespace
+
+TEST(TimeOrderTest, SortsByTimeInParallel)
+{
+  db::EventStore store;
+  const auto seconds = shuffledSeconds(200000);
+  for (std::size_t i = 0; i < seconds.size(); ++i)
+    store.push_back(db::Event(static_cast<int>(i), {{"timestamp", tests::Timestamp(seconds[i])}}));
+
+  util::ThreadPool pool(4);
+  search::TimeOrder order(store, pool);
+  order.Assign();
+  ASSERT_EQ(order.Size(), store.size());
+  expectOrdered(store, order);
+
+  for (std::size_t row : {std::size_t(0), std::size_t(777), store.size() - 1})
+  {
+    auto position = order.Position(row);
+    ASSERT_TRUE(position);
+    EXPECT_EQ(order.Row(*position), row);
+  }
+}
+
+TEST(TimeOrderTest, UntimedEventsGoFirst)
+{
+  db::EventStore store;
+  store.push_back(db::Event(0, {{"timestamp", tests::Timestamp(5)}}));
+  store.push_back(db::Event(1, {{"type", "INFO"}}));
+  store.push_back(db::Event(2, {{"timestamp", tests::Timestamp(1)}}));
+
+  search::TimeOrder order(store);
+  order.Assign();
+  EXPECT_EQ(order.GetRows(), std::vector<uint32_t>({1, 2, 0}));
+}
+
+TEST(TimeOrderTest, OrdersASubsetOfRows)
+{
+  db::EventStore store;
+  for (int i = 0; i < 10; ++i)
+    store.push_back(db::Event(i, {{"timestamp", tests::Timestamp(100 - i)}}));
+
+  search::TimeOrder order(store);
+  const std::vector<uint32_t> even{0, 2, 4, 6, 8};
+  order.Assign(even);
+  EXPECT_EQ(order.GetRows(), std::vector<uint32_t>({8, 6, 4, 2, 0}));
+  EXPECT_FALSE(order.Position(3));
+}
+
+TEST(TimeOrderTest, MergesAppendedRows)
+{
+  db::EventStore store;
+  for (int i = 0; i < 4; ++i)
+    store.push_back(db::Event(i, {{"timestamp", tests::Timestamp(i * 10)}}));
+  search::TimeOrder order(store);
+  order.Assign();
+
+  // later events go after the others
+  store.push_back(db::Event(4, {{"timestamp", tests::Timestamp(50)}}));
+  EXPECT_TRUE(order.Add(4));
+  // an event from the past is merged in
+  store.push_back(db::Event(5, {{"timestamp", tests::Timestamp(15)}}));
+  store.push_back(db::Event(6, {{"timestamp", tests::Timestamp(35)}}));
+  EXPECT_FALSE(order.Add(5));
+
+  EXPECT_EQ(order.GetRows(), std::vector<uint32_t>({0, 1, 5, 2, 3, 6, 4}));
+  expectOrdered(store, order);
+}
+
+TEST(TimeOrderTest, FindsFirstEventAtOrAfterATime)
+{
+  db::EventStore store;
+  for (int i = 0; i < 100; ++i)
+    store.push_back(db::Event(i, {{"timestamp", tests::Timestamp(99 - i)}}));
+  search::TimeOrder order(store);
+  order.Assign();
+
+  EXPECT_EQ(order.LowerBound(*db::ParseTimestamp(tests::Timestamp(42))), 42);
+  EXPECT_EQ(order.Row(42), 57);
+  EXPECT_EQ(order.LowerBound(*db::ParseTimestamp("2023-12-31")), 0);
+  EXPECT_EQ(order.LowerBound(*db::ParseTimestamp("2024-01-02")), 100);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "src/application/db/timestamp.hpp"
+
+namespace db
+{
+  TEST(TimestampTest, ParsesIsoTimes)
+  {
+    EXPECT_EQ(ParseTimestamp("1970-01-01"), 0);
+    EXPECT_EQ(ParseTimestamp("1970-01-02 00:00:00"), 86400LL * 1000000);
+    EXPECT_EQ(ParseTimestamp("2024-03-01T12:34:56"), 1709296496LL * 1000000);
+    EXPECT_EQ(ParseTimestamp("2024-03-01 12:34"), 1709296440LL * 1000000);
+    EXPECT_EQ(ParseTimestamp("1969-12-31 23:59:59"), -1000000);
+  }
+
+  TEST(TimestampTest, KeepsMicroseconds)
+  {
+    EXPECT_EQ(ParseTimestamp("1970-01-01 00:00:01.5"), 1500000);
+    EXPECT_EQ(ParseTimestamp("1970-01-01 00:00:01,000250"), 1000250);
+    // nanoseconds are dropped
+    EXPECT_EQ(ParseTimestamp("1970-01-01 00:00:00.123456789"), 123456);
+  }
+
+  TEST(TimestampTest, HonoursZoneOffsets)
+  {
+    const auto utc = *ParseTimestamp("2024-01-01 08:00:00");
+    EXPECT_EQ(ParseTimestamp("2024-01-01T08:00:00Z"), utc);
+    EXPECT_EQ(ParseTimestamp("2024-01-01T10:00:00+02:00"), utc);
+    EXPECT_EQ(ParseTimestamp("2024-01-01T10:30:00+0230"), utc);
+    EXPECT_EQ(ParseTimestamp("2024-01-01T03:00:00-05"), utc);
+  }
+
+  TEST(TimestampTest, RejectsOtherText)
+  {
+    EXPECT_FALSE(ParseTimestamp(""));
+    EXPECT_FALSE(ParseTimestamp("dummyTimestamp"));
+    EXPECT_FALSE(ParseTimestamp("2024-13-01"));
+    EXPECT_FALSE(ParseTimestamp("2024-01-01 25:00:00"));
+    EXPECT_FALSE(ParseTimestamp("2024-01-01 10:00:00 trailing"));
+    EXPECT_FALSE(ParseTimestamp("2024-01-01 10:00:00."));
+    EXPECT_FALSE(ParseTimestamp("24-01-01"));
+  }
+
+  TEST(TimestampTest, FormatsWhatItParses)
+  {
+    EXPECT_EQ(FormatTimestamp(*ParseTimestamp("2024-02-29 23:59:58.000042")), "2024-02-29 23:59:58.000042");
+    EXPECT_EQ(FormatTimestamp(-1), "1969-12-31 23:59:59.999999");
+  }
+} // namespace db
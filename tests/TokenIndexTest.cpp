@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/application/search/token_index.hpp"
+
+using Rows = std::vector<std::size_t>;
+
+class TokenIndexTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    index.Add(db::Event(1, {{"type", "ERROR"}, {"info", "Disk full on /dev/sda1"}}));
+    index.Add(db::Event(2, {{"type", "info"}, {"info", "disk check passed"}}));
+    index.Add(db::Event(3, {{"type", "error"}, {"info", "network down"}}));
+  }
+
+  search::TokenIndex index;
+};
+
+TEST_F(TokenIndexTest, FindsWordsCaseInsensitively)
+{
+  EXPECT_EQ(index.Find("disk"), Rows({0, 1}));
+  EXPECT_EQ(index.Find("DISK"), Rows({0, 1}));
+  EXPECT_EQ(index.Find("sda1"), Rows({0}));
+  EXPECT_EQ(index.Find("dis"), Rows());
+}
+
+TEST_F(TokenIndexTest, FindsFieldValuePairs)
+{
+  EXPECT_EQ(index.Find("type=ERROR"), Rows({0, 2}));
+  EXPECT_EQ(index.Find("type=warning"), Rows());
+  EXPECT_EQ(index.Find("level=error"), Rows());
+}
+
+TEST_F(TokenIndexTest, IntersectsTerms)
+{
+  EXPECT_EQ(index.Find("type=error disk"), Rows({0}));
+  EXPECT_EQ(index.Find("disk  passed"), Rows({1}));
+  EXPECT_EQ(index.Find("/dev/sda1"), Rows({0}));
+  EXPECT_EQ(index.Find("network disk"), Rows());
+}
+
+TEST_F(TokenIndexTest, NoAnswerWithoutTerms)
+{
+  EXPECT_FALSE(index.Find("").has_value());
+  EXPECT_FALSE(index.Find(" -- ").has_value());
+}
+
+TEST_F(TokenIndexTest, HighCardinalityFieldsHaveNoPairs)
+{
+  search::TokenIndex large;
+  for (int i = 0; i < 5000; ++i)
+    large.Add(db::Event(i, {{"timestamp", "t" + std::to_string(i)}, {"type", i % 2 ? "odd" : "even"}}));
+
+  EXPECT_FALSE(large.Find("timestamp=t42").has_value());
+  EXPECT_EQ(large.Find("t42"), Rows({42}));
+  EXPECT_EQ(large.Find("type=odd")->size(), 2500);
+  EXPECT_EQ(large.Size(), 5000);
+}
+
+TEST_F(TokenIndexTest, LongValuedFieldsHaveNoPairs)
+{
+  index.Add(db::Event(4, {{"payload", std::string(100, 'a')}}));
+
+  EXPECT_FALSE(index.Find("payload=a").has_value());
+  EXPECT_EQ(index.Find("level=error"), Rows());
+}
+
+TEST_F(TokenIndexTest, PostingsAreCompressed)
+{
+  search::TokenIndex large;
+  for (int i = 0; i < 100000; ++i)
+    large.Add(db::Event(i, {{"type", "info"}, {"info", "request " + std::to_string(i % 10) + " done"}}));
+
+  auto rows = large.Find("request");
+  ASSERT_TRUE(rows.has_value());
+  ASSERT_EQ(rows->size(), 100000);
+  EXPECT_EQ(rows->back(), 99999);
+  EXPECT_EQ(large.Find("type=info request 7")->size(), 10000);
+  // 800000 postings, a quarter of what plain row numbers would take
+  EXPECT_LT(large.MemoryUsage(), 800000 * sizeof(std::size_t) / 4);
+  EXPECT_GT(large.GetBuildTime().count(), 0);
+}
+
+TEST_F(TokenIndexTest, ClearEmptiesIndex)
+{
+  index.Clear();
+
+  EXPECT_EQ(index.Size(), 0);
+  EXPECT_EQ(index.Find("disk"), Rows());
+}
+
+TEST_F(TokenIndexTest, AddsBatches)
+{
+  std::vector<db::Event> batch;
+  batch.emplace_back(4, db::Event::EventItems{{"type", "warn"}});
+  batch.emplace_back(5, db::Event::EventItems{{"type", "disk"}});
+  index.Add(batch);
+
+  EXPECT_EQ(index.Size(), 5);
+  EXPECT_EQ(index.Find("warn"), Rows({3}));
+  EXPECT_EQ(index.Find("disk"), Rows({0, 1, 4}));
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "src/application/parser/xml_event_index.hpp"
+#include "src/application/parser/xml_parser.hpp"
+#include "tests/test_logs.hpp"
+
+TEST(XmlEventIndexTest, LoadsWhatTheParserParses)
+{
+  auto path = tests::WriteLog("log.xml", tests::TrickyLog(2000));
+  parser::XmlParser sequential;
+  tests::CollectingObserver observer;
+  sequential.RegisterObserver(&observer);
+  sequential.ParseData(path);
+
+  for (std::size_t chunkSize : {64, 1000, 16 << 20})
+  {
+    util::ThreadPool pool(4);
+    parser::XmlEventIndex index(path, "event", chunkSize, pool);
+
+    ASSERT_EQ(index.Size(), observer.events.size()) << "chunk size " << chunkSize;
+    for (std::size_t i = 0; i < index.Size(); ++i)
+    {
+      auto event = index.Load(i);
+      ASSERT_EQ(event.getId(), static_cast<int>(i));
+      ASSERT_EQ(event.getEventItems(), observer.events[i].getEventItems()) << "event " << i;
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(XmlEventIndexTest, LoadsInAnyOrder)
+{
+  auto path = tests::WriteLog("log.xml",
+                       "<events><event><info>a</info></event><event><info>b</info></event></events>");
+  parser::XmlEventIndex index(path);
+
+  ASSERT_EQ(index.Size(), 2);
+  EXPECT_EQ(index.Load(1).findByKey("info"), "b");
+  EXPECT_EQ(index.Load(0).findByKey("info"), "a");
+  EXPECT_THROW(index.Load(2), std::out_of_range);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <sstream>
+
+#include "src/application/parser/xml_parser.hpp"
+#include "tests/test_logs.hpp"
+
+namespace
+{
+  std::string makeLog(int count)
+  {
+    std::string log = "<?xml version=\"1.0\"?>\n<events>\n";
+    for (int i = 0; i < count; ++i)
+    {
+      log += "  <event><timestamp>2024-01-01 00:00:" + std::to_string(i % 60) +
+             "</timestamp><type>INFO</type><info>message " + std::to_string(i) + "</info></event>\n";
+    }
+    log += "</events>\n";
+    return log;
+  }
+}
+
+class XmlParserTest : public ::testing::Test
+{
+protected:
+  parser::XmlParser xmlParser;
+  tests::CollectingObserver observer;
+
+  void SetUp() override
+  {
+    xmlParser.RegisterObserver(&observer);
+  }
+
+  void parse(const std::string &text)
+  {
+    std::istringstream input(text);
+    xmlParser.ParseData(input);
+  }
+};
+
+TEST_F(XmlParserTest, ParsesChildElementsAsFields)
+{
+  parse("<events><event><timestamp>t1</timestamp><type>ERROR</type><info>boom</info></event></events>");
+
+  ASSERT_EQ(observer.events.size(), 1);
+  const auto &items = observer.events[0].getEventItems();
+  ASSERT_EQ(items.size(), 3);
+  EXPECT_EQ(items[0], db::Event::Item("timestamp", "t1"));
+  EXPECT_EQ(items[1], db::Event::Item("type", "ERROR"));
+  EXPECT_EQ(items[2], db::Event::Item("info", "boom"));
+}
+
+TEST_F(XmlParserTest, ParsesAttributesAndSelfClosingEvents)
+{
+  parse("<events><event type=\"WARN\" info='a &gt; b'/><event level=\"1\"><dummy/></event></events>");
+
+  ASSERT_EQ(observer.events.size(), 2);
+  EXPECT_EQ(observer.events[0].findByKey("type"), "WARN");
+  EXPECT_EQ(observer.events[0].findByKey("info"), "a > b");
+  EXPECT_EQ(observer.events[1].findByKey("level"), "1");
+  EXPECT_EQ(observer.events[1].findByKey("dummy"), "");
+}
+
+TEST_F(XmlParserTest, DecodesEntitiesAndCdata)
+{
+  parse("<event><info>&lt;tag&gt; &amp; &#65;&#x42; &#xe9;</info><data><![CDATA[<raw> & text]]></data></event>");
+
+  ASSERT_EQ(observer.events.size(), 1);
+  EXPECT_EQ(observer.events[0].findByKey("info"), "<tag> & AB \xC3\xA9");
+  EXPECT_EQ(observer.events[0].findByKey("data"), "<raw> & text");
+}
+
+TEST_F(XmlParserTest, SkipsCommentsAndOtherElements)
+{
+  parse("<events><!-- <event><info>hidden</info></event> --><header><eventual>x</eventual></header>"
+        "<event><info>visible</info></event></events>");
+
+  ASSERT_EQ(observer.events.size(), 1);
+  EXPECT_EQ(observer.events[0].findByKey("info"), "visible");
+}
+
+TEST_F(XmlParserTest, AssignsSequentialIds)
+{
+  parse(makeLog(5));
+
+  ASSERT_EQ(observer.events.size(), 5);
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(observer.events[i].getId(), i);
+    EXPECT_EQ(observer.events[i].findByKey("info"), "message " + std::to_string(i));
+  }
+}
+
+TEST_F(XmlParserTest, HandlesEventsSplitAcrossReadChunks)
+{
+  // several MiB so that events straddle the internal read buffer boundaries
+  const int count = 60000;
+  auto log = makeLog(count);
+  parse(log);
+
+  ASSERT_EQ(observer.events.size(), count);
+  EXPECT_EQ(observer.events.back().findByKey("info"), "message " + std::to_string(count - 1));
+  EXPECT_EQ(xmlParser.GetTotalProgress(), log.size());
+  EXPECT_EQ(xmlParser.GetCurrentProgress(), log.size());
+  EXPECT_GT(observer.progressUpdates, 1);
+}
+
+TEST_F(XmlParserTest, ParsesMappedFile)
+{
+  auto log = makeLog(1000);
+  auto path = tests::WriteLog("log.xml", log);
+
+  xmlParser.ParseData(path);
+  std::filesystem::remove(path);
+
+  ASSERT_EQ(observer.events.size(), 1000);
+  EXPECT_EQ(observer.events[999].findByKey("info"), "message 999");
+  EXPECT_EQ(xmlParser.GetTotalProgress(), log.size());
+  EXPECT_EQ(xmlParser.GetCurrentProgress(), log.size());
+}
+
+TEST_F(XmlParserTest, MissingFileThrows)
+{
+  EXPECT_THROW(xmlParser.ParseData(std::filesystem::path("/nonexistent/LogViewer.xml")), std::runtime_error);
+}
+
+TEST(XmlEventScannerTest, ReportsResumePositionForIncompleteEvent)
+{
+  parser::XmlEventScanner scanner;
+  std::string_view data = "<events><event><info>a</info></event><event><info>b</in";
+
+  std::size_t pos = 0;
+  auto span = scanner.FindNextEvent(data, pos);
+  ASSERT_TRUE(span.has_value());
+  EXPECT_EQ(data.substr(span->begin, span->end - span->begin), "<event><info>a</info></event>");
+
+  EXPECT_FALSE(scanner.FindNextEvent(data, pos).has_value());
+  EXPECT_EQ(data.substr(pos), "<event><info>b</in");
+}
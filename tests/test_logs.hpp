@@ -0,0 +1,110 @@
+#ifndef TESTS_TESTLOGS_HPP
+#define TESTS_TESTLOGS_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "src/application/db/event.hpp"
+#include "src/application/parser/data_parser.hpp"
+
+// Logs and observers shared by the parser, cache and worker tests.
+namespace tests
+{
+	// keeps every event a parser finds
+	class CollectingObserver : public parser::DataParserObserver
+	{
+	public:
+		void ProgressUpdated() const override
+		{
+			++progressUpdates;
+		}
+
+		void NewEventFound(db::Event &&event) override
+		{
+			events.push_back(std::move(event));
+		}
+
+		std::vector<db::Event> events;
+		mutable int progressUpdates{0};
+	};
+
+	// path `name` of the temp directory, made unique to the running test and
+	// process so tests run side by side never share a file
+	inline std::filesystem::path TempPath(const std::string &name)
+	{
+#ifdef _WIN32
+		const auto pid = _getpid();
+#else
+		const auto pid = ::getpid();
+#endif
+		std::string unique = "LogViewer_";
+		if (const auto *test = ::testing::UnitTest::GetInstance()->current_test_info())
+			unique += std::string(test->test_suite_name()) + "." + test->name() + "_";
+		unique += std::to_string(pid) + "_" + name;
+		return std::filesystem::temp_directory_path() / unique;
+	}
+
+	// file TempPath(name) with the content
+	inline std::filesystem::path WriteLog(const std::string &name, const std::string &content)
+	{
+		auto path = TempPath(name);
+		std::ofstream out(path, std::ios::binary);
+		out << content;
+		return path;
+	}
+
+	// "2024-01-01 00:00:00" and the given seconds later, within 28 days
+	inline std::string Timestamp(int64_t second)
+	{
+		char text[48];
+		std::snprintf(text, sizeof(text), "2024-01-%02d %02d:%02d:%02d", static_cast<int>(second / 86400 % 28 + 1),
+		              static_cast<int>(second / 3600 % 24), static_cast<int>(second / 60 % 60), static_cast<int>(second % 60));
+		return text;
+	}
+
+	// <events> of count <event> elements holding event(first), event(first + 1) ...
+	inline std::string EventsLog(int first, int count, const std::function<std::string(int)> &event)
+	{
+		std::string log = "<events>\n";
+		for (int i = first; i < first + count; ++i)
+			log += "<event>" + event(i) + "</event>\n";
+		return log + "</events>\n";
+	}
+
+	// a log full of traps for chunk boundaries: commented out events, event
+	// tags inside CDATA and events much longer than one chunk
+	inline std::string TrickyLog(int count)
+	{
+		std::string log = "<?xml version=\"1.0\"?>\n<events>\n";
+		for (int i = 0; i < count; ++i)
+		{
+			if (i % 7 == 0)
+				log += "<!-- <event><info>commented " + std::to_string(i) + "</info></event> -->\n";
+			log += "<event id=\"" + std::to_string(i) + "\"><type>INFO</type>";
+			if (i % 5 == 0)
+				log += "<data><![CDATA[<event><info>fake</info></event>]]></data>";
+			if (i % 50 == 0)
+				log += "<info>" + std::string(2000, 'x') + "</info>";
+			else
+				log += "<info>message " + std::to_string(i) + "</info>";
+			log += "</event>\n";
+		}
+		log += "</events>\n";
+		return log;
+	}
+} // namespace tests
+
+#endif // TESTS_TESTLOGS_HPP